@@ -0,0 +1,92 @@
+#include "gameLogic.hpp"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+
+namespace {
+
+    const unsigned int ACTIONS_PER_PRODUCER = 200000;
+
+    std::unique_ptr<Game::Action> makeAction(Game::Map* map) {
+        return std::unique_ptr<Game::Action>(new Game::HitAction(1, map, std::unique_ptr<Game::Targeting>(new Game::NoTargeting()), &Game::PlayerTeam::PLAYER_TEAM));
+    }
+
+    double runQueue(unsigned int producerCount) {
+        Game::Map map;
+        Game::MPSCQueue<std::unique_ptr<Game::Action>> queue;
+        std::atomic<unsigned int> producersDone(0);
+        std::vector<std::thread> producers;
+        unsigned long long consumed = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < producerCount; i++) {
+            producers.push_back(std::thread([&]() {
+                for (unsigned int j = 0; j < ACTIONS_PER_PRODUCER; j++) {
+                    queue.push(makeAction(&map));
+                }
+                producersDone.fetch_add(1);
+            }));
+        }
+        while (producersDone.load() < producerCount) {
+            consumed += queue.drain([](std::unique_ptr<Game::Action> action) {});
+        }
+        consumed += queue.drain([](std::unique_ptr<Game::Action> action) {});
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        if (consumed != static_cast<unsigned long long>(producerCount) * ACTIONS_PER_PRODUCER) {
+            std::cout << "Lost actions: consumed " << consumed << "\n";
+        }
+        return elapsed.count();
+    }
+
+    double runLockedVector(unsigned int producerCount) {
+        Game::Map map;
+        std::mutex queueMutex;
+        std::vector<std::unique_ptr<Game::Action>> queue;
+        std::atomic<unsigned int> producersDone(0);
+        std::vector<std::thread> producers;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < producerCount; i++) {
+            producers.push_back(std::thread([&]() {
+                for (unsigned int j = 0; j < ACTIONS_PER_PRODUCER; j++) {
+                    std::unique_ptr<Game::Action> action = makeAction(&map);
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    queue.push_back(std::move(action));
+                }
+                producersDone.fetch_add(1);
+            }));
+        }
+        while (true) {
+            bool done = producersDone.load() == producerCount;
+            std::vector<std::unique_ptr<Game::Action>> draining;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                draining.swap(queue);
+            }
+            if (done) {
+                break;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        return elapsed.count();
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::cout << "producers\tmpsc Mops/s\tmutex Mops/s\n";
+    for (unsigned int producerCount = 1; producerCount <= 16; producerCount *= 2) {
+        double total = static_cast<double>(producerCount) * ACTIONS_PER_PRODUCER / 1000000.0;
+        double queueTime = runQueue(producerCount);
+        double lockedTime = runLockedVector(producerCount);
+        std::cout << producerCount << "\t\t" << total / queueTime << "\t\t" << total / lockedTime << "\n";
+    }
+    return 0;
+}
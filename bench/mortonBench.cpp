@@ -0,0 +1,74 @@
+#include "gameLogic.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+
+namespace {
+
+    const unsigned int CLUSTERS = 64;
+    const unsigned int ENTITIES_PER_CLUSTER = 800;
+    const unsigned int SWEEPS = 5;
+
+    void populateClusteredCrowd(Game::Map& map, std::mt19937& random) {
+        std::vector<Game::Vector> centers;
+        std::uniform_int_distribution<int> centerDistribution(-90000, 90000);
+        for (unsigned int i = 0; i < CLUSTERS; i++) {
+            centers.push_back(Game::Vector(centerDistribution(random), centerDistribution(random)));
+        }
+        std::vector<Game::Vector> positions;
+        for (unsigned int i = 0; i < CLUSTERS * ENTITIES_PER_CLUSTER; i++) {
+            Game::Vector center = centers[i % CLUSTERS];
+            unsigned int slot = i / CLUSTERS;
+            positions.push_back(Game::Vector(center.x + static_cast<int>(slot % 30) * 40, center.y + static_cast<int>(slot / 30) * 40));
+        }
+        std::shuffle(positions.begin(), positions.end(), random);
+
+        Game::EntityStats stats;
+        for (Game::Vector position : positions) {
+            map.createEntity(Game::EntityTemplate(stats, Game::Rect(position, 30, 30), NULL, Game::Team::TEAM::ENEMY));
+        }
+    }
+
+    double runMovementSweeps(Game::Map& map, unsigned int& blocked) {
+        blocked = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int sweep = 0; sweep < SWEEPS; sweep++) {
+            for (const Game::Entity& entity : map.getEntities()) {
+                Game::Rect hitbox = entity.getHitbox();
+                Game::Rect moved = Game::Rect(Game::Vector(hitbox.topLeft.x + 5, hitbox.topLeft.y + 5), hitbox.width, hitbox.height);
+                if (!map.entityCanMoveToSpace(entity.getID(), moved)) {
+                    blocked++;
+                }
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::mt19937 random(1234);
+    Game::Map map;
+    map.setPlayableArea(Game::Rect(Game::Vector(-100000, -100000), 200000, 200000));
+    populateClusteredCrowd(map, random);
+
+    unsigned int blockedBefore = 0;
+    unsigned int blockedAfter = 0;
+    double before = runMovementSweeps(map, blockedBefore);
+
+    std::chrono::steady_clock::time_point reorderStart = std::chrono::steady_clock::now();
+    map.reorderEntitiesNow();
+    std::chrono::duration<double, std::milli> reorderTime = std::chrono::steady_clock::now() - reorderStart;
+
+    double after = runMovementSweeps(map, blockedAfter);
+
+    std::cout << map.getEntities().size() << " entities in " << CLUSTERS << " clusters, " << SWEEPS << " movement sweeps in storage order\n";
+    std::cout << "creation order: " << before << " ms\n";
+    std::cout << "morton order:   " << after << " ms\n";
+    std::cout << "full reorder:   " << reorderTime.count() << " ms\n";
+    if (blockedBefore != blockedAfter) {
+        std::cout << "Sweep results differ: " << blockedBefore << " vs " << blockedAfter << "\n";
+    }
+    return 0;
+}
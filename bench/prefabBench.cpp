@@ -0,0 +1,82 @@
+#include "gameLogic.hpp"
+#include "prefabs.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+    const unsigned int SPAWN_COUNT = 10000;
+    const unsigned int COLUMNS = 100;
+    const int SPACING = 60;
+    const unsigned int ROUNDS = 5;
+    const double FRAME_MILLISECONDS = 1000.0 / 60.0;
+    const unsigned int CONTACT_TICKS = 5;
+
+    const char* PREFAB_DATA =
+        "dummy ENEMY NONE dummy 40 40 MAX_HP=30 HP=30\n"
+        "grunt ENEMY GRUNT dummy 40 40 MAX_HP=30 HP=30 DMG=2 RNG=2 MOVE*4\n";
+
+    double spawnOneAtATime(const Game::Prefab& prefab) {
+        Game::Map map;
+        Game::EntityTemplate entityTemplate = prefab.entityTemplate;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < SPAWN_COUNT; i++) {
+            entityTemplate.hitbox.topLeft = Game::Vector(static_cast<int>(i % COLUMNS) * SPACING, static_cast<int>(i / COLUMNS) * SPACING);
+            map.createEntity(entityTemplate);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    double spawnInBulk(const Game::Prefab& prefab) {
+        Game::Map map;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        map.createEntities(prefab, SPAWN_COUNT, Game::SpawnPlacement::grid(Game::Vector(0, 0), COLUMNS, Game::Vector(SPACING, SPACING)));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    bool gruntHitsAdjacentPlayer(const Game::Prefab& prefab) {
+        Game::Map map;
+        Game::EntityStats playerStats;
+        playerStats.stats[Game::EntityStats::STAT::HP] = 100;
+        unsigned int playerID = map.createEntity(Game::EntityTemplate(playerStats, Game::Rect(Game::Vector(0, 0), 40, 40), NULL, Game::Team::TEAM::PLAYER));
+        map.createEntities(prefab, 1, Game::SpawnPlacement::grid(Game::Vector(41, 0), 1, Game::Vector(SPACING, SPACING)));
+        for (unsigned int i = 0; i < CONTACT_TICKS; i++) {
+            map.tickAndApplyActions();
+        }
+        Game::Entity* player = map.getEntityWithID(playerID);
+        return !player || player->getFinalStats().stats[Game::EntityStats::STAT::HP] < 100;
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    Game::PrefabLibrary prefabs;
+    if (!prefabs.load(PREFAB_DATA)) {
+        std::cout << "Could not parse prefabs: " << prefabs.getLastError() << "\n";
+        return 1;
+    }
+    const Game::Prefab* dummy = prefabs.find("dummy");
+    const Game::Prefab* grunt = prefabs.find("grunt");
+    if (!gruntHitsAdjacentPlayer(*grunt)) {
+        std::cout << "Grunt next to the player never landed a hit\n";
+        return 1;
+    }
+
+    double single = 1e9;
+    double bulk = 1e9;
+    double bulkWithBehaviour = 1e9;
+    for (unsigned int round = 0; round < ROUNDS; round++) {
+        single = std::min(single, spawnOneAtATime(*dummy));
+        bulk = std::min(bulk, spawnInBulk(*dummy));
+        bulkWithBehaviour = std::min(bulkWithBehaviour, spawnInBulk(*grunt));
+    }
+
+    std::cout << SPAWN_COUNT << " enemies per spawn, best of " << ROUNDS << " rounds\n";
+    std::cout << "createEntity loop:          " << single << " ms\n";
+    std::cout << "createEntities:             " << bulk << " ms\n";
+    std::cout << "createEntities (behaviour): " << bulkWithBehaviour << " ms (" << bulkWithBehaviour / FRAME_MILLISECONDS * 100 << "% of a 60 Hz frame)\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "gameLogic.hpp"
+#include "rollback.hpp"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+    const unsigned int COLUMNS = 200;
+    const unsigned int ROWS = 50;
+    const int SPACING = 60;
+    const unsigned int WARMUP_TICKS = 60;
+    const unsigned int ROLLBACK_TICKS = 8;
+    const unsigned int ROUNDS = 20;
+    const unsigned int GRUNT_INTERVAL = 4;
+
+    void populateMap(Game::Map& map) {
+        Game::EntityStats playerStats;
+        playerStats.stats[Game::EntityStats::STAT::HP] = 1000;
+        map.createEntity(Game::EntityTemplate(playerStats, Game::Rect(Game::Vector(COLUMNS * SPACING / 2 + 15, ROWS * SPACING / 2 + 15), 30, 30), NULL, Game::Team::TEAM::PLAYER));
+        Game::EntityStats stats;
+        stats.stats[Game::EntityStats::STAT::HP] = 20;
+        for (unsigned int row = 0; row < ROWS; row++) {
+            for (unsigned int column = 0; column < COLUMNS; column++) {
+                Game::Rect hitbox(Game::Vector(column * SPACING, row * SPACING), 30, 30);
+                if (map.spaceEmpty(hitbox)) {
+                    unsigned int entityID = map.createEntity(Game::EntityTemplate(stats, hitbox, NULL, Game::Team::TEAM::ENEMY));
+                    if ((row * COLUMNS + column) % GRUNT_INTERVAL == 0) {
+                        map.setBehaviourProfile(entityID, std::unique_ptr<Game::BehaviourProfile>(Game::BehaviourProfile::create(Game::BehaviourProfile::PROFILE::GRUNT, entityID, &map)));
+                    }
+                }
+            }
+        }
+    }
+
+    void applyInputs(Game::Map& map, unsigned int tick) {
+        Game::Rect area(Game::Vector(COLUMNS * SPACING / 2 - 300, ROWS * SPACING / 2 - 300), 600, 600);
+        std::vector<unsigned int> nearby = map.getEntitiesInArea(area);
+        std::sort(nearby.begin(), nearby.end());
+        for (unsigned int i = 0; i < 16 && !nearby.empty(); i++) {
+            uint32_t pick = (tick * 2654435761u + i * 40503u) >> 7;
+            int x = static_cast<int>(pick % 41) - 20;
+            int y = static_cast<int>((pick / 41) % 41) - 20;
+            map.addImpulse(nearby[pick % nearby.size()], Game::Vector(x, y));
+        }
+        if (tick % 5 == 0) {
+            std::unique_ptr<Game::Targeting> targeting(new Game::RectTargeting(area));
+            map.addActionToQueue(std::unique_ptr<Game::Action>(new Game::HitAction(3, &map, std::move(targeting), &Game::PlayerTeam::PLAYER_TEAM)));
+        }
+    }
+
+    void tick(Game::Map& map, Game::RollbackRing& ring, unsigned int& currentTick) {
+        applyInputs(map, currentTick);
+        map.tickAndApplyActions();
+        currentTick++;
+        ring.capture(map, currentTick);
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    Game::Map map;
+    map.setPlayableArea(Game::Rect(Game::Vector(-1000, -1000), COLUMNS * SPACING + 2000, ROWS * SPACING + 2000));
+    populateMap(map);
+    map.reorderEntitiesNow();
+    Game::RollbackRing ring;
+    unsigned int currentTick = 0;
+    ring.capture(map, currentTick);
+    for (unsigned int i = 0; i < WARMUP_TICKS; i++) {
+        tick(map, ring, currentTick);
+    }
+
+    double captureTime = 0;
+    double restoreTime = 0;
+    double resimulateTime = 0;
+    double deepCopyTime = 0;
+    unsigned int copiedPages = 0;
+    unsigned int restoredPages = 0;
+    unsigned int mismatches = 0;
+    for (unsigned int round = 0; round < ROUNDS; round++) {
+        applyInputs(map, currentTick);
+        map.tickAndApplyActions();
+        currentTick++;
+        std::chrono::steady_clock::time_point captureStart = std::chrono::steady_clock::now();
+        ring.capture(map, currentTick);
+        std::chrono::duration<double, std::milli> captureElapsed = std::chrono::steady_clock::now() - captureStart;
+        captureTime += captureElapsed.count();
+        copiedPages += ring.getLastCopiedPages();
+
+        std::chrono::steady_clock::time_point copyStart = std::chrono::steady_clock::now();
+        std::vector<Game::Entity> deepCopy = map.getEntities();
+        std::chrono::duration<double, std::milli> copyElapsed = std::chrono::steady_clock::now() - copyStart;
+        deepCopyTime += copyElapsed.count();
+
+        uint64_t expected = map.getStateHash();
+        unsigned int rewindTo = currentTick - ROLLBACK_TICKS;
+        std::chrono::steady_clock::time_point restoreStart = std::chrono::steady_clock::now();
+        ring.restore(map, rewindTo);
+        std::chrono::duration<double, std::milli> restoreElapsed = std::chrono::steady_clock::now() - restoreStart;
+        restoreTime += restoreElapsed.count();
+        restoredPages += ring.getLastRestoredPages();
+
+        currentTick = rewindTo;
+        std::chrono::steady_clock::time_point resimulateStart = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < ROLLBACK_TICKS; i++) {
+            tick(map, ring, currentTick);
+        }
+        std::chrono::duration<double, std::milli> resimulateElapsed = std::chrono::steady_clock::now() - resimulateStart;
+        resimulateTime += resimulateElapsed.count();
+        if (map.getStateHash() != expected) {
+            mismatches++;
+        }
+    }
+
+    unsigned int pageCount = (map.getEntities().size() + 63) / 64;
+    std::cout << map.getEntities().size() << " entities in " << pageCount << " pages, " << map.getAwakeEntityIDs().size() << " awake, " << ROUNDS << " rounds\n";
+    std::cout << "capture:          " << captureTime / ROUNDS << " ms (" << static_cast<double>(copiedPages) / ROUNDS << " pages copied)\n";
+    std::cout << "deep copy:        " << deepCopyTime / ROUNDS << " ms\n";
+    std::cout << "restore " << ROLLBACK_TICKS << " ticks: " << restoreTime / ROUNDS << " ms (" << static_cast<double>(restoredPages) / ROUNDS << " pages restored)\n";
+    std::cout << "resimulate " << ROLLBACK_TICKS << ":     " << resimulateTime / ROUNDS << " ms\n";
+    if (mismatches > 0) {
+        std::cout << mismatches << " rollbacks diverged from the original timeline\n";
+    }
+    return 0;
+}
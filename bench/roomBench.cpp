@@ -0,0 +1,130 @@
+#include "roomHost.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <atomic>
+
+namespace {
+
+    const unsigned int TICK_RATE = 60;
+    const unsigned int PLAYERS_PER_ROOM = 4;
+    const unsigned int ENEMIES_PER_ROOM = 60;
+    const unsigned int CALIBRATION_ROOMS = 64;
+    const unsigned int CALIBRATION_FRAMES = 300;
+    const double REALTIME_SECONDS = 3.0;
+    const double REALTIME_HEADROOM = 0.8;
+    const unsigned int HEAVY_PLAYERS = 1500;
+    const unsigned int HEAVY_ENEMIES = 3000;
+
+    std::vector<unsigned int> populateRoom(Game::Room& room, unsigned int playerCount, unsigned int enemyCount) {
+        Game::Map& map = room.getMap();
+        map.setPlayableArea(Game::Rect(Game::Vector(-4000, -4000), 8000, 8000));
+        std::vector<unsigned int> players;
+        Game::EntityStats stats;
+        for (unsigned int i = 0; i < playerCount; i++) {
+            int x = static_cast<int>(i % 40) * 150 - 3000;
+            int y = -static_cast<int>(i / 40) * 90 - 100;
+            players.push_back(map.createEntity(Game::EntityTemplate(stats, Game::Rect(Game::Vector(x, y), 60, 60), NULL, Game::Team::TEAM::PLAYER)));
+        }
+        map.setPlayerID(players.front());
+        unsigned int columns = 60;
+        for (unsigned int i = 0; i < enemyCount; i++) {
+            int x = static_cast<int>(i % columns) * 70 - 2100;
+            int y = static_cast<int>(i / columns) * 70 + 200;
+            map.createEntity(Game::EntityTemplate(stats, Game::Rect(Game::Vector(x, y), 40, 40), NULL, Game::Team::TEAM::ENEMY));
+        }
+        return players;
+    }
+
+    struct BenchRoom {
+        Game::Room* room;
+        std::vector<unsigned int> players;
+    };
+
+    void queueInputs(std::vector<BenchRoom>& rooms, std::mt19937& random, unsigned int tick) {
+        std::uniform_int_distribution<int> step(-6, 6);
+        std::uniform_int_distribution<int> target(-1500, 1500);
+        for (BenchRoom& benchRoom : rooms) {
+            for (unsigned int playerID : benchRoom.players) {
+                benchRoom.room->queueIntent(Game::Intent(Game::Intent::TYPE::MOVE, playerID, Game::Vector(step(random), step(random))));
+                if ((tick + playerID) % 20 == 0) {
+                    benchRoom.room->queueIntent(Game::Intent(Game::Intent::TYPE::ATTACK, playerID, Game::Vector(target(random), 600)));
+                }
+            }
+        }
+    }
+
+    std::vector<BenchRoom> addRooms(Game::RoomHost& host, unsigned int count, unsigned int playerCount, unsigned int enemyCount) {
+        std::vector<BenchRoom> rooms;
+        for (unsigned int i = 0; i < count; i++) {
+            BenchRoom benchRoom;
+            benchRoom.room = &host.createRoom();
+            benchRoom.players = populateRoom(*benchRoom.room, playerCount, enemyCount);
+            rooms.push_back(benchRoom);
+        }
+        return rooms;
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::mt19937 random(1234);
+    double roomMilliseconds = 0;
+    {
+        Game::RoomHost host(1, TICK_RATE);
+        std::vector<BenchRoom> rooms = addRooms(host, CALIBRATION_ROOMS, PLAYERS_PER_ROOM, ENEMIES_PER_ROOM);
+        for (unsigned int tick = 0; tick < 60; tick++) {
+            queueInputs(rooms, random, tick);
+            host.runFrame();
+        }
+        double total = 0;
+        for (unsigned int tick = 0; tick < CALIBRATION_FRAMES; tick++) {
+            queueInputs(rooms, random, tick);
+            host.runFrame();
+            total += host.getFrameMilliseconds();
+        }
+        roomMilliseconds = total / CALIBRATION_FRAMES / CALIBRATION_ROOMS;
+    }
+    double frameBudget = 1000.0 / TICK_RATE;
+    unsigned int roomsPerCore = static_cast<unsigned int>(frameBudget / roomMilliseconds);
+    std::cout << CALIBRATION_ROOMS << " rooms of " << PLAYERS_PER_ROOM + ENEMIES_PER_ROOM << " entities on one worker: " << roomMilliseconds * 1000 << " us per room tick\n";
+    std::cout << "rooms per core at " << TICK_RATE << " Hz: " << roomsPerCore << "\n";
+
+    unsigned int workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    unsigned int roomCount = static_cast<unsigned int>(roomsPerCore * workerCount * REALTIME_HEADROOM);
+    Game::RoomHost host(workerCount, TICK_RATE);
+    host.setRoomBudget(frameBudget / 8);
+    std::vector<BenchRoom> rooms = addRooms(host, roomCount, PLAYERS_PER_ROOM, ENEMIES_PER_ROOM);
+    std::vector<BenchRoom> heavyRooms = addRooms(host, 1, HEAVY_PLAYERS, HEAVY_ENEMIES);
+    rooms.push_back(heavyRooms.front());
+
+    std::atomic<bool> stopping(false);
+    std::thread inputThread([&rooms, &stopping]() {
+        std::mt19937 inputRandom(99);
+        unsigned int tick = 0;
+        while (!stopping.load()) {
+            queueInputs(rooms, inputRandom, tick++);
+            std::this_thread::sleep_for(std::chrono::microseconds(1000000 / TICK_RATE));
+        }
+    });
+    host.run(REALTIME_SECONDS);
+    stopping.store(true);
+    inputThread.join();
+
+    unsigned int throttled = 0;
+    unsigned int skipped = 0;
+    unsigned int overruns = 0;
+    unsigned int ticks = 0;
+    for (const Game::RoomStats& stats : host.getRoomStats()) {
+        throttled += stats.throttled ? 1 : 0;
+        skipped += stats.skippedTicks;
+        overruns += stats.overruns;
+        ticks += stats.ticks;
+    }
+    Game::RoomStats heavy = host.getRoom(heavyRooms.front().room->getID())->getStats();
+    std::cout << roomCount << " rooms plus one " << HEAVY_PLAYERS + HEAVY_ENEMIES << "-entity room on " << workerCount << " workers for " << REALTIME_SECONDS << " s\n";
+    std::cout << "room ticks: " << ticks << ", room overruns: " << overruns << ", worker overruns: " << host.getWorkerOverrunCount() << ", migrations: " << host.getMigrationCount() << "\n";
+    std::cout << "throttled rooms: " << throttled << ", skipped ticks: " << skipped << "\n";
+    std::cout << "heavy room: " << heavy.averageMilliseconds << " ms avg, " << heavy.maxMilliseconds << " ms max, worker " << heavy.worker << (heavy.throttled ? ", throttled" : "") << "\n";
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "shapes.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+
+namespace {
+
+    const unsigned int SHAPES = 2000;
+    const unsigned int RECTS_PER_SHAPE = 256;
+    const unsigned int ROUNDS = 5;
+
+    Game::Shape randomShape(std::mt19937& random) {
+        std::uniform_int_distribution<int> position(-400, 400);
+        std::uniform_int_distribution<int> size(1, 200);
+        Game::Vector center(position(random), position(random));
+        switch (random() % 5) {
+            case 0:
+                return Game::Shape::aabb(Game::Rect(center, size(random), size(random)));
+            case 1:
+                return Game::Shape::circle(Game::Circle(center, size(random)));
+            case 2:
+                return Game::Shape::capsule(center, Game::Vector(center.x + position(random) / 2, center.y + position(random) / 2), size(random) / 4);
+            case 3: {
+                std::vector<Game::Vector> vertices;
+                for (unsigned int i = 0; i < 6; i++) {
+                    vertices.push_back(Game::Vector(center.x + position(random) / 3, center.y + position(random) / 3));
+                }
+                return Game::Shape::polygon(vertices);
+            }
+            default:
+                return Game::Shape::cone(center, Game::Vector(position(random), position(random)), size(random) * 2, 30);
+        }
+    }
+
+    std::vector<Game::Rect> randomRects(const Game::Rect& area, std::mt19937& random) {
+        std::uniform_int_distribution<int> offsetX(-60, area.width);
+        std::uniform_int_distribution<int> offsetY(-60, area.height);
+        std::uniform_int_distribution<int> size(1, 60);
+        std::vector<Game::Rect> rects;
+        for (unsigned int i = 0; i < RECTS_PER_SHAPE; i++) {
+            Game::Vector topLeft(area.topLeft.x + offsetX(random), area.topLeft.y + offsetY(random));
+            if (i % 64 == 63) {
+                rects.push_back(Game::Rect(Game::Vector(topLeft.x * 40, topLeft.y * 40), size(random) * 400, size(random) * 400));
+            }
+            else {
+                rects.push_back(Game::Rect(topLeft, size(random), size(random)));
+            }
+        }
+        return rects;
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::mt19937 random(1234);
+    std::vector<Game::Shape> shapes;
+    std::vector<std::vector<Game::Rect>> rectSets;
+    for (unsigned int i = 0; i < SHAPES; i++) {
+        shapes.push_back(randomShape(random));
+        rectSets.push_back(randomRects(shapes.back().getBounds(), random));
+    }
+
+    unsigned long long mismatches = 0;
+    unsigned long long hits = 0;
+    std::vector<char> batched;
+    std::vector<char> single;
+    std::vector<Game::Rect> one(1);
+    for (unsigned int i = 0; i < SHAPES; i++) {
+        shapes[i].overlapsRects(rectSets[i], batched);
+        for (unsigned int j = 0; j < rectSets[i].size(); j++) {
+            one[0] = rectSets[i][j];
+            shapes[i].overlapsRects(one, single);
+            bool pair = shapes[i].overlaps(rectSets[i][j]);
+            if (batched[j] != single[0] || pair != (single[0] != 0)) {
+                mismatches++;
+            }
+            hits += batched[j] ? 1 : 0;
+        }
+    }
+
+    double batchTime = 1e9;
+    double pairTime = 1e9;
+    for (unsigned int round = 0; round < ROUNDS; round++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < SHAPES; i++) {
+            shapes[i].overlapsRects(rectSets[i], batched);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        batchTime = std::min(batchTime, elapsed.count());
+
+        start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < SHAPES; i++) {
+            for (const Game::Rect& rect : rectSets[i]) {
+                hits += shapes[i].overlaps(rect) ? 0 : 1;
+            }
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        pairTime = std::min(pairTime, elapsed.count());
+    }
+
+    std::cout << SHAPES << " shapes x " << RECTS_PER_SHAPE << " rects, best of " << ROUNDS << " rounds\n";
+    std::cout << "overlapsRects:  " << batchTime << " ms\n";
+    std::cout << "overlaps loop:  " << pairTime << " ms\n";
+    if (mismatches > 0) {
+        std::cout << mismatches << " rects where the batched, scalar and pair tests disagree\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "gameLogic.hpp"
+#include "mapSnapshot.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+
+namespace {
+
+    const unsigned int ENTITY_COUNT = 100000;
+    const unsigned int ROUNDS = 5;
+
+    void populateMap(Game::Map& map, std::mt19937& random) {
+        std::uniform_int_distribution<int> positionDistribution(-150000, 150000);
+        std::uniform_int_distribution<int> healthDistribution(10, 200);
+        Game::EntityStats buffChanges;
+        buffChanges.stats[Game::EntityStats::STAT::DMG] = 5;
+        for (unsigned int i = 0; i < ENTITY_COUNT; i++) {
+            Game::EntityStats stats;
+            stats.stats[Game::EntityStats::STAT::HP] = healthDistribution(random);
+            Game::Rect hitbox(Game::Vector(positionDistribution(random), positionDistribution(random)), 30, 30);
+            unsigned int entityID = map.createEntity(Game::EntityTemplate(stats, hitbox, NULL, Game::Team::TEAM::ENEMY));
+            if (i % 8 == 0) {
+                map.getEntityWithID(entityID)->addBuff(Game::Buff(buffChanges, 120, 1));
+            }
+        }
+    }
+
+    uint64_t hashMap(Game::Map& map) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (const Game::Entity& entity : map.getEntities()) {
+            Game::Rect hitbox = entity.getHitbox();
+            int values[4] = { static_cast<int>(entity.getID()), hitbox.topLeft.x, hitbox.topLeft.y, entity.getBaseStats().stats[Game::EntityStats::STAT::HP] };
+            for (int value : values) {
+                hash = (hash ^ static_cast<uint32_t>(value)) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::mt19937 random(1234);
+    Game::Map map;
+    map.setPlayableArea(Game::Rect(Game::Vector(-200000, -200000), 400000, 400000));
+    populateMap(map, random);
+    uint64_t originalHash = hashMap(map);
+
+    std::vector<char> snapshot;
+    double saveTime = 0;
+    double loadTime = 0;
+    bool restored = true;
+    for (unsigned int round = 0; round < ROUNDS; round++) {
+        std::chrono::steady_clock::time_point saveStart = std::chrono::steady_clock::now();
+        Game::MapSnapshot::save(map, snapshot);
+        std::chrono::duration<double, std::milli> saveElapsed = std::chrono::steady_clock::now() - saveStart;
+        saveTime += saveElapsed.count();
+
+        std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+        restored = Game::MapSnapshot::load(map, snapshot.data(), snapshot.size()) && restored;
+        std::chrono::duration<double, std::milli> loadElapsed = std::chrono::steady_clock::now() - loadStart;
+        loadTime += loadElapsed.count();
+    }
+
+    std::cout << map.getEntities().size() << " entities, snapshot " << snapshot.size() / 1024 << " KiB, " << ROUNDS << " rounds\n";
+    std::cout << "save:    " << saveTime / ROUNDS << " ms\n";
+    std::cout << "restore: " << loadTime / ROUNDS << " ms\n";
+    if (!restored || hashMap(map) != originalHash) {
+        std::cout << "Restored map differs from the original\n";
+    }
+    return 0;
+}
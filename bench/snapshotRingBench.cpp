@@ -0,0 +1,115 @@
+#include "snapshotRing.hpp"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+namespace {
+
+    const char* RING_NAME = "summative-snapshot-ring-bench";
+    const unsigned int ENTITY_COUNT = 10000;
+    const unsigned int THROUGHPUT_PUBLISHES = 2000;
+    const unsigned int LATENCY_TICKS = 180;
+    const unsigned int TICK_RATE = 60;
+
+    void populate(Game::Map& map) {
+        map.setPlayableArea(Game::Rect(Game::Vector(-100000, -100000), 200000, 200000));
+        Game::EntityStats stats;
+        for (unsigned int i = 0; i < ENTITY_COUNT; i++) {
+            int x = static_cast<int>(i % 100) * 60 - 3000;
+            int y = static_cast<int>(i / 100) * 60 - 3000;
+            map.createEntity(Game::EntityTemplate(stats, Game::Rect(Game::Vector(x, y), 40, 40), NULL, Game::Team::TEAM::ENEMY));
+        }
+    }
+
+    struct ConsumerResult {
+        unsigned int framesSeen;
+        std::vector<double> latencies;
+        long long checksum;
+    };
+
+    uint32_t getLatestSequence(Rendering::SnapshotRing& ring) {
+        const Rendering::SnapshotSlot* slot = ring.acquireLatest();
+        uint32_t sequence = slot ? slot->sequence : 0;
+        ring.release();
+        return sequence;
+    }
+
+    void consume(const std::atomic<bool>* stopping, uint32_t startSequence, ConsumerResult* result) {
+        Rendering::SnapshotRing ring;
+        while (!ring.open(RING_NAME)) {
+            std::this_thread::yield();
+        }
+        uint32_t lastSequence = startSequence;
+        while (!stopping->load()) {
+            const Rendering::SnapshotSlot* slot = ring.acquireLatest();
+            if (slot && slot->sequence != lastSequence) {
+                uint64_t now = Rendering::SnapshotRing::getTimestamp();
+                result->latencies.push_back((now - slot->publishedNanoseconds) / 1000.0);
+                const Rendering::EntitySnapshot* entities = ring.getEntities(slot);
+                for (uint32_t i = 0; i < slot->entityCount; i++) {
+                    result->checksum += entities[i].hitbox.topLeft.x + entities[i].hp;
+                }
+                lastSequence = slot->sequence;
+                result->framesSeen++;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void printLatencies(std::vector<double> latencies) {
+        if (latencies.empty()) {
+            return;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        double total = 0;
+        for (double latency : latencies) {
+            total += latency;
+        }
+        std::cout << "publish to acquire: " << total / latencies.size() << " us avg, " << latencies[latencies.size() / 2] << " us p50, " << latencies[latencies.size() * 99 / 100] << " us p99, " << latencies.back() << " us max\n";
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    Game::Map map;
+    populate(map);
+    Rendering::SnapshotRing ring;
+    if (!ring.create(RING_NAME, ENTITY_COUNT, 4096)) {
+        std::cout << "Could not create shared memory ring\n";
+        return 1;
+    }
+    uint64_t eventCursor = 0;
+    ring.publish(map, 0, eventCursor);
+
+    std::atomic<bool> stopping(false);
+    ConsumerResult throughput = { 0, std::vector<double>(), 0 };
+    std::thread consumer(consume, &stopping, getLatestSequence(ring), &throughput);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 1; i <= THROUGHPUT_PUBLISHES; i++) {
+        ring.publish(map, i, eventCursor);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stopping.store(true);
+    consumer.join();
+    double megabytes = static_cast<double>(THROUGHPUT_PUBLISHES) * ENTITY_COUNT * sizeof(Rendering::EntitySnapshot) / (1024 * 1024);
+    std::cout << ENTITY_COUNT << " entities, " << THROUGHPUT_PUBLISHES << " back-to-back publishes: " << elapsed.count() * 1000000 / THROUGHPUT_PUBLISHES << " us each, " << THROUGHPUT_PUBLISHES / elapsed.count() << " per second, " << megabytes / elapsed.count() << " MB/s\n";
+    std::cout << "viewer mapped " << throughput.framesSeen << " distinct frames without copying\n";
+
+    stopping.store(false);
+    ConsumerResult paced = { 0, std::vector<double>(), 0 };
+    consumer = std::thread(consume, &stopping, getLatestSequence(ring), &paced);
+    std::chrono::steady_clock::time_point nextTick = std::chrono::steady_clock::now();
+    for (unsigned int i = 1; i <= LATENCY_TICKS; i++) {
+        map.tickAndApplyActions();
+        ring.publish(map, THROUGHPUT_PUBLISHES + i, eventCursor);
+        nextTick += std::chrono::microseconds(1000000 / TICK_RATE);
+        std::this_thread::sleep_until(nextTick);
+    }
+    stopping.store(true);
+    consumer.join();
+    std::cout << LATENCY_TICKS << " ticks at " << TICK_RATE << " Hz, viewer saw " << paced.framesSeen << "\n";
+    printLatencies(paced.latencies);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "spriteBatch.hpp"
+#include <iostream>
+#include <vector>
+
+namespace {
+
+    const unsigned int SPRITE_COUNT = 5000;
+    const unsigned int TEXTURE_COUNT = 8;
+    const unsigned int FRAMES = 200;
+    const unsigned int WIDTH = 1920;
+    const unsigned int HEIGHT = 1080;
+
+    std::vector<sf::Sprite> makeSprites(const std::vector<sf::Texture>& textures) {
+        std::vector<sf::Sprite> sprites;
+        for (unsigned int i = 0; i < SPRITE_COUNT; i++) {
+            sf::Sprite sprite(textures[i * TEXTURE_COUNT / SPRITE_COUNT]);
+            sprite.setPosition(static_cast<float>((i * 37) % WIDTH), static_cast<float>((i * 91) % HEIGHT));
+            sprite.setScale(0.5f, 0.5f);
+            sprites.push_back(sprite);
+        }
+        return sprites;
+    }
+
+    void moveSprites(std::vector<sf::Sprite>& sprites) {
+        for (sf::Sprite& sprite : sprites) {
+            sprite.move(1.f, 0.f);
+            if (sprite.getPosition().x > WIDTH) {
+                sprite.setPosition(0.f, sprite.getPosition().y);
+            }
+        }
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    sf::RenderTexture target;
+    if (!target.create(WIDTH, HEIGHT)) {
+        std::cout << "Could not create render texture\n";
+        return 1;
+    }
+    std::vector<sf::Texture> textures(TEXTURE_COUNT);
+    for (unsigned int i = 0; i < TEXTURE_COUNT; i++) {
+        sf::Image image;
+        image.create(64, 64, sf::Color(40 * i, 255 - 30 * i, 128));
+        textures[i].loadFromImage(image);
+    }
+    std::vector<sf::Sprite> sprites = makeSprites(textures);
+
+    sf::Clock clock;
+    for (unsigned int frame = 0; frame < FRAMES; frame++) {
+        moveSprites(sprites);
+        target.clear(sf::Color::White);
+        for (const sf::Sprite& sprite : sprites) {
+            target.draw(sprite);
+        }
+        target.display();
+    }
+    target.getTexture().copyToImage();
+    float individual = clock.restart().asSeconds() * 1000.f / FRAMES;
+
+    Rendering::SpriteBatch batch;
+    for (unsigned int frame = 0; frame < FRAMES; frame++) {
+        moveSprites(sprites);
+        target.clear(sf::Color::White);
+        batch.begin(sf::FloatRect(0, 0, WIDTH, HEIGHT));
+        for (const sf::Sprite& sprite : sprites) {
+            batch.add(sprite);
+        }
+        batch.flush(target);
+        target.display();
+    }
+    target.getTexture().copyToImage();
+    float batched = clock.restart().asSeconds() * 1000.f / FRAMES;
+
+    std::cout << SPRITE_COUNT << " sprites over " << TEXTURE_COUNT << " textures, " << FRAMES << " frames\n";
+    std::cout << "sf::Sprite draws: " << SPRITE_COUNT << " draw calls, " << individual << " ms/frame\n";
+    std::cout << "sprite batch:     " << batch.getDrawCalls() << " draw calls, " << batched << " ms/frame\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <SFML/Graphics.hpp>
+#include "textureAtlas.hpp"
+#include "assetRegistry.hpp"
+
+namespace Rendering {
+
+    class AssetLoader {
+    public:
+        enum class STATE {
+            QUEUED,
+            DECODED,
+            READY,
+            EVICTED,
+            FAILED
+        };
+
+        struct PageData {
+            const sf::Uint8* pixels;
+            unsigned int width;
+            unsigned int height;
+        };
+
+        struct FrameData {
+            unsigned int page;
+            sf::IntRect rect;
+        };
+    private:
+        static const sf::Uint8 PLACEHOLDER_SHADE = 160;
+        static const sf::Uint8 PLACEHOLDER_ALPHA = 96;
+
+        struct Request {
+            std::vector<std::string> paths;
+            std::vector<unsigned int> targets;
+            sf::Texture* texture;
+            std::vector<sf::Image> pageImages;
+            std::vector<PageData> pages;
+            std::vector<std::vector<FrameData>> frames;
+            std::vector<unsigned int> atlasPages;
+            size_t bytes;
+            STATE state;
+        };
+
+        TextureAtlas* atlas;
+        AssetRegistry* registry;
+        unsigned int pageSize;
+        AtlasFrame placeholder;
+        std::deque<Request> requests;
+        std::deque<unsigned int> decodeQueue;
+        std::vector<unsigned int> unfinished;
+        std::vector<std::thread> workers;
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping;
+        unsigned int readyCount;
+        unsigned long long uploadedBytes;
+
+        void runWorker();
+        bool decode(Request& request);
+        void decodeSequence(const std::string& path, std::vector<sf::Image>& images);
+        bool upload(Request& request, size_t budget, size_t& uploaded);
+        void resolve(Request& request);
+        static size_t getPageBytes(const std::vector<PageData>& pages);
+        unsigned int addRequest(const Request& request);
+    public:
+        AssetLoader();
+        ~AssetLoader();
+        AssetLoader(const AssetLoader& copying) = delete;
+        AssetLoader& operator=(const AssetLoader& copying) = delete;
+        static unsigned int getDefaultWorkerCount();
+        void start(TextureAtlas* atlas_, AssetRegistry* registry_, unsigned int workerCount);
+        void stop();
+        unsigned int requestSequences(const std::vector<std::string>& paths, const std::vector<unsigned int>& targets);
+        unsigned int requestTexture(const std::string& path, sf::Texture* target);
+        unsigned int requestUpload(const std::vector<PageData>& pages, const std::vector<std::vector<FrameData>>& frames, const std::vector<unsigned int>& targets);
+        unsigned int requestTextureUpload(const PageData& page, sf::Texture* target);
+        size_t update(size_t uploadBudget);
+        bool evict(unsigned int handle);
+        bool reload(unsigned int handle);
+        STATE getState(unsigned int handle) const;
+        bool isReady(unsigned int handle) const;
+        size_t getBytes(unsigned int handle) const;
+        bool isFinished() const;
+        unsigned int getRequestCount() const;
+        unsigned int getReadyCount() const;
+        unsigned int getWorkerCount() const;
+        unsigned long long getUploadedBytes() const;
+        const AtlasFrame& getPlaceholder() const;
+    };
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace Rendering {
+
+    struct AssetEntry {
+        enum class KIND {
+            TEXTURE_SET,
+            ANIMATION,
+            BACKGROUND,
+            ABSOLUTE_BACKGROUND,
+            FONT
+        };
+        KIND kind;
+        std::string name;
+        std::string path;
+    };
+
+    class AssetManifest {
+        std::vector<AssetEntry> entries;
+        std::string lastError;
+    public:
+        bool load(const std::string& text);
+        bool loadFromFile(const std::string& path);
+        const std::vector<AssetEntry>& getEntries() const;
+        const std::string& getLastError() const;
+    };
+
+}
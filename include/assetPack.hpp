@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "assetManifest.hpp"
+#include "mappedFile.hpp"
+
+namespace Rendering {
+
+    class AssetPack {
+    public:
+        static const uint32_t PAGE_REPEATED = 1;
+
+        struct PageRow {
+            uint32_t width;
+            uint32_t height;
+            uint32_t offset;
+            uint32_t flags;
+        };
+
+        struct FrameRow {
+            uint32_t page;
+            int32_t x;
+            int32_t y;
+            int32_t width;
+            int32_t height;
+        };
+
+        struct SetEntry {
+            AssetEntry::KIND kind;
+            std::string name;
+            std::string state;
+            uint32_t firstFrame;
+            uint32_t frameCount;
+        };
+
+        struct FontEntry {
+            std::string name;
+            const char* data;
+            uint32_t size;
+        };
+    private:
+        static const uint32_t MAGIC = 0x4b434150;
+        static const uint16_t VERSION = 2;
+
+        enum class SECTION : uint32_t {
+            PAGES = 0x53454750,
+            FRAMES = 0x4d415246,
+            SETS = 0x53544553,
+            FONTS = 0x544e4f46,
+            PIXELS = 0x4c455850
+        };
+
+        struct SectionHeader {
+            uint32_t tag;
+            uint32_t count;
+            uint32_t size;
+            uint32_t checksum;
+        };
+
+        Game::MappedFile file;
+        std::vector<PageRow> pages;
+        std::vector<FrameRow> frames;
+        std::vector<SetEntry> sets;
+        std::vector<FontEntry> fonts;
+        const char* pixels;
+        uint32_t pixelSize;
+
+        static bool isChecksummed(SECTION section);
+        bool parse(const char* data, size_t size);
+        bool parseSets(const char* data, uint32_t size, uint32_t count);
+        bool parseFonts(const char* data, uint32_t size, uint32_t count);
+    public:
+        class Builder {
+            std::vector<PageRow> pages;
+            std::vector<FrameRow> frames;
+            std::vector<SetEntry> sets;
+            std::vector<std::pair<std::string, std::vector<char>>> fonts;
+            std::vector<char> pixels;
+        public:
+            unsigned int addPage(uint32_t width, uint32_t height, const uint8_t* rgba, uint32_t flags);
+            unsigned int addFrame(uint32_t page, int32_t x, int32_t y, int32_t width, int32_t height);
+            void addSet(AssetEntry::KIND kind, const std::string& name, const std::string& state, uint32_t firstFrame, uint32_t frameCount);
+            void addFont(const std::string& name, const std::vector<char>& data);
+            void save(std::vector<char>& out) const;
+            bool saveToFile(const std::string& path) const;
+        };
+
+        AssetPack();
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const;
+        const std::vector<PageRow>& getPages() const;
+        const uint8_t* getPagePixels(unsigned int page) const;
+        const std::vector<FrameRow>& getFrames() const;
+        const std::vector<SetEntry>& getSets() const;
+        const std::vector<FontEntry>& getFonts() const;
+    };
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "textureAtlas.hpp"
+#include "assetManifest.hpp"
+
+namespace Rendering {
+
+    class AssetRegistry {
+        struct Sequence {
+            unsigned int firstFrame;
+            unsigned int frameCount;
+            unsigned int capacity;
+        };
+
+        struct Set {
+            unsigned int firstSequence;
+            unsigned int stateCount;
+        };
+
+        std::vector<AtlasFrame> frames;
+        std::vector<Sequence> sequences;
+        std::vector<Set> sets;
+        std::vector<std::string> stateNames;
+        std::map<std::pair<AssetEntry::KIND, std::string>, unsigned int> setHandles;
+        AtlasFrame missingFrame;
+    public:
+        static const unsigned int NONE = 0xffffffff;
+
+        AssetRegistry();
+        unsigned int internState(const std::string& name);
+        unsigned int findState(const std::string& name) const;
+        unsigned int addSet(AssetEntry::KIND kind, const std::string& name, unsigned int stateCount);
+        unsigned int findSet(AssetEntry::KIND kind, const std::string& name) const;
+        unsigned int getSequence(unsigned int set, unsigned int state) const;
+        void setFrames(unsigned int sequence, const std::vector<AtlasFrame>& sequenceFrames);
+        void setMissingFrame(const AtlasFrame& missingFrame_);
+        unsigned int getFrameCount(unsigned int sequence) const;
+        const AtlasFrame& getFrame(unsigned int sequence, unsigned int index) const;
+        unsigned int getSetCount() const;
+        unsigned int getStoredFrameCount() const;
+    };
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+
+namespace Rendering {
+
+    struct AtlasPlacement {
+        unsigned int page;
+        int x, y;
+        unsigned int width, height;
+    };
+
+    class AtlasPacker {
+        struct PageState {
+            unsigned int shelfY;
+            unsigned int shelfHeight;
+            unsigned int cursorX;
+            unsigned int usedWidth;
+            unsigned int usedHeight;
+            bool dedicated;
+        };
+        unsigned int pageSize;
+        unsigned int padding;
+        std::vector<AtlasPlacement> placements;
+        std::vector<PageState> pages;
+
+        bool placeOnPage(PageState& page, unsigned int width, unsigned int height, unsigned int& x, unsigned int& y);
+    public:
+        AtlasPacker(unsigned int pageSize_, unsigned int padding_);
+        unsigned int add(unsigned int width, unsigned int height);
+        void pack();
+        void clear();
+        const AtlasPlacement& getPlacement(unsigned int index) const;
+        unsigned int getPlacementCount() const;
+        unsigned int getPageCount() const;
+        unsigned int getPageWidth(unsigned int page) const;
+        unsigned int getPageHeight(unsigned int page) const;
+        unsigned int getPadding() const;
+    };
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "geometry.hpp"
+
+namespace Game {
+
+    class CollisionLayer {
+        static const int CELL_SHIFT = 2;
+        static const int PAGE_SHIFT = 6;
+        static const int PAGE_CELLS = 1 << PAGE_SHIFT;
+
+        struct Page {
+            uint64_t rows[PAGE_CELLS];
+        };
+
+        struct CellRange {
+            int minX, minY, maxX, maxY;
+        };
+
+        std::unordered_map<int64_t, Page> pages;
+
+        static CellRange getCellRange(const Rect& rect);
+        static int64_t getPageKey(int pageX, int pageY);
+        static uint64_t getRowMask(int pageX, int minX, int maxX);
+    public:
+        CollisionLayer();
+        void clear();
+        void fill(const Rect& rect);
+        void clearArea(const Rect& rect);
+        bool occupied(const Vector& point) const;
+        bool intersects(const Rect& rect) const;
+        unsigned int getMemoryBytes() const;
+    };
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+namespace Game {
+
+    class Fixed {
+        int32_t raw;
+    public:
+        static const int FRACTION_BITS = 16;
+        static const int32_t ONE = 1 << FRACTION_BITS;
+
+        constexpr Fixed() : raw(0) {}
+        constexpr explicit Fixed(int value) : raw(value * ONE) {}
+        Fixed(double value) = delete;
+
+        static constexpr Fixed fromRaw(int32_t raw_) {
+            return Fixed(raw_, 0);
+        }
+        static constexpr Fixed fromFraction(int numerator, int denominator) {
+            return Fixed(static_cast<int32_t>(static_cast<int64_t>(numerator) * ONE / denominator), 0);
+        }
+
+        constexpr int32_t getRaw() const { return raw; }
+        constexpr int toInt() const { return raw / ONE; }
+        constexpr float toFloat() const { return static_cast<float>(raw) / ONE; }
+
+        constexpr Fixed operator+(Fixed adding) const { return fromRaw(raw + adding.raw); }
+        constexpr Fixed operator-(Fixed subtracting) const { return fromRaw(raw - subtracting.raw); }
+        constexpr Fixed operator-() const { return fromRaw(-raw); }
+        constexpr Fixed operator*(Fixed multiplying) const {
+            return fromRaw(static_cast<int32_t>(static_cast<int64_t>(raw) * multiplying.raw / ONE));
+        }
+        constexpr Fixed operator/(Fixed dividing) const {
+            return fromRaw(static_cast<int32_t>(static_cast<int64_t>(raw) * ONE / dividing.raw));
+        }
+        Fixed& operator+=(Fixed adding) { raw += adding.raw; return *this; }
+        Fixed& operator-=(Fixed subtracting) { raw -= subtracting.raw; return *this; }
+        Fixed& operator*=(Fixed multiplying) { *this = *this * multiplying; return *this; }
+
+        constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+        constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+        constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+        constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+        constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+        constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+    private:
+        constexpr Fixed(int32_t raw_, int) : raw(raw_) {}
+    };
+
+    const int ANGLES_PER_TURN = 4096;
+
+    int degreesToAngle(int degrees);
+    Fixed fixedSin(int angle);
+    Fixed fixedCos(int angle);
+    Fixed fixedSqrt(int64_t value);
+    int64_t integerSqrt(int64_t value);
+
+}
@@ -5,8 +5,19 @@
 #include <cmath>
 #include <list>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "gameLogic.hpp"
+#include "prefabs.hpp"
+#include "worldStreaming.hpp"
+#include "replay.hpp"
 #include "rendering.hpp"
+#include "spriteBatch.hpp"
+#include "assetPack.hpp"
+#include "assetRegistry.hpp"
+#include "assetLoader.hpp"
+#include "residencyManager.hpp"
 #include "io.hpp"
 
 namespace Main {
@@ -14,6 +25,11 @@ namespace Main {
     class GameInstance {
         const unsigned int FPS_CAP = 60;
         const float TIME_PER_FRAME = 1.f / static_cast<float>(FPS_CAP);
+        const bool PIPELINED_SIMULATION = true;
+        const unsigned int SHARED_ENTITY_CAPACITY = 1 << 16;
+        const unsigned int SHARED_EVENT_CAPACITY = 1 << 14;
+        const float SHARED_STALE_SECONDS = 1.f;
+        const unsigned int UPLOAD_BUDGET_BYTES = 4 * 1024 * 1024;
         sf::Clock frameClock;
         std::list<float> lastFrameTimes;
         sf::Text fpsText;
@@ -21,18 +37,53 @@ namespace Main {
         std::map<std::string, sf::Font> fonts;
 
         Game::Map map;
-        std::map<std::string, Game::EntityTemplate> entityTemplates;
+        Game::WorldStreamer worldStreamer;
+        Game::Rect streamingView;
+        Rendering::SnapshotBuffer snapshots;
+        Rendering::SnapshotRing sharedRing;
+        Rendering::RenderSnapshot sharedSnapshot;
+        std::string sharedRingName;
+        bool viewingSharedRing;
+        uint32_t lastSharedSequence;
+        sf::Clock sharedStaleClock;
+        double sharedLatencyTotal;
+        unsigned int sharedLatencySamples;
+        std::vector<Game::Intent> pendingIntents;
+        Game::ReplayRecorder recorder;
+        std::string recordingPath;
+        unsigned int currentTick;
+        uint64_t eventCursor;
+        int lastDispatchedTick;
+        std::thread simulationThread;
+        std::mutex simulationMutex;
+        std::condition_variable simulationWake;
+        bool tickRequested;
+        bool tickFinished;
+        bool simulationStopping;
+        Game::PrefabLibrary prefabs;
         sf::RenderWindow window;
-        std::map<std::string, std::map<std::string, std::vector<sf::Texture>>> textureSets;
-        std::map<std::string, std::vector<sf::Texture>> attackAnimations;
+        Rendering::TextureAtlas atlas;
+        Rendering::AssetPack assetPack;
+        Rendering::AssetLoader assetLoader;
+        Rendering::ResidencyManager residency;
+        sf::Clock assetClock;
+        bool assetsReported;
+        Rendering::AssetRegistry registry;
+        std::vector<unsigned int> prefabTextureSets;
+        unsigned int playerTextureSet;
+        unsigned int dummyTextureSet;
+        unsigned int idleState;
+        unsigned int hitState;
+        std::vector<Rendering::StateSequences> stateSequences;
         std::vector<Rendering::EntityRenderer> entityRenderers;
+        std::unordered_map<unsigned int, unsigned int> rendererIndices;
         std::vector<Rendering::Animation> animations;
+        Rendering::SpriteBatch spriteBatch;
         std::vector<Rendering::Background> backgrounds;
         std::map<std::string, sf::Texture> backgroundTextures;
         Rendering::Camera camera;
         std::vector<IO::KeyHandler*> keyHandlers;
         std::vector<IO::MouseHandler*> mouseHandlers;
-        std::map<std::string, std::vector<sf::Texture>> absoluteBackgroundTextures;
         Rendering::AbsoluteBackground absoluteBackground;
         std::vector<sf::VideoMode> videoModes;
 
@@ -42,16 +93,22 @@ namespace Main {
         float getAvgFPS();
         sf::VideoMode getLargestCompatibleResolution();
 
+        void indexStateSequences(unsigned int textureSet);
         void loadTextureSetFromPath(std::string setPath, std::string name);
+        void loadFrameSet(Rendering::AssetEntry::KIND kind, std::string path, std::string name);
         void loadAbsoluteBackgroundTexturesFromPath(std::string path, std::string name);
         void loadBackgroundTextureFromPath(std::string path, std::string name);
         void loadFontFromPath(std::string path, std::string name);
         void loadAnimationSet(std::string path, std::string name);
+        void loadAssetsFromManifest();
+        void loadAssetsFromPack();
 
         void initializeWindow();
         void initializeTextures();
+        void tickAssetLoading();
         void initializeVideoModes();
         void initializeIO();
+        void initializePrefabs();
         void initializeGameLogic();
         void initializeRendering();
         void initializeGame();
@@ -59,18 +116,36 @@ namespace Main {
         void tickIO();
         void tickGameLogic();
 
+        unsigned int getTextureSet(const Rendering::RenderSnapshot& snapshot, unsigned int entityID);
+        Rendering::StateSequences getStateSequences(unsigned int textureSet) const;
+        void addEntityRenderer(const Rendering::EntityRenderer& renderer);
+        void indexRenderers();
+        void resyncRenderers(const Rendering::RenderSnapshot& snapshot);
+        void dispatchEvents(const Rendering::RenderSnapshot& snapshot);
         void cullRenderers();
         void cullAnimations();
         void drawBackgrounds();
         void drawEntities();
         void drawAnimations();
-        void updateFPSText();
+        void updateFPSText(const Rendering::RenderSnapshot& snapshot);
+        const Rendering::RenderSnapshot& acquireRenderSnapshot();
+        void syncViewerPlayer(const Rendering::RenderSnapshot& snapshot);
         void tickRendering();
 
+        void publishSnapshot();
         void tickGame();
+        void runSimulationThread();
+        void startSimulationThread();
+        void stopSimulationThread();
+        void requestSimulationTick();
+        void waitForSimulationTick();
     public:
         GameInstance();
+        void record(const std::string& path);
+        void setTextureBudget(unsigned int megabytes);
         void run();
+        void runSimulation(const std::string& ringName);
+        void runViewer(const std::string& ringName);
     };
 
 }
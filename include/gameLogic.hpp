@@ -7,45 +7,26 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include "geometry.hpp"
+#include "statArray.hpp"
+#include "mpscQueue.hpp"
+#include "spatialGrid.hpp"
+#include "kinematics.hpp"
+#include "mortonOrder.hpp"
+#include "collisionLayer.hpp"
+#include "overlapCache.hpp"
+#include "shapes.hpp"
+#include "mapEvents.hpp"
 
 namespace Game {
-    const float PI = 3.14159265359;
-
     class Entity;
     class Map;
-
-    struct Vector {
-        int x,y;
-        Vector(int x_a, int y_a);
-        Vector(const Vector& vector);
-        Vector();
-    };
-
-    Vector rotatePoint(Vector point, Vector anchor, float angle);
-
-    float manhattanDistance(Game::Vector p1, Game::Vector p2);
-
-    struct Rect {
-        Vector topLeft;
-        int width, height;
-        Rect();
-        Rect(const Vector& topLeft_a, unsigned int width_a, unsigned int height_a);
-        bool contains(const Vector& point) const;
-        bool contains(const Rect& rect) const;
-        Game::Vector getCenter() const;
-        bool intersects(const Rect& rect) const;
-        bool operator==(const Rect& rect) const;
-    };
-
-    struct Circle {
-        Vector center;
-        int radius;
-        Circle();
-        Circle(const Vector& center, unsigned int radius);
-        bool intersects(const Rect& rect) const;
-        bool contains(const Vector& point) const;
-        bool contains(const Rect& rect) const;
-    };
+    class BinaryWriter;
+    class BinaryReader;
+    class MapSnapshot;
+    class RollbackRing;
+    struct Prefab;
+    struct SpawnPlacement;
 
     struct EntityStats {
         enum class STAT {
@@ -66,6 +47,8 @@ namespace Game {
             MOVE,
             DMG
         };
+        static const unsigned int STAT_COUNT = 8;
+        static const unsigned int STAT_MOD_COUNT = 6;
         EntityStats();
         EntityStats(const EntityStats& copying);
         EntityStats operator+(const EntityStats& adding);
@@ -73,13 +56,14 @@ namespace Game {
         void operator=(const EntityStats& copying);
         void operator+=(const EntityStats& adding);
         void operator-=(const EntityStats& subtracting);
-        std::map<STAT, int> stats;
-        std::map<STAT_MOD, float> statModifiers;
+        StatArray<STAT, int, STAT_COUNT> stats;
+        StatArray<STAT_MOD, Fixed, STAT_MOD_COUNT> statModifiers;
     };
 
     class BehaviourProfile {
     protected:
         static const int repathDelay = 10;
+        static const unsigned int maxPathLength = 50;
         static const std::vector<Game::Vector> degreesOfMovement;
 
         class Node {
@@ -88,7 +72,7 @@ namespace Game {
             Game::Map* map;
             bool entityValid() const;
         public:
-            Node(const Game::Rect& area_, unsigned int entityID_);
+            Node(const Game::Rect& area_, unsigned int entityID_, Game::Map* map_);
             std::vector<Node> getAdjacent() const;
             Game::Rect getRect() const;
             bool operator==(const Node& node) const;
@@ -106,6 +90,14 @@ namespace Game {
         virtual void checkIfNeedRepath();
         virtual void spawnDamageAction();
     public:
+        enum class PROFILE {
+            GRUNT
+        };
+        static BehaviourProfile* create(PROFILE profile, unsigned int entityID, Map* map);
+        virtual ~BehaviourProfile();
+        virtual PROFILE getProfileType() const=0;
+        virtual void save(BinaryWriter& writer) const;
+        virtual bool load(BinaryReader& reader);
         virtual unsigned int getEntityID()=0;
         virtual bool entityValid() const;
         virtual void tick()=0;
@@ -116,6 +108,7 @@ namespace Game {
 
     public:
         GruntBehaviourProfile(unsigned int entityID, Map* map);
+        virtual PROFILE getProfileType() const override;
         virtual unsigned int getEntityID() override;
         virtual void tick() override;
     };
@@ -132,24 +125,41 @@ namespace Game {
         Buff(const EntityStats& changes_, unsigned int framesMax_, unsigned int frameInterval_);
         unsigned int getFramesLeft() const;
         unsigned int getMaxFrames() const;
+        unsigned int getFrameInterval() const;
+        const EntityStats& getChanges() const;
+        void setFramesLeft(unsigned int framesLeft_);
         void apply(EntityStats& stats) const;
         void tick();
     };
 
     class Targeting {
     public:
+        enum class TARGETING {
+            NONE,
+            ALL,
+            RECT,
+            CIRCLE,
+            SHAPE,
+            OVERLAP
+        };
+        static std::unique_ptr<Targeting> load(BinaryReader& reader);
+        virtual ~Targeting();
+        virtual TARGETING getTargetingType() const=0;
+        virtual void save(BinaryWriter& writer) const;
         virtual std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map)=0;
     };
 
     class NoTargeting : public Targeting {
     public:
         NoTargeting();
+        TARGETING getTargetingType() const override;
         std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
     };
 
     class AllTargeting : public Targeting {
     public:
         AllTargeting();
+        TARGETING getTargetingType() const override;
         std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
     };
 
@@ -157,6 +167,8 @@ namespace Game {
         Rect rect;
     public:
         RectTargeting(const Rect& rect_);
+        TARGETING getTargetingType() const override;
+        void save(BinaryWriter& writer) const override;
         std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
     };
 
@@ -164,6 +176,29 @@ namespace Game {
         Circle circle;
     public:
         CircleTargeting(const Circle& circle_);
+        TARGETING getTargetingType() const override;
+        void save(BinaryWriter& writer) const override;
+        std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
+    };
+
+    class ShapeTargeting : public Targeting {
+        Shape shape;
+        std::vector<Rect> candidateRects;
+        std::vector<unsigned int> candidateIDs;
+        std::vector<char> hits;
+    public:
+        ShapeTargeting(const Shape& shape_);
+        TARGETING getTargetingType() const override;
+        void save(BinaryWriter& writer) const override;
+        std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
+    };
+
+    class OverlapTargeting : public Targeting {
+        unsigned int entityID;
+    public:
+        OverlapTargeting(unsigned int entityID_);
+        TARGETING getTargetingType() const override;
+        void save(BinaryWriter& writer) const override;
         std::vector<unsigned int> isInRange(const std::vector<unsigned int>& entities, Map* map) override;
     };
 
@@ -176,6 +211,8 @@ namespace Game {
             ENEMY,
             TERRAIN
         };
+        static const Team* getChecker(TEAM team);
+        virtual TEAM getTeamType() const=0;
         virtual std::vector<unsigned int> canBeHit(const std::vector<unsigned int>& entities, Map* map) const =0;
         virtual std::vector<unsigned int> canBeHealed(const std::vector<unsigned int>& entities, Map* map) const=0;
         virtual std::vector<unsigned int> canBeDisplaced(const std::vector<unsigned int>& entities, Map* map) const =0;
@@ -184,6 +221,7 @@ namespace Game {
     class PlayerTeam : public Team {
     public:
         static const PlayerTeam PLAYER_TEAM;
+        virtual TEAM getTeamType() const override;
         virtual std::vector<unsigned int> canBeHit(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeHealed(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeDisplaced(const std::vector<unsigned int>& entities, Map* map) const override;
@@ -192,6 +230,7 @@ namespace Game {
     class EnemyTeam : public Team {
     public:
         static const EnemyTeam ENEMY_TEAM;
+        virtual TEAM getTeamType() const override;
         virtual std::vector<unsigned int> canBeHit(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeHealed(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeDisplaced(const std::vector<unsigned int>& entities, Map* map) const override;
@@ -200,6 +239,7 @@ namespace Game {
     class TerrainTeam : public Team {
     public:
         static const TerrainTeam TERRAIN_TEAM;
+        virtual TEAM getTeamType() const override;
         virtual std::vector<unsigned int> canBeHit(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeHealed(const std::vector<unsigned int>& entities, Map* map) const override;
         virtual std::vector<unsigned int> canBeDisplaced(const std::vector<unsigned int>& entities, Map* map) const override;
@@ -214,6 +254,7 @@ namespace Game {
         Rect hitbox;
         BehaviourProfile* behaviourProfile;
         Team::TEAM team;
+        uint8_t prefab;
     };
 
     class Action {
@@ -224,8 +265,19 @@ namespace Game {
         const Team* teamChecker;
         Map* ownerMap;
         virtual void applyAction(const std::vector<unsigned int>& entities)=0;
+        virtual void saveFields(BinaryWriter& writer) const=0;
+        virtual bool loadFields(BinaryReader& reader)=0;
     public:
+        enum class ACTION {
+            HIT,
+            HEAL,
+            DISPLACEMENT
+        };
+        static std::unique_ptr<Action> load(BinaryReader& reader, Map* ownerMap_);
         Action();
+        virtual ~Action();
+        virtual ACTION getActionType() const=0;
+        void save(BinaryWriter& writer) const;
         void setTargeting(Targeting* targeting);
         unsigned int getFrameWait();
         unsigned int tick(const std::vector<unsigned int>& entities);
@@ -235,68 +287,176 @@ namespace Game {
         unsigned int damage;
     protected:
         virtual void applyAction(const std::vector<unsigned int>& entities) override;
+        virtual void saveFields(BinaryWriter& writer) const override;
+        virtual bool loadFields(BinaryReader& reader) override;
     public:
         HitAction(unsigned int damage_, Map* ownerMap_, std::unique_ptr<Targeting> targeting_,const Team* teamChecker_);
+        virtual ACTION getActionType() const override;
     };
 
     class HealAction : public Action {
         unsigned int healAmount;
     protected:
         virtual void applyAction(const std::vector<unsigned int>& entities) override;
+        virtual void saveFields(BinaryWriter& writer) const override;
+        virtual bool loadFields(BinaryReader& reader) override;
     public:
         HealAction(unsigned int healAmount_, Map* ownerMap_, std::unique_ptr<Targeting> targeting_, const Team* teamChecker_);
+        virtual ACTION getActionType() const override;
     };
 
     class DisplacementAction : public Action {
         Vector displaceBy;
     protected:
         virtual void applyAction(const std::vector<unsigned int>& entities) override;
+        virtual void saveFields(BinaryWriter& writer) const override;
+        virtual bool loadFields(BinaryReader& reader) override;
     public:
         DisplacementAction(const Vector& displaceBy_, Map* ownerMap_, std::unique_ptr<Targeting> targeting_, const Team* teamChecker_);
+        virtual ACTION getActionType() const override;
+    };
+
+    struct MapStats {
+        unsigned int awakeEntities;
+        unsigned int sleepingEntities;
     };
 
     class Map {
+        friend Entity;
+        friend MapSnapshot;
+        friend RollbackRing;
+        static const unsigned int SLEEP_DELAY = 30;
+        static const int WAKE_DISTANCE = 600;
+        static const unsigned int REORDER_INTERVAL = 120;
+        static const unsigned int REORDER_BUDGET = 2048;
+        static const int MORTON_CELL_SHIFT = 4;
+        static const unsigned int ENTITY_PAGE_SIZE = 64;
+
+        enum class REORDER_PHASE {
+            IDLE,
+            SORTING,
+            APPLYING
+        };
         unsigned int currentMaxID;
-        std::vector<std::unique_ptr<Entity>> entities;
+        unsigned int playerID;
+        std::vector<Entity> entities;
+        std::unordered_map<unsigned int, unsigned int> entityIndices;
         std::vector<std::unique_ptr<Action>> actions;
+        MPSCQueue<std::unique_ptr<Action>> pendingActions;
+        SpatialGrid grid;
+        Kinematics kinematics;
+        CollisionLayer staticLayer;
+        OverlapCache overlaps;
+        std::unordered_map<unsigned int, Shape> entityShapes;
+        EventRing events;
+        std::vector<unsigned int> movedEntities;
+        std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>> behaviourProfiles;
+        std::vector<Rect> staticGeometry;
         Rect playableArea;
+        std::vector<unsigned int> queryResults;
+        std::vector<unsigned int> awakeEntities;
+        std::vector<unsigned int> observerEntities;
+        std::vector<char> dirtyPages;
+        bool allEntitiesDirty;
+        bool reorderingEnabled;
+        REORDER_PHASE reorderPhase;
+        unsigned int ticksSinceReorder;
+        unsigned int reorderWriteIndex;
+        unsigned int reorderReadIndex;
+        unsigned int stateGeneration;
+        MortonSorter mortonSorter;
+        void drainPendingActions();
+        void tickActions();
+        void tickBehaviours();
+        void removeDeadEntities();
+        void insertEntity(unsigned int entityID, const EntityTemplate& entityTemplate);
+        bool eraseEntity(unsigned int entityID);
+        void publishMovedEvents();
+        void updateOverlaps();
+        void wakeEntitiesNearObservers();
+        void wakeEntitiesNear(unsigned int entityID);
+        void updateSleepingEntities();
+        void wakeEntity(unsigned int entityID);
+        void onEntityMoved(unsigned int entityID);
+        void markEntityDirty(const Entity* entity);
+        uint32_t getMortonCode(const Entity& entity) const;
+        void swapEntities(unsigned int first, unsigned int second);
+        void beginReorder();
+        void applyReorder(unsigned int budget);
+        void tickReordering();
     public:
         Map();
         void addActionToQueue(std::unique_ptr<Action> action);
         void tickAndApplyActions();
         Entity* getEntityWithID(unsigned int ID);
         unsigned int createEntity(const EntityTemplate& entityTemplate);
+        unsigned int restoreEntity(unsigned int entityID, const EntityTemplate& entityTemplate);
+        void setBehaviourProfile(unsigned int entityID, std::unique_ptr<BehaviourProfile> profile);
+        const BehaviourProfile* getBehaviourProfile(unsigned int entityID) const;
+        unsigned int createEntities(const Prefab& prefab, unsigned int count, const SpawnPlacement& placement);
+        bool removeEntity(unsigned int entityID);
+        std::vector<unsigned int> getEntitiesInArea(const Rect& area);
         std::vector<unsigned int> getActiveEntityIDs();
+        const std::vector<Entity>& getEntities() const;
         bool spaceEmpty(const Rect& space);
         void setPlayableArea(const Rect& playableArea_);
         bool entityCanMoveToSpace(unsigned int entityID, const Rect& space);
+        void addImpulse(unsigned int entityID, const Vector& displacement);
+        void addStaticGeometry(const Rect& rect);
+        std::vector<Rect> removeStaticGeometryIn(const Rect& region);
+        const std::vector<Rect>& getStaticGeometry() const;
+        bool isAwake(unsigned int entityID);
+        const std::vector<unsigned int>& getAwakeEntityIDs() const;
+        const std::vector<unsigned int>& getOverlapping(unsigned int entityID) const;
+        void setEntityShape(unsigned int entityID, const Shape& localShape);
+        bool hasCustomShape(unsigned int entityID) const;
+        bool getLocalShape(unsigned int entityID, Shape& localShape) const;
+        Shape getEntityShape(unsigned int entityID);
+        const std::vector<OverlapEvent>& getOverlapEvents() const;
+        void recordEvent(MapEvent::TYPE type, unsigned int entityID, int amount);
+        const EventRing& getEvents() const;
+        MapStats getStats() const;
+        uint64_t getStateHash() const;
+        unsigned int getStateGeneration() const;
+        void setEntityReordering(bool enabled);
+        void reorderEntitiesNow();
         unsigned int getPlayerID();
+        void setPlayerID(unsigned int playerID_);
+        void addObserverEntity(unsigned int entityID);
+        void removeObserverEntity(unsigned int entityID);
     };
 
     class Entity {
         friend Map;
+        friend MapSnapshot;
+        friend RollbackRing;
         unsigned int id;
         Rect hitbox;
         std::vector<Buff> buffs;
         EntityStats baseStats;
-        BehaviourProfile* behaviourProfile;
         Map* ownerMap;
         Team::TEAM team;
+        uint8_t prefab;
+        bool awake;
+        bool moved;
+        unsigned int idleTicks;
         Entity(const EntityTemplate& entityTemplate, unsigned int id_, Map* owner);
     public:
-        Entity(const Entity& entity);
-        const unsigned int getID();
-        const Rect getHitbox();
+        const unsigned int getID() const;
+        const Rect getHitbox() const;
         void setHitbox(const Rect& newHitbox);
         void move(const Vector& moveByy);
         void moveWithoutModifier(const Vector& moveBy);
         void addBuff(const Buff& buff);
-        const EntityStats& getBaseStats();
+        const std::vector<Buff>& getBuffs() const;
+        const EntityStats& getBaseStats() const;
         void setStats(const EntityStats& stats);
         EntityStats getFinalStats();
         EntityTemplate getState();
-        Team::TEAM getTeam();
+        Team::TEAM getTeam() const;
         void setTeam(Team::TEAM team_);
+        uint8_t getPrefab() const;
+        const BehaviourProfile* getBehaviourProfile() const;
     };
 
 }
@@ -0,0 +1,39 @@
+#pragma once
+#include "fixedPoint.hpp"
+
+namespace Game {
+
+    struct Vector {
+        int x,y;
+        Vector(int x_a, int y_a);
+        Vector(const Vector& vector);
+        Vector();
+    };
+
+    Vector rotatePoint(Vector point, Vector anchor, int degrees);
+
+    int64_t manhattanDistance(Game::Vector p1, Game::Vector p2);
+
+    struct Rect {
+        Vector topLeft;
+        int width, height;
+        Rect();
+        Rect(const Vector& topLeft_a, unsigned int width_a, unsigned int height_a);
+        bool contains(const Vector& point) const;
+        bool contains(const Rect& rect) const;
+        Game::Vector getCenter() const;
+        bool intersects(const Rect& rect) const;
+        bool operator==(const Rect& rect) const;
+    };
+
+    struct Circle {
+        Vector center;
+        int radius;
+        Circle();
+        Circle(const Vector& center, unsigned int radius);
+        bool intersects(const Rect& rect) const;
+        bool contains(const Vector& point) const;
+        bool contains(const Rect& rect) const;
+    };
+
+}
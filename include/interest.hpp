@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <map>
+#include "gameLogic.hpp"
+
+namespace Game {
+
+    struct Relevance {
+        unsigned int entityID;
+        unsigned int updateInterval;
+        bool isDue(unsigned int tick) const;
+    };
+
+    class InterestManager {
+        struct Observer {
+            Rect viewBox;
+            std::vector<Relevance> relevant;
+            std::vector<unsigned int> entered;
+            std::vector<unsigned int> left;
+        };
+
+        std::map<unsigned int, Observer> observers;
+        unsigned int nextObserverID;
+        std::vector<Relevance> scratch;
+        unsigned int lastCandidateCount;
+
+        void updateObserver(Map& map, Observer& observer);
+    public:
+        static const int ENTER_MARGIN = 200;
+        static const int LEAVE_MARGIN = 400;
+        static const unsigned int NEAR_INTERVAL = 2;
+        static const unsigned int FAR_INTERVAL = 4;
+
+        InterestManager();
+        unsigned int addObserver(const Rect& viewBox);
+        void removeObserver(unsigned int observerID);
+        void setViewBox(unsigned int observerID, const Rect& viewBox);
+        void update(Map& map);
+        void update(Map& map, unsigned int observerID);
+        const std::vector<Relevance>& getRelevant(unsigned int observerID) const;
+        const std::vector<unsigned int>& getEntered(unsigned int observerID) const;
+        const std::vector<unsigned int>& getLeft(unsigned int observerID) const;
+        bool isRelevant(unsigned int observerID, unsigned int entityID) const;
+        unsigned int getLastCandidateCount() const;
+    };
+
+}
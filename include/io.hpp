@@ -4,6 +4,7 @@
 #include <cmath>
 #include <iostream>
 #include "gameLogic.hpp"
+#include "replay.hpp"
 #include "rendering.hpp"
 #include <SFML/Main.hpp>
 #include <SFML/System.hpp>
@@ -28,9 +29,11 @@ namespace IO {
     class PlayerAttackMouseHandler : public MouseHandler {
     protected:
         Game::Map* map;
+        std::vector<Game::Intent>* intents;
         sf::Window* window;
         std::vector<Rendering::Animation>* animations;
-        std::vector<sf::Texture>* attackAnimation;
+        const Rendering::AssetRegistry* registry;
+        unsigned int attackAnimation;
         unsigned int framesSinceAttack;
         unsigned int entityID;
         virtual bool entityValid();
@@ -38,13 +41,14 @@ namespace IO {
         virtual void spawnAttackAction(Game::Vector pos);
         virtual void onMouseEvent(sf::Vector2<int> position, sf::Mouse::Button pressed) override;
     public:
-        PlayerAttackMouseHandler(unsigned int entityID_, Game::Map* map_, Rendering::Camera* camera_, sf::Window* window_, std::vector<Rendering::Animation>* animations_, std::vector<sf::Texture>* attackAnimation_);
+        PlayerAttackMouseHandler(unsigned int entityID_, Game::Map* map_, std::vector<Game::Intent>* intents_, Rendering::Camera* camera_, sf::Window* window_, std::vector<Rendering::Animation>* animations_, const Rendering::AssetRegistry* registry_, unsigned int attackAnimation_);
         virtual void checkForMouseEvents() override;
     };
 
     class GameKeyHandler : public KeyHandler {
     protected:
         Game::Map* map;
+        std::vector<Game::Intent>* intents;
     };
 
     class EntityMovementKeyHandler : public GameKeyHandler {
@@ -54,7 +58,7 @@ namespace IO {
         virtual void onKeyPress(sf::Keyboard::Key pressed) override;
         bool entityValid();
     public:
-        EntityMovementKeyHandler(const std::map<sf::Keyboard::Key, Game::Vector>& keyMovementMap_, Game::Map* map_, unsigned int entityID_);
+        EntityMovementKeyHandler(const std::map<sf::Keyboard::Key, Game::Vector>& keyMovementMap_, Game::Map* map_, std::vector<Game::Intent>* intents_, unsigned int entityID_);
         virtual void checkForKeyPress() override;
         unsigned int getHandlingEntityID();
     };
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "geometry.hpp"
+
+namespace Game {
+
+    class Map;
+
+    class Kinematics {
+    public:
+        struct Motion {
+            int32_t velocityX;
+            int32_t velocityY;
+            int32_t impulseX;
+            int32_t impulseY;
+            int32_t remainderX;
+            int32_t remainderY;
+        };
+    private:
+        static const unsigned int SUBSTEPS = 4;
+        static const int32_t REST_THRESHOLD = Fixed::ONE / 8;
+
+        std::vector<unsigned int> entityIDs;
+        std::vector<int32_t> velocityX;
+        std::vector<int32_t> velocityY;
+        std::vector<int32_t> impulseX;
+        std::vector<int32_t> impulseY;
+        std::vector<int32_t> remainderX;
+        std::vector<int32_t> remainderY;
+        std::vector<int32_t> stepX;
+        std::vector<int32_t> stepY;
+        std::unordered_map<unsigned int, unsigned int> slots;
+        Fixed damping;
+
+        void applyImpulses();
+        void computeSubstep();
+        void resolveSubstep(Map* map);
+        void applyDamping();
+    public:
+        Kinematics();
+        void add(unsigned int entityID);
+        void remove(unsigned int entityID);
+        void addImpulse(unsigned int entityID, Fixed x, Fixed y);
+        void setVelocity(unsigned int entityID, Fixed x, Fixed y);
+        Motion getMotion(unsigned int entityID) const;
+        void setMotion(unsigned int entityID, const Motion& motion);
+        void clear();
+        void reserve(unsigned int entityCount);
+        void build(const std::vector<unsigned int>& entityIDs_, const std::vector<Motion>& motions);
+        Fixed getDamping() const;
+        bool isMoving(unsigned int entityID) const;
+        unsigned int getCount() const;
+        void integrate(Map* map);
+    };
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "geometry.hpp"
+
+namespace Game {
+
+    struct MapEvent {
+        enum class TYPE {
+            DAMAGED,
+            HEALED,
+            SPAWNED,
+            DIED,
+            REMOVED,
+            MOVED
+        };
+        TYPE type;
+        unsigned int entityID;
+        int amount;
+        Rect hitbox;
+    };
+
+    class EventRing {
+        static const unsigned int CAPACITY = 1 << 14;
+        std::vector<MapEvent> events;
+        uint64_t head;
+    public:
+        EventRing();
+        void push(const MapEvent& event);
+        uint64_t getHead() const;
+
+        template <typename Consumer>
+        bool read(uint64_t& cursor, Consumer consume) const {
+            bool complete = true;
+            if (head - cursor > CAPACITY) {
+                cursor = head - CAPACITY;
+                complete = false;
+            }
+            for (; cursor < head; cursor++) {
+                consume(events[cursor & (CAPACITY - 1)]);
+            }
+            return complete;
+        }
+    };
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "gameLogic.hpp"
+#include "kinematics.hpp"
+
+namespace Game {
+
+    class MapSnapshot {
+        static const uint32_t MAGIC = 0x50414d47;
+        static const uint16_t VERSION = 1;
+
+        enum class SECTION : uint32_t {
+            META = 0x4154454d,
+            ENTITIES = 0x53544e45,
+            BUFFS = 0x53465542,
+            GEOMETRY = 0x4d4f4547,
+            SHAPES = 0x50414853,
+            BEHAVIOURS = 0x52564842,
+            ACTIONS = 0x4e544341
+        };
+
+        struct SectionHeader {
+            uint32_t tag;
+            uint32_t count;
+            uint32_t size;
+            uint32_t checksum;
+        };
+
+        struct EntityRow {
+            uint32_t id;
+            int32_t x;
+            int32_t y;
+            int32_t width;
+            int32_t height;
+            int32_t stats[EntityStats::STAT_COUNT];
+            int32_t statModifiers[EntityStats::STAT_MOD_COUNT];
+            uint32_t buffStart;
+            uint32_t buffCount;
+            uint32_t idleTicks;
+            Kinematics::Motion motion;
+            uint8_t team;
+            uint8_t awake;
+            uint8_t hasBehaviour;
+            uint8_t prefab;
+        };
+
+        struct BuffRow {
+            int32_t stats[EntityStats::STAT_COUNT];
+            int32_t statModifiers[EntityStats::STAT_MOD_COUNT];
+            uint32_t framesLeft;
+            uint32_t framesMax;
+            uint32_t frameInterval;
+        };
+
+        struct Section {
+            SECTION tag;
+            uint32_t count;
+            const char* data;
+            uint32_t size;
+        };
+
+        struct LoadedMap {
+            uint32_t currentMaxID;
+            Rect playableArea;
+            bool reorderingEnabled;
+            uint32_t playerID;
+            std::vector<Entity> entities;
+            std::unordered_map<unsigned int, unsigned int> entityIndices;
+            std::vector<unsigned int> entityIDs;
+            std::vector<Rect> hitboxes;
+            std::vector<Kinematics::Motion> motions;
+            std::vector<unsigned int> awakeEntities;
+            std::vector<Rect> staticGeometry;
+            std::unordered_map<unsigned int, Shape> entityShapes;
+            std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>> behaviourProfiles;
+            std::vector<std::unique_ptr<Action>> actions;
+        };
+
+        static void writeSection(BinaryWriter& writer, SECTION tag, uint32_t count, const std::vector<char>& payload);
+        static void packStats(const EntityStats& stats, int32_t* values, int32_t* modifiers);
+        static EntityStats unpackStats(const int32_t* values, const int32_t* modifiers);
+        static const Section* findSection(const std::vector<Section>& sections, SECTION tag);
+        static void reset(Map& map);
+        static bool loadMeta(LoadedMap& loaded, const Section& section);
+        static bool loadEntities(Map& map, LoadedMap& loaded, const Section& entitySection, const Section* buffSection);
+        static bool loadGeometry(LoadedMap& loaded, const Section& section);
+        static bool loadBehaviours(Map& map, LoadedMap& loaded, const Section& section);
+        static bool loadShapes(LoadedMap& loaded, const Section& section);
+        static bool loadActions(Map& map, LoadedMap& loaded, const Section& section);
+        static void commit(Map& map, LoadedMap& loaded);
+    public:
+        static void save(Map& map, std::vector<char>& out);
+        static bool load(Map& map, const char* data, size_t size);
+        static bool saveToFile(Map& map, const std::string& path);
+        static bool loadFromFile(Map& map, const std::string& path);
+    };
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+namespace Game {
+
+    class MappedFile {
+        const char* data;
+        size_t size;
+#ifdef _WIN32
+        void* fileHandle;
+        void* mappingHandle;
+#else
+        int descriptor;
+#endif
+    public:
+        MappedFile();
+        ~MappedFile();
+        MappedFile(const MappedFile& copying) = delete;
+        MappedFile& operator=(const MappedFile& copying) = delete;
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const;
+        const char* getData() const;
+        size_t getSize() const;
+    };
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+namespace Game {
+
+    uint32_t mortonCode(uint32_t x, uint32_t y);
+
+    class MortonSorter {
+    public:
+        struct Key {
+            uint32_t code;
+            unsigned int entityID;
+        };
+    private:
+        std::vector<Key> keys;
+        std::vector<Key> scratch;
+        unsigned int width;
+        unsigned int runStart;
+        unsigned int left, leftEnd, right, rightEnd, output;
+        bool mergingRun;
+        bool sorting;
+
+        void startRun();
+    public:
+        MortonSorter();
+        void begin(std::vector<Key>& keys_);
+        bool step(unsigned int budget);
+        bool isSorting() const;
+        const std::vector<Key>& getOrder() const;
+    };
+
+}
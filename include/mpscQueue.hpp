@@ -0,0 +1,169 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+namespace Game {
+
+    template <typename T>
+    class MPSCQueue {
+        static const unsigned int CHUNK_SIZE = 64;
+
+        struct Chunk {
+            T items[CHUNK_SIZE];
+            std::atomic<unsigned int> published;
+            std::atomic<Chunk*> next;
+            Chunk() {
+                published.store(0, std::memory_order_relaxed);
+                next.store(NULL, std::memory_order_relaxed);
+            }
+        };
+
+        struct Producer {
+            std::thread::id owner;
+            unsigned int order;
+            Chunk* tail;
+            Chunk* head;
+            unsigned int consumed;
+            Producer* next;
+        };
+
+        struct ProducerCache {
+            unsigned long long queueSerial;
+            Producer* producer;
+        };
+
+        static std::atomic<unsigned long long> nextSerial;
+
+        unsigned long long serial;
+        std::atomic<Producer*> producers;
+        std::atomic<unsigned int> producerCount;
+        std::vector<Producer*> drainOrder;
+
+        Producer* findProducer(std::thread::id owner) {
+            for (Producer* producer = producers.load(std::memory_order_acquire); producer; producer = producer->next) {
+                if (producer->owner == owner) {
+                    return producer;
+                }
+            }
+            return NULL;
+        }
+
+        Producer* registerProducer(std::thread::id owner) {
+            Producer* producer = new Producer();
+            producer->owner = owner;
+            producer->order = producerCount.fetch_add(1, std::memory_order_relaxed);
+            producer->tail = new Chunk();
+            producer->head = producer->tail;
+            producer->consumed = 0;
+            producer->next = producers.load(std::memory_order_relaxed);
+            while (!producers.compare_exchange_weak(producer->next, producer, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return producer;
+        }
+
+        Producer* getProducer() {
+            static thread_local ProducerCache cache = { 0, NULL };
+            if (cache.queueSerial == serial && cache.producer) {
+                return cache.producer;
+            }
+            std::thread::id owner = std::this_thread::get_id();
+            Producer* producer = findProducer(owner);
+            if (!producer) {
+                producer = registerProducer(owner);
+            }
+            cache.queueSerial = serial;
+            cache.producer = producer;
+            return producer;
+        }
+
+        void refreshDrainOrder() {
+            if (drainOrder.size() == producerCount.load(std::memory_order_acquire)) {
+                return;
+            }
+            drainOrder.clear();
+            for (Producer* producer = producers.load(std::memory_order_acquire); producer; producer = producer->next) {
+                drainOrder.push_back(producer);
+            }
+            std::sort(drainOrder.begin(), drainOrder.end(), [](const Producer* first, const Producer* second) {
+                return first->order < second->order;
+            });
+        }
+
+    public:
+        MPSCQueue() {
+            serial = nextSerial.fetch_add(1, std::memory_order_relaxed) + 1;
+            producers.store(NULL, std::memory_order_relaxed);
+            producerCount.store(0, std::memory_order_relaxed);
+        }
+
+        MPSCQueue(const MPSCQueue& copying) = delete;
+        MPSCQueue& operator=(const MPSCQueue& copying) = delete;
+
+        ~MPSCQueue() {
+            Producer* producer = producers.load(std::memory_order_acquire);
+            while (producer) {
+                Chunk* chunk = producer->head;
+                while (chunk) {
+                    Chunk* nextChunk = chunk->next.load(std::memory_order_acquire);
+                    delete chunk;
+                    chunk = nextChunk;
+                }
+                Producer* nextProducer = producer->next;
+                delete producer;
+                producer = nextProducer;
+            }
+        }
+
+        void push(T item) {
+            Producer* producer = getProducer();
+            Chunk* tail = producer->tail;
+            unsigned int index = tail->published.load(std::memory_order_relaxed);
+            if (index == CHUNK_SIZE) {
+                Chunk* newChunk = new Chunk();
+                tail->next.store(newChunk, std::memory_order_release);
+                producer->tail = newChunk;
+                tail = newChunk;
+                index = 0;
+            }
+            tail->items[index] = std::move(item);
+            tail->published.store(index + 1, std::memory_order_release);
+        }
+
+        template <typename Consumer>
+        unsigned int drain(Consumer consume) {
+            refreshDrainOrder();
+            unsigned int drained = 0;
+            for (Producer* producer : drainOrder) {
+                while (true) {
+                    Chunk* head = producer->head;
+                    unsigned int published = head->published.load(std::memory_order_acquire);
+                    while (producer->consumed < published) {
+                        consume(std::move(head->items[producer->consumed]));
+                        head->items[producer->consumed] = T();
+                        producer->consumed++;
+                        drained++;
+                    }
+                    Chunk* nextChunk = head->next.load(std::memory_order_acquire);
+                    if (producer->consumed < CHUNK_SIZE || !nextChunk) {
+                        break;
+                    }
+                    producer->head = nextChunk;
+                    producer->consumed = 0;
+                    delete head;
+                }
+            }
+            return drained;
+        }
+
+        unsigned int getProducerCount() const {
+            return producerCount.load(std::memory_order_acquire);
+        }
+    };
+
+    template <typename T>
+    std::atomic<unsigned long long> MPSCQueue<T>::nextSerial(0);
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "gameLogic.hpp"
+#include "serialization.hpp"
+#include "replay.hpp"
+#include "interest.hpp"
+
+namespace Net {
+
+    enum class PACKET : uint8_t {
+        CONNECT,
+        WELCOME,
+        INPUT,
+        SNAPSHOT,
+        DISCONNECT
+    };
+
+    struct EntityState {
+        uint32_t id;
+        int32_t x;
+        int32_t y;
+        uint16_t width;
+        uint16_t height;
+        uint16_t hp;
+        uint8_t team;
+    };
+
+    struct WorldState {
+        uint32_t tick;
+        std::vector<EntityState> entities;
+        const EntityState* find(uint32_t id) const;
+    };
+
+    struct InputFrame {
+        uint32_t sequence;
+        std::vector<Game::Intent> intents;
+    };
+
+    struct InputPacket {
+        uint32_t ackedTick;
+        bool hasAck;
+        std::vector<InputFrame> frames;
+    };
+
+    EntityState quantiseEntity(const Game::Entity& entity);
+    void captureWorldState(const Game::Map& map, uint32_t tick, WorldState& state);
+    void captureRelevantState(Game::Map& map, uint32_t tick, const std::vector<Game::Relevance>& relevant, const WorldState* lastSent, WorldState& state);
+    void trimWorldState(WorldState& state, const Game::Vector& center, std::size_t count);
+
+    void writeSnapshot(Game::BinaryWriter& writer, const WorldState& current, const WorldState* base);
+    bool readSnapshotHeader(Game::BinaryReader& reader, uint32_t& tick, bool& hasBase, uint32_t& baseTick);
+    bool readSnapshotBody(Game::BinaryReader& reader, const WorldState* base, WorldState& out);
+
+    void writeInput(Game::BinaryWriter& writer, const InputPacket& input);
+    bool readInput(Game::BinaryReader& reader, InputPacket& input);
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <map>
+#include <atomic>
+#include <random>
+#include "netProtocol.hpp"
+
+namespace Net {
+
+    class GameServer {
+        static const unsigned int HISTORY_SIZE = 32;
+        static const unsigned int REDUNDANT_FRAMES = 3;
+        static const unsigned int MAX_INTENTS_PER_FRAME = 4;
+        static const unsigned int MAX_INTENTS_PER_TICK = MAX_INTENTS_PER_FRAME * REDUNDANT_FRAMES;
+
+        struct Client {
+            sf::IpAddress address;
+            unsigned short port;
+            unsigned int entityID;
+            unsigned int observerID;
+            std::vector<WorldState> sent;
+            uint32_t lastSequence;
+            uint32_t ackedTick;
+            bool hasAck;
+            uint32_t lastAttackTick;
+            bool hasAttacked;
+            unsigned int tickIntents;
+            float lastHeard;
+            uint64_t bytesSent;
+            uint64_t bytesReceived;
+            uint64_t intervalBytesSent;
+        };
+
+        Game::Map map;
+        sf::UdpSocket socket;
+        unsigned short port;
+        unsigned int tickRate;
+        uint32_t currentTick;
+        Game::InterestManager interest;
+        std::map<std::pair<uint32_t, unsigned short>, Client> clients;
+        sf::Clock uptime;
+        std::vector<char> datagram;
+        std::vector<Game::Intent> pendingIntents;
+        float intervalCPU;
+        float intervalMaxCPU;
+        unsigned int intervalTicks;
+        unsigned int oversizedSnapshots;
+        uint64_t intervalRelevant;
+
+        void receivePackets();
+        void handlePacket(const sf::IpAddress& address, unsigned short port, const char* data, std::size_t size);
+        void addClient(const sf::IpAddress& address, unsigned short port);
+        void removeClient(std::map<std::pair<uint32_t, unsigned short>, Client>::iterator client);
+        void removeTimedOutClients();
+        bool acceptIntent(Client& client, Game::Intent& intent);
+        void updateInterest();
+        void sendSnapshots();
+        void report();
+    public:
+        GameServer(unsigned short port_, unsigned int tickRate_);
+        bool start();
+        void tick();
+        void run(float seconds, const std::atomic<bool>* stopping);
+        unsigned int getClientCount() const;
+        uint32_t getCurrentTick() const;
+    };
+
+    class BotClient {
+        static const unsigned int HISTORY_SIZE = 32;
+        static const unsigned int REDUNDANT_FRAMES = 3;
+
+        sf::UdpSocket socket;
+        sf::IpAddress serverAddress;
+        unsigned short serverPort;
+        std::mt19937 random;
+        bool connected;
+        unsigned int entityID;
+        unsigned int tickRate;
+        uint32_t sequence;
+        uint32_t latestTick;
+        bool hasSnapshot;
+        WorldState history[HISTORY_SIZE];
+        std::vector<InputFrame> recentFrames;
+        std::vector<char> datagram;
+        uint64_t bytesSent;
+        uint64_t bytesReceived;
+        unsigned int snapshotsReceived;
+        unsigned int snapshotsDropped;
+
+        void receivePackets();
+        void handleSnapshot(const char* data, std::size_t size);
+        void sendInput();
+    public:
+        BotClient(const sf::IpAddress& serverAddress_, unsigned short serverPort_, unsigned int seed);
+        void run(const std::atomic<bool>* stopping);
+        bool isConnected() const;
+        unsigned int getEntityID() const;
+        uint64_t getBytesSent() const;
+        uint64_t getBytesReceived() const;
+        unsigned int getSnapshotsReceived() const;
+        unsigned int getSnapshotsDropped() const;
+        std::size_t getVisibleEntityCount() const;
+    };
+
+}
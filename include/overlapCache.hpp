@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+#include "geometry.hpp"
+#include "spatialGrid.hpp"
+
+namespace Game {
+
+    struct OverlapEvent {
+        enum class TYPE {
+            ENTER,
+            STAY,
+            EXIT
+        };
+        TYPE type;
+        unsigned int first;
+        unsigned int second;
+    };
+
+    class OverlapCache {
+        std::unordered_map<unsigned int, std::vector<unsigned int>> partners;
+        std::unordered_map<uint64_t, unsigned int> pairStamps;
+        std::vector<unsigned int> moved;
+        std::unordered_set<unsigned int> movedSet;
+        std::vector<OverlapEvent> events;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> current;
+        std::vector<unsigned int> exited;
+        unsigned int stamp;
+        unsigned int pairTests;
+
+        static uint64_t getPairKey(unsigned int first, unsigned int second);
+        void pushEvent(OverlapEvent::TYPE type, unsigned int first, unsigned int second);
+        void addPair(unsigned int first, unsigned int second);
+        void removePair(unsigned int first, unsigned int second);
+        void refreshEntity(unsigned int entityID);
+    public:
+        OverlapCache();
+        void beginTick();
+        void markMoved(unsigned int entityID);
+        void markMoved(const std::vector<unsigned int>& entityIDs);
+        void remove(unsigned int entityID);
+        void clear();
+
+        template <typename BoundsLookup>
+        void update(SpatialGrid& grid, BoundsLookup getBounds) {
+            stamp++;
+            for (unsigned int entityID : moved) {
+                Rect bounds;
+                if (!getBounds(entityID, bounds)) {
+                    continue;
+                }
+                candidates.clear();
+                current.clear();
+                grid.query(bounds, candidates);
+                for (unsigned int candidate : candidates) {
+                    Rect candidateBounds;
+                    if (candidate == entityID || !getBounds(candidate, candidateBounds)) {
+                        continue;
+                    }
+                    pairTests++;
+                    if (bounds.intersects(candidateBounds)) {
+                        current.push_back(candidate);
+                    }
+                }
+                std::sort(current.begin(), current.end());
+                refreshEntity(entityID);
+            }
+            moved.clear();
+            movedSet.clear();
+        }
+
+        const std::vector<unsigned int>& getOverlapping(unsigned int entityID) const;
+        bool overlapping(unsigned int first, unsigned int second) const;
+        const std::vector<OverlapEvent>& getEvents() const;
+        unsigned int getPairCount() const;
+        unsigned int getPairTestCount() const;
+    };
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "gameLogic.hpp"
+
+namespace Game {
+
+    struct Prefab {
+        std::string name;
+        std::string textureSet;
+        EntityTemplate entityTemplate;
+        bool hasBehaviour;
+        BehaviourProfile::PROFILE behaviour;
+    };
+
+    struct SpawnPlacement {
+        enum class TYPE {
+            GRID,
+            SCATTER
+        };
+        TYPE type;
+        Rect area;
+        unsigned int columns;
+        Vector spacing;
+        uint32_t seed;
+        static SpawnPlacement grid(const Vector& origin, unsigned int columns, const Vector& spacing);
+        static SpawnPlacement scatter(const Rect& area, uint32_t seed);
+        Vector getPosition(unsigned int index, uint32_t& state) const;
+    };
+
+    class PrefabLibrary {
+        std::vector<Prefab> prefabs;
+        std::unordered_map<std::string, unsigned int> indices;
+        std::string lastError;
+
+        bool parseLine(const std::string& line, Prefab& prefab);
+    public:
+        static const unsigned int MAX_PREFABS = 255;
+        bool load(const std::string& text);
+        bool loadFromFile(const std::string& path);
+        const Prefab* find(const std::string& name) const;
+        const Prefab* get(uint8_t prefabID) const;
+        unsigned int getCount() const;
+        const std::string& getLastError() const;
+    };
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 #include "gameLogic.hpp"
+#include "snapshotRing.hpp"
+#include "assetRegistry.hpp"
 #include <SFML/Main.hpp>
 #include <SFML/Graphics.hpp>
+#include <atomic>
 
 namespace Rendering {
 
@@ -12,6 +15,7 @@ namespace Rendering {
         void setPos(const Game::Vector& newPos);
         void setSize(const Game::Vector& newSize);
         void setViewBox(const Game::Rect& newViewBox);
+        Game::Rect getViewBox() const;
         void centerOn(const Game::Vector& centeringOn, const sf::Window& window);
         sf::Vector2<float> translate(const Game::Vector& gameCoords);
         Game::Vector reverseTranslate(const sf::Vector2<float>& displayCoords);
@@ -20,7 +24,9 @@ namespace Rendering {
     };
 
     class Animation {
-        std::vector<sf::Texture>* animationSet;
+        const AssetRegistry* registry;
+        unsigned int animationSet;
+        unsigned int sequence;
         Camera* camera;
         sf::Window* window;
         sf::Sprite sprite;
@@ -34,13 +40,70 @@ namespace Rendering {
         void scaleSprite();
         void updateSprite();
     public:
-        Animation(std::vector<sf::Texture>* animationSet_, Camera* camera_, sf::Window* window_, Game::Rect renderbox_, unsigned int frameDelay_);
+        Animation(const AssetRegistry* registry_, unsigned int animationSet_, Camera* camera_, sf::Window* window_, Game::Rect renderbox_, unsigned int frameDelay_);
         void tick();
         const sf::Sprite& getSprite();
+        unsigned int getAnimationSet() const;
         bool doneAnimating();
         void setCentered(bool centered);
     };
 
+    class RenderSnapshot {
+        std::vector<EntitySnapshot> entityStorage;
+        std::vector<Game::MapEvent> eventStorage;
+        const EntitySnapshot* entities;
+        unsigned int entityCount;
+        const Game::MapEvent* events;
+        unsigned int eventCount;
+        bool eventsComplete;
+        Game::MapStats mapStats;
+        unsigned int tick;
+        unsigned int playerID;
+        const Game::Map* syncedMap;
+        uint64_t syncedCursor;
+        unsigned int syncedGeneration;
+        std::vector<unsigned int> awakeIDs;
+        std::vector<unsigned int> changedIDs;
+        std::vector<unsigned int> removedIDs;
+        std::vector<EntitySnapshot> addedEntities;
+
+        static void fillEntity(EntitySnapshot& entitySnapshot, const Game::Entity& entity, bool awake);
+        EntitySnapshot* findStoredEntity(unsigned int entityID);
+        void rebuildEntities(Game::Map& map);
+        bool updateEntities(Game::Map& map);
+    public:
+        RenderSnapshot();
+        RenderSnapshot(const RenderSnapshot& copying) = delete;
+        RenderSnapshot& operator=(const RenderSnapshot& copying) = delete;
+        void capture(Game::Map& map, unsigned int tick_, uint64_t& eventCursor);
+        void view(const SnapshotRing& ring, const SnapshotSlot& slot, bool eventsContiguous);
+        void clear();
+        const EntitySnapshot* findEntity(unsigned int entityID) const;
+        const EntitySnapshot* getEntities() const;
+        unsigned int getEntityCount() const;
+        const Game::MapEvent* getEvents() const;
+        unsigned int getEventCount() const;
+        bool hasCompleteEvents() const;
+        const Game::MapStats& getMapStats() const;
+        unsigned int getTick() const;
+        unsigned int getPlayerID() const;
+    };
+
+    class SnapshotBuffer {
+        static const unsigned int INDEX_MASK = 3;
+        static const unsigned int FRESH = 4;
+        RenderSnapshot snapshots[3];
+        std::atomic<unsigned int> middle;
+        unsigned int back;
+        unsigned int front;
+    public:
+        SnapshotBuffer();
+        RenderSnapshot& getBack();
+        void publish();
+        const RenderSnapshot& acquireFront();
+        const RenderSnapshot& getFront() const;
+    };
+
     class EntityEventParser {
     public:
         enum class STATE {
@@ -49,27 +112,36 @@ namespace Rendering {
         };
     private:
         unsigned int entityID;
-        Game::Map* map;
-        Game::EntityTemplate lastState;
+        Game::Rect hitbox;
+        bool alive;
+        bool hitPending;
         STATE currentState;
     public:
-        EntityEventParser(Game::Map* map_, unsigned int entityID_);
+        EntityEventParser(const SnapshotBuffer* snapshots_, unsigned int entityID_);
         EntityEventParser(const EntityEventParser& copying);
         EntityEventParser();
+        void onEvent(const Game::MapEvent& event);
         void updateCurrentState();
-        void grabEntityState();
         bool entityValid() const;
         STATE getEntityState();
         Game::Rect getEntityHitbox();
-        unsigned int getEntityID();
+        unsigned int getEntityID() const;
         void setEntityID(unsigned int newID);
     };
 
+    struct StateSequences {
+        unsigned int idle;
+        unsigned int hit;
+        StateSequences();
+    };
+
     class EntityRenderer {
-        static const std::map<EntityEventParser::STATE, std::string> stateToTextureName;
         sf::Sprite sprite;
-        std::map<std::string, std::vector<sf::Texture>>* textureSet;
-        std::vector<sf::Texture>* currentTextureSet;
+        const AssetRegistry* registry;
+        unsigned int textureSet;
+        unsigned int idleSequence;
+        unsigned int hitSequence;
+        unsigned int currentSequence;
         EntityEventParser entityEventParser;
         Camera* camera;
         sf::Window* window;
@@ -88,10 +160,12 @@ namespace Rendering {
         void tickFrameDelayCounter();
     public:
         static const std::vector<std::string> stateTextureNames;
-        EntityRenderer(const EntityEventParser& entityEventParser_, Rendering::Camera* camera_, sf::Window* window, std::map<std::string, std::vector<sf::Texture>>* textureSet_, unsigned int frameDelay);
+        EntityRenderer(const EntityEventParser& entityEventParser_, Rendering::Camera* camera_, sf::Window* window, const AssetRegistry* registry_, unsigned int textureSet_, const StateSequences& sequences, unsigned int frameDelay);
         void updateEntitySprite();
+        void onEvent(const Game::MapEvent& event);
         void setCamera(Camera* camera_);
         const EntityEventParser& getEntityEventParser();
+        unsigned int getTextureSet() const;
         Camera* getCamera();
         const sf::Sprite& getSprite();
     };
@@ -110,7 +184,9 @@ namespace Rendering {
     };
 
     class AbsoluteBackground {
-        std::vector<sf::Texture>* backgroundFrames;
+        const AssetRegistry* registry;
+        unsigned int backgroundSet;
+        unsigned int sequence;
         sf::Sprite sprite;
         sf::Window* window;
         unsigned int currentFrame;
@@ -125,8 +201,9 @@ namespace Rendering {
     public:
         AbsoluteBackground();
         AbsoluteBackground(const AbsoluteBackground& copying);
-        AbsoluteBackground(std::vector<sf::Texture>* backgroundFrames_, sf::Window* window_, unsigned int frameDelay_);
-        void setTextureSet(std::vector<sf::Texture>* backgroundFrames_);
+        AbsoluteBackground(const AssetRegistry* registry_, unsigned int backgroundSet_, sf::Window* window_, unsigned int frameDelay_);
+        void setTextureSet(unsigned int backgroundSet_);
+        unsigned int getTextureSet() const;
         void setWindow(sf::Window* window_);
         void setFrameDelay(unsigned int frameDelay_);
         void setLooping(bool looping_);
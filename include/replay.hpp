@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "gameLogic.hpp"
+#include "serialization.hpp"
+
+namespace Game {
+
+    struct Intent {
+        enum class TYPE {
+            MOVE,
+            ATTACK
+        };
+        static const int ATTACK_HALF_ANGLE = 30;
+        Intent();
+        Intent(TYPE type_, unsigned int entityID_, const Vector& vector_);
+        bool operator==(const Intent& other) const;
+        bool operator!=(const Intent& other) const;
+        void apply(Map& map) const;
+        TYPE type;
+        unsigned int entityID;
+        Vector vector;
+    };
+
+    struct ReplayResult {
+        bool loaded;
+        unsigned int ticksPlayed;
+        unsigned int ticksRecorded;
+        int firstDivergentTick;
+        double milliseconds;
+    };
+
+    class ReplayRecorder {
+        std::vector<char> initialSnapshot;
+        BinaryWriter intentStream;
+        std::vector<uint64_t> hashes;
+        uint32_t tickCount;
+        std::vector<Intent> runIntents;
+        uint32_t runLength;
+        Vector lastVector;
+        bool recording;
+        void flushRun();
+    public:
+        ReplayRecorder();
+        void begin(Map& map);
+        void recordTick(const std::vector<Intent>& intents, const Map& map);
+        bool save(const std::string& path);
+        bool isRecording() const;
+        unsigned int getTickCount() const;
+    };
+
+    class ReplayPlayer {
+        std::vector<char> contents;
+        const char* snapshot;
+        uint32_t snapshotSize;
+        const char* intentStream;
+        uint32_t intentStreamSize;
+        const char* hashes;
+        uint32_t tickCount;
+    public:
+        ReplayPlayer();
+        bool open(const std::string& path);
+        ReplayResult play(Map& map);
+        unsigned int getTickCount() const;
+    };
+
+}
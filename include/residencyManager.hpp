@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "assetLoader.hpp"
+#include "assetRegistry.hpp"
+
+namespace Rendering {
+
+    class ResidencyManager {
+        struct Entry {
+            unsigned int handle;
+            unsigned int references;
+            unsigned long long lastUsed;
+            unsigned long long lastMissed;
+            bool resident;
+            bool evicted;
+        };
+
+        AssetLoader* loader;
+        size_t budget;
+        float prefetchMargin;
+        sf::FloatRect view;
+        sf::FloatRect prefetchArea;
+        unsigned long long frame;
+        std::vector<Entry> entries;
+        std::vector<unsigned int> setEntries;
+        size_t residentBytes;
+        unsigned int evictions;
+        unsigned int missStalls;
+
+        void use(Entry& entry, const sf::FloatRect& bounds);
+        static bool isColder(const Entry& first, const Entry& second);
+        void evictColdEntries();
+    public:
+        ResidencyManager();
+        void setLoader(AssetLoader* loader_);
+        void setBudget(size_t budget_);
+        void setPrefetchMargin(float prefetchMargin_);
+        void trackSet(unsigned int set, unsigned int handle);
+        void beginFrame(const sf::FloatRect& view_);
+        void useSet(unsigned int set, const sf::FloatRect& bounds);
+        void endFrame();
+        size_t getBudget() const;
+        size_t getResidentBytes() const;
+        unsigned int getTrackedCount() const;
+        unsigned int getEvictionCount() const;
+        unsigned int getMissStallCount() const;
+    };
+
+}
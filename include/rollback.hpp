@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "gameLogic.hpp"
+#include "kinematics.hpp"
+#include "mortonOrder.hpp"
+
+namespace Game {
+
+    class RollbackRing {
+    public:
+        static const unsigned int CAPACITY = 16;
+    private:
+        struct Page {
+            std::vector<Entity> entities;
+            std::vector<Kinematics::Motion> motions;
+            std::vector<char> behaviours;
+            unsigned int behaviourCount;
+        };
+
+        struct Frame {
+            unsigned int tick;
+            unsigned int entityCount;
+            unsigned int currentMaxID;
+            std::vector<std::shared_ptr<const Page>> pages;
+            std::vector<unsigned int> awakeEntities;
+            std::unordered_map<unsigned int, Shape> entityShapes;
+            std::vector<char> actions;
+            unsigned int actionCount;
+            uint8_t reorderPhase;
+            unsigned int ticksSinceReorder;
+            unsigned int reorderWriteIndex;
+            unsigned int reorderReadIndex;
+            MortonSorter mortonSorter;
+        };
+
+        std::vector<Frame> frames;
+        unsigned int newest;
+        unsigned int frameCount;
+        unsigned int copiedPages;
+        unsigned int restoredPages;
+
+        static std::shared_ptr<const Page> copyPage(Map& map, unsigned int pageIndex);
+        static bool pageDirty(const Map& map, unsigned int pageIndex);
+        int findFrame(unsigned int tick) const;
+        static bool restoreBehaviours(Map& map, const Page& page);
+        bool restorePages(Map& map, const Frame& target);
+        bool restoreQueues(Map& map, const Frame& target);
+    public:
+        RollbackRing();
+        void capture(Map& map, unsigned int tick);
+        bool restore(Map& map, unsigned int tick);
+        bool hasTick(unsigned int tick) const;
+        void clear();
+        unsigned int getFrameCount() const;
+        unsigned int getLastCopiedPages() const;
+        unsigned int getLastRestoredPages() const;
+    };
+
+}
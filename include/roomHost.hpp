@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "gameLogic.hpp"
+#include "replay.hpp"
+#include "mpscQueue.hpp"
+
+namespace Game {
+
+    class RoomHost;
+
+    struct RoomStats {
+        unsigned int roomID;
+        unsigned int worker;
+        unsigned int ticks;
+        unsigned int skippedTicks;
+        unsigned int overruns;
+        double averageMilliseconds;
+        double maxMilliseconds;
+        bool throttled;
+    };
+
+    class Room {
+        friend RoomHost;
+        unsigned int id;
+        unsigned int worker;
+        Map map;
+        MPSCQueue<Intent> intents;
+        unsigned int ticks;
+        unsigned int skippedTicks;
+        unsigned int overruns;
+        unsigned int consecutiveOverruns;
+        double averageMilliseconds;
+        double maxMilliseconds;
+        bool throttled;
+
+        void step(double budgetMilliseconds);
+    public:
+        Room(unsigned int id_);
+        unsigned int getID() const;
+        Map& getMap();
+        void queueIntent(const Intent& intent);
+        RoomStats getStats() const;
+    };
+
+    class RoomHost {
+        static const unsigned int OVERRUNS_TO_THROTTLE = 30;
+        static const unsigned int THROTTLE_DIVISOR = 2;
+
+        struct Worker {
+            std::thread thread;
+            std::vector<Room*> rooms;
+            double frameMilliseconds;
+            unsigned int overruns;
+        };
+
+        std::vector<std::unique_ptr<Room>> rooms;
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::mutex frameMutex;
+        std::condition_variable frameStarted;
+        std::condition_variable frameFinished;
+        unsigned int frame;
+        unsigned int busyWorkers;
+        bool stopping;
+        unsigned int tickRate;
+        unsigned int nextRoomID;
+        double roomBudgetMilliseconds;
+        unsigned int migrations;
+
+        void runWorker(Worker* worker);
+        void tickWorker(Worker* worker, unsigned int currentFrame);
+        double getWorkerLoad(const Worker* worker) const;
+        void rebalance();
+        void updateThrottling();
+    public:
+        RoomHost(unsigned int workerCount, unsigned int tickRate_);
+        ~RoomHost();
+        RoomHost(const RoomHost& copying) = delete;
+        RoomHost& operator=(const RoomHost& copying) = delete;
+        Room& createRoom();
+        bool removeRoom(unsigned int roomID);
+        Room* getRoom(unsigned int roomID);
+        void setRoomBudget(double milliseconds);
+        double runFrame();
+        void run(double seconds);
+        std::vector<RoomStats> getRoomStats() const;
+        unsigned int getRoomCount() const;
+        unsigned int getWorkerCount() const;
+        unsigned int getMigrationCount() const;
+        unsigned int getWorkerOverrunCount() const;
+        double getFrameMilliseconds() const;
+    };
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include "gameLogic.hpp"
+
+namespace Game {
+
+    class BinaryWriter {
+        std::vector<char> buffer;
+    public:
+        template <typename T>
+        void write(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "BinaryWriter::write needs a trivially copyable type");
+            writeBytes(&value, sizeof(T));
+        }
+        void writeBytes(const void* data, size_t size);
+        void writeVarint(uint32_t value);
+        void writeSignedVarint(int32_t value);
+        void writeRect(const Rect& rect);
+        void writeStats(const EntityStats& stats);
+        void writeShape(const Shape& shape);
+        std::vector<char>& getBuffer();
+        size_t getSize() const;
+    };
+
+    class BinaryReader {
+        const char* data;
+        size_t size;
+        size_t position;
+        bool failed;
+    public:
+        BinaryReader(const char* data_, size_t size_);
+        template <typename T>
+        bool read(T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "BinaryReader::read needs a trivially copyable type");
+            return readBytes(&value, sizeof(T));
+        }
+        bool readBytes(void* out, size_t count);
+        bool readVarint(uint32_t& value);
+        bool readSignedVarint(int32_t& value);
+        bool readRect(Rect& rect);
+        bool readStats(EntityStats& stats);
+        bool readShape(Shape& shape);
+        const char* skip(size_t count);
+        bool hasFailed() const;
+        size_t getPosition() const;
+        size_t getRemaining() const;
+    };
+
+    struct EntityRecord {
+        uint32_t entityID;
+        EntityTemplate entityTemplate;
+        std::vector<Buff> buffs;
+        bool hasShape;
+        Shape shape;
+        bool hasBehaviour;
+        BehaviourProfile::PROFILE behaviour;
+        std::vector<char> behaviourState;
+    };
+
+    void writeEntityRecord(BinaryWriter& writer, const Map& map, const Entity& entity);
+    bool readEntityRecord(BinaryReader& reader, EntityRecord& record);
+
+    uint32_t crc32(const char* data, size_t size, uint32_t crc = 0);
+
+    bool readFile(const std::string& path, std::vector<char>& contents);
+    bool writeFile(const std::string& path, const std::vector<char>& contents);
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "geometry.hpp"
+
+namespace Game {
+
+    class Shape {
+    public:
+        static const unsigned int MAX_VERTICES = 8;
+        enum class TYPE {
+            AABB,
+            CIRCLE,
+            CAPSULE,
+            POLYGON
+        };
+    private:
+        static const unsigned int SIMD_WIDTH = 4;
+        static const int32_t SIMD_RANGE = 1 << 13;
+        static const unsigned int MAX_AXES = MAX_VERTICES * 2 + MAX_VERTICES * MAX_VERTICES;
+        static const int64_t AXIS_LIMIT = static_cast<int64_t>(1) << 30;
+
+        struct EdgeAxes {
+            unsigned int count;
+            int32_t xs[MAX_VERTICES];
+            int32_t ys[MAX_VERTICES];
+            int64_t minimums[MAX_VERTICES];
+            int64_t maximums[MAX_VERTICES];
+        };
+
+        TYPE type;
+        unsigned int vertexCount;
+        int32_t xs[MAX_VERTICES];
+        int32_t ys[MAX_VERTICES];
+        int32_t radius;
+        Rect bounds;
+
+        static bool normalizeAxis(int64_t x, int64_t y, int32_t& unitX, int32_t& unitY);
+        static void projectRect(const Rect& rect, int32_t axisX, int32_t axisY, int64_t& minimum, int64_t& maximum);
+        void setVertices(const std::vector<Vector>& vertices);
+        void project(int32_t axisX, int32_t axisY, int64_t& minimum, int64_t& maximum) const;
+        unsigned int addEdgeNormals(int32_t* axesX, int32_t* axesY, unsigned int axisCount) const;
+        void getEdgeAxes(EdgeAxes& edgeAxes) const;
+        bool cornersSeparate(const Rect& rect) const;
+        bool overlapsRect(const Rect& rect, const EdgeAxes& edgeAxes) const;
+        void overlapsRectsScalar(const std::vector<Rect>& rects, unsigned int start, const EdgeAxes& edgeAxes, std::vector<char>& results) const;
+        void overlapsRectsSIMD(const std::vector<Rect>& rects, const EdgeAxes& edgeAxes, std::vector<char>& results) const;
+    public:
+        Shape();
+        static Shape aabb(const Rect& rect);
+        static Shape circle(const Circle& circle);
+        static Shape capsule(const Vector& start, const Vector& end, int radius);
+        static Shape polygon(const std::vector<Vector>& vertices);
+        static Shape cone(const Vector& apex, const Vector& direction, int range, int halfAngleDegrees);
+        static Shape sweep(const Rect& rect, const Vector& displacement);
+
+        Shape translated(const Vector& offset) const;
+        bool overlaps(const Shape& other) const;
+        bool overlaps(const Rect& rect) const;
+        void overlapsRects(const std::vector<Rect>& rects, std::vector<char>& results) const;
+
+        TYPE getType() const;
+        unsigned int getVertexCount() const;
+        Vector getVertex(unsigned int index) const;
+        int getRadius() const;
+        const Rect& getBounds() const;
+    };
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+namespace Game {
+
+    class SharedMemory {
+        char* data;
+        size_t size;
+        bool owner;
+        std::string name;
+#ifdef _WIN32
+        void* mappingHandle;
+#else
+        int descriptor;
+#endif
+    public:
+        SharedMemory();
+        ~SharedMemory();
+        SharedMemory(const SharedMemory& copying) = delete;
+        SharedMemory& operator=(const SharedMemory& copying) = delete;
+        bool create(const std::string& name_, size_t size_);
+        bool open(const std::string& name_);
+        void close();
+        bool isOpen() const;
+        bool isOwner() const;
+        char* getData() const;
+        size_t getSize() const;
+    };
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "gameLogic.hpp"
+#include "mapEvents.hpp"
+#include "replay.hpp"
+#include "sharedMemory.hpp"
+
+namespace Rendering {
+
+    struct EntitySnapshot {
+        unsigned int id;
+        Game::Rect hitbox;
+        int hp;
+        bool awake;
+        uint8_t prefab;
+    };
+
+    struct SnapshotSlot {
+        uint64_t publishedNanoseconds;
+        uint32_t sequence;
+        uint32_t tick;
+        uint32_t playerID;
+        uint32_t entityCount;
+        uint32_t eventCount;
+        uint32_t awakeEntities;
+        uint32_t sleepingEntities;
+        uint8_t eventsComplete;
+        uint8_t truncated;
+    };
+
+    class SnapshotRing {
+        struct RingHeader;
+
+        Game::SharedMemory memory;
+        RingHeader* header;
+        uint32_t nextSequence;
+        unsigned int lastSlot;
+
+        char* getSlotData(unsigned int slot) const;
+        static size_t getSlotStride(unsigned int entityCapacity, unsigned int eventCapacity);
+    public:
+        static const unsigned int SLOT_COUNT = 4;
+        static const unsigned int INTENT_CAPACITY = 256;
+
+        SnapshotRing();
+        ~SnapshotRing();
+        SnapshotRing(const SnapshotRing& copying) = delete;
+        SnapshotRing& operator=(const SnapshotRing& copying) = delete;
+        bool create(const std::string& name, unsigned int entityCapacity, unsigned int eventCapacity);
+        bool open(const std::string& name);
+        void close();
+        bool isOpen() const;
+
+        void publish(Game::Map& map, unsigned int tick, uint64_t& eventCursor);
+        bool popIntent(Game::Intent& intent);
+
+        const SnapshotSlot* acquireLatest();
+        void release();
+        const EntitySnapshot* getEntities(const SnapshotSlot* slot) const;
+        const Game::MapEvent* getEvents(const SnapshotSlot* slot) const;
+        bool pushIntent(const Game::Intent& intent);
+
+        static uint64_t getTimestamp();
+    };
+
+}
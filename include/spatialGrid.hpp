@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include "geometry.hpp"
+
+namespace Game {
+
+    class SpatialGrid {
+        struct CellRange {
+            int minX, minY, maxX, maxY;
+            bool operator==(const CellRange& range) const;
+        };
+
+        int cellSize;
+        std::unordered_map<int64_t, std::vector<unsigned int>> cells;
+        std::unordered_map<unsigned int, CellRange> entityRanges;
+        std::vector<unsigned int> queryMarks;
+        unsigned int queryStamp;
+
+        int toCell(int coordinate) const;
+        CellRange getCellRange(const Rect& rect) const;
+        static int64_t getCellKey(int cellX, int cellY);
+        void addToCells(unsigned int entityID, const CellRange& range);
+        void removeFromCells(unsigned int entityID, const CellRange& range);
+        bool markVisited(unsigned int entityID);
+    public:
+        SpatialGrid();
+        SpatialGrid(int cellSize_);
+        void insert(unsigned int entityID, const Rect& bounds);
+        void update(unsigned int entityID, const Rect& bounds);
+        void remove(unsigned int entityID);
+        bool contains(unsigned int entityID) const;
+        void query(const Rect& area, std::vector<unsigned int>& found);
+        void clear();
+        void reserve(unsigned int entityCount);
+        void build(const std::vector<unsigned int>& entityIDs, const std::vector<Rect>& bounds);
+        int getCellSize() const;
+    };
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+namespace Rendering {
+
+    class SpriteBatch {
+        struct Run {
+            const sf::Texture* texture;
+            std::size_t firstVertex;
+            std::size_t vertexCount;
+        };
+        std::vector<sf::Vertex> vertices;
+        std::vector<Run> runs;
+        sf::FloatRect visibleArea;
+        unsigned int quadCount;
+        unsigned int culledCount;
+        unsigned int drawCalls;
+
+        Run& getRun(const sf::Texture* texture);
+    public:
+        SpriteBatch();
+        void begin(const sf::FloatRect& visibleArea_);
+        bool add(const sf::Sprite& sprite);
+        void flush(sf::RenderTarget& target);
+        unsigned int getQuadCount() const;
+        unsigned int getCulledCount() const;
+        unsigned int getDrawCalls() const;
+    };
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <utility>
+
+namespace Game {
+
+    template <typename KEY, typename VALUE, unsigned int COUNT>
+    class StatArray {
+        VALUE values[COUNT];
+    public:
+        class const_iterator {
+            const VALUE* values;
+            unsigned int index;
+        public:
+            const_iterator(const VALUE* values_, unsigned int index_) {
+                values = values_;
+                index = index_;
+            }
+            std::pair<KEY, VALUE> operator*() const {
+                return std::make_pair(static_cast<KEY>(index), values[index]);
+            }
+            const_iterator& operator++() {
+                index++;
+                return *this;
+            }
+            bool operator!=(const const_iterator& other) const {
+                return index != other.index;
+            }
+        };
+
+        StatArray() {
+            for (unsigned int i = 0; i < COUNT; i++) {
+                values[i] = VALUE();
+            }
+        }
+
+        VALUE& operator[](KEY key) {
+            return values[static_cast<unsigned int>(key)];
+        }
+        const VALUE& operator[](KEY key) const {
+            return values[static_cast<unsigned int>(key)];
+        }
+        VALUE& at(KEY key) {
+            return values[static_cast<unsigned int>(key)];
+        }
+        const VALUE& at(KEY key) const {
+            return values[static_cast<unsigned int>(key)];
+        }
+        unsigned int size() const {
+            return COUNT;
+        }
+        const_iterator begin() const {
+            return const_iterator(values, 0);
+        }
+        const_iterator end() const {
+            return const_iterator(values, COUNT);
+        }
+    };
+
+}
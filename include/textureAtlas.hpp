@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <SFML/Graphics.hpp>
+#include "atlasPacker.hpp"
+
+namespace Rendering {
+
+    struct AtlasFrame {
+        const sf::Texture* texture;
+        sf::IntRect rect;
+    };
+
+    class TextureAtlas {
+        std::deque<sf::Texture> pages;
+        std::vector<unsigned int> freePages;
+
+        static void extrudeEdges(sf::Image& page, const AtlasPlacement& placement, unsigned int padding);
+    public:
+        static const unsigned int PAGE_SIZE = 2048;
+        static const unsigned int PADDING = 2;
+        static void composePages(const std::vector<sf::Image>& images, AtlasPacker& packer, std::vector<sf::Image>& pageImages);
+        bool addPage(unsigned int width, unsigned int height, const sf::Uint8* pixels, unsigned int& page);
+        void releasePage(unsigned int page);
+        unsigned int getPageCount() const;
+        unsigned int getResidentPageCount() const;
+        const sf::Texture& getPage(unsigned int page) const;
+    };
+
+    void applyFrame(sf::Sprite& sprite, const AtlasFrame& frame);
+
+}
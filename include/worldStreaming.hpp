@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <unordered_map>
+#include "gameLogic.hpp"
+#include "serialization.hpp"
+
+namespace Game {
+
+    class WorldStreamer {
+        static const int CHUNK_SIZE = 1024;
+        static const int LOAD_MARGIN = 1;
+        static const int EVICT_MARGIN = 3;
+        static const unsigned int MAX_RESIDENT_CHUNKS = 64;
+        static const unsigned int INTEGRATE_BUDGET = 256;
+        static const unsigned int EVICT_BUDGET = 256;
+        static const uint32_t CHUNK_MAGIC = 0x4b4e4843;
+        static const uint16_t CHUNK_VERSION = 2;
+
+        enum class CHUNK_STATE {
+            LOADING,
+            RESIDENT,
+            EVICTING
+        };
+
+        struct ChunkJob {
+            bool saving;
+            int chunkX;
+            int chunkY;
+            std::vector<char> data;
+        };
+
+        struct LoadedChunk {
+            int chunkX;
+            int chunkY;
+            std::vector<EntityRecord> entities;
+            std::vector<Rect> staticGeometry;
+            unsigned int integrated;
+        };
+
+        struct EvictingChunk {
+            int chunkX;
+            int chunkY;
+            std::vector<unsigned int> entityIDs;
+            unsigned int written;
+            uint32_t recordCount;
+            BinaryWriter records;
+        };
+
+        struct ChunkRange {
+            int minX, minY, maxX, maxY;
+        };
+
+        Map* map;
+        std::string directory;
+        std::unordered_map<int64_t, CHUNK_STATE> chunks;
+        MPSCQueue<std::unique_ptr<ChunkJob>> jobs;
+        MPSCQueue<std::unique_ptr<LoadedChunk>> loadedChunks;
+        std::deque<std::unique_ptr<LoadedChunk>> integrating;
+        std::deque<std::unique_ptr<EvictingChunk>> evicting;
+        std::thread worker;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        bool jobsPending;
+        std::atomic<bool> stopping;
+        unsigned int evictions;
+
+        static int toChunk(int coordinate);
+        static int64_t getChunkKey(int chunkX, int chunkY);
+        static Rect getChunkRect(int chunkX, int chunkY);
+        static ChunkRange getChunkRange(const Rect& area, int margin);
+        std::string getChunkPath(int chunkX, int chunkY) const;
+
+        void runWorker();
+        void queueJob(std::unique_ptr<ChunkJob> job);
+        void saveChunk(const ChunkJob& job);
+        void loadChunk(const ChunkJob& job);
+        void requestChunks(const ChunkRange& range);
+        void integrateLoadedChunks();
+        void integrateEntity(const EntityRecord& record);
+        std::vector<unsigned int> getEntitiesInChunk(int chunkX, int chunkY);
+        void evictChunk(int chunkX, int chunkY);
+        void writeEvictedEntities(unsigned int budget);
+        void finishEviction(EvictingChunk& chunk);
+        void evictDistantChunks(const ChunkRange& range);
+    public:
+        WorldStreamer();
+        ~WorldStreamer();
+        void start(Map* map_, const std::string& directory_);
+        void stop();
+        void markResident(const Rect& area);
+        void update(const Rect& viewBox);
+        unsigned int getResidentChunkCount() const;
+        unsigned int getEvictionCount() const;
+    };
+
+}
@@ -0,0 +1,376 @@
+#include "assetLoader.hpp"
+#include <iostream>
+#include <fstream>
+
+namespace Rendering {
+
+    AssetLoader::AssetLoader() {
+        atlas = NULL;
+        registry = NULL;
+        pageSize = TextureAtlas::PAGE_SIZE;
+        placeholder.texture = NULL;
+        stopping = false;
+        readyCount = 0;
+        uploadedBytes = 0;
+    }
+
+    AssetLoader::~AssetLoader() {
+        stop();
+    }
+
+    unsigned int AssetLoader::getDefaultWorkerCount() {
+        unsigned int cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1;
+    }
+
+    void AssetLoader::start(TextureAtlas* atlas_, AssetRegistry* registry_, unsigned int workerCount) {
+        stop();
+        atlas = atlas_;
+        registry = registry_;
+        unsigned int maximumSize = sf::Texture::getMaximumSize();
+        pageSize = maximumSize < TextureAtlas::PAGE_SIZE ? maximumSize : static_cast<unsigned int>(TextureAtlas::PAGE_SIZE);
+
+        sf::Uint8 pixels[16];
+        for (unsigned int i = 0; i < 16; i += 4) {
+            pixels[i] = PLACEHOLDER_SHADE;
+            pixels[i + 1] = PLACEHOLDER_SHADE;
+            pixels[i + 2] = PLACEHOLDER_SHADE;
+            pixels[i + 3] = PLACEHOLDER_ALPHA;
+        }
+        unsigned int page;
+        atlas->addPage(2, 2, pixels, page);
+        placeholder.texture = &atlas->getPage(page);
+        placeholder.rect = sf::IntRect(0, 0, 2, 2);
+        registry->setMissingFrame(placeholder);
+
+        stopping = false;
+        for (unsigned int i = 0; i < (workerCount > 0 ? workerCount : 1); i++) {
+            workers.push_back(std::thread(&AssetLoader::runWorker, this));
+        }
+    }
+
+    void AssetLoader::stop() {
+        if (workers.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    void AssetLoader::runWorker() {
+        while (true) {
+            Request* request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() {
+                    return stopping || !decodeQueue.empty();
+                });
+                if (stopping) {
+                    return;
+                }
+                request = &requests[decodeQueue.front()];
+                decodeQueue.pop_front();
+            }
+            bool decoded = decode(*request);
+            std::lock_guard<std::mutex> lock(mutex);
+            request->state = decoded ? STATE::DECODED : STATE::FAILED;
+        }
+    }
+
+    void AssetLoader::decodeSequence(const std::string& path, std::vector<sf::Image>& images) {
+        for (unsigned int i = 0;; i++) {
+            std::string filePath = path + "/" + std::to_string(i) + ".png";
+            std::ifstream file(filePath);
+            if (!file) {
+                return;
+            }
+            images.push_back(sf::Image());
+            if (!images.back().loadFromFile(filePath)) {
+                images.pop_back();
+                return;
+            }
+        }
+    }
+
+    bool AssetLoader::decode(Request& request) {
+        if (request.texture) {
+            request.pageImages.resize(1);
+            if (!request.pageImages[0].loadFromFile(request.paths[0])) {
+                return false;
+            }
+            PageData page;
+            page.pixels = NULL;
+            page.width = request.pageImages[0].getSize().x;
+            page.height = request.pageImages[0].getSize().y;
+            request.pages.push_back(page);
+            request.bytes = static_cast<size_t>(page.width) * page.height * 4;
+            return true;
+        }
+
+        request.pages.clear();
+        request.frames.clear();
+        request.bytes = 0;
+        std::vector<sf::Image> images;
+        std::vector<unsigned int> firstImages;
+        for (const std::string& path : request.paths) {
+            firstImages.push_back(images.size());
+            decodeSequence(path, images);
+        }
+        firstImages.push_back(images.size());
+
+        AtlasPacker packer(pageSize, TextureAtlas::PADDING);
+        TextureAtlas::composePages(images, packer, request.pageImages);
+        for (const sf::Image& pageImage : request.pageImages) {
+            PageData page;
+            page.pixels = NULL;
+            page.width = pageImage.getSize().x;
+            page.height = pageImage.getSize().y;
+            request.pages.push_back(page);
+            request.bytes += static_cast<size_t>(page.width) * page.height * 4;
+        }
+        request.frames.resize(request.paths.size());
+        for (unsigned int target = 0; target < request.paths.size(); target++) {
+            for (unsigned int i = firstImages[target]; i < firstImages[target + 1]; i++) {
+                const AtlasPlacement& placement = packer.getPlacement(i);
+                FrameData frame;
+                frame.page = placement.page;
+                frame.rect = sf::IntRect(placement.x, placement.y, placement.width, placement.height);
+                request.frames[target].push_back(frame);
+            }
+        }
+        return true;
+    }
+
+    bool AssetLoader::upload(Request& request, size_t budget, size_t& uploaded) {
+        while (request.atlasPages.size() < request.pages.size()) {
+            unsigned int index = request.atlasPages.size();
+            const PageData& page = request.pages[index];
+            size_t bytes = static_cast<size_t>(page.width) * page.height * 4;
+            if (uploaded > 0 && uploaded + bytes > budget) {
+                return false;
+            }
+            const sf::Uint8* pixels = page.pixels ? page.pixels : request.pageImages[index].getPixelsPtr();
+            unsigned int atlasPage = 0;
+            if (request.texture) {
+                if (request.texture->create(page.width, page.height)) {
+                    request.texture->update(pixels);
+                    request.texture->setRepeated(true);
+                }
+                else {
+                    std::cout << "Could not create texture of " << page.width << "x" << page.height << "\n";
+                }
+            }
+            else {
+                atlas->addPage(page.width, page.height, pixels, atlasPage);
+            }
+            request.atlasPages.push_back(atlasPage);
+            uploaded += bytes;
+            uploadedBytes += bytes;
+        }
+        return true;
+    }
+
+    void AssetLoader::resolve(Request& request) {
+        for (unsigned int target = 0; target < request.targets.size() && target < request.frames.size(); target++) {
+            if (request.frames[target].empty()) {
+                continue;
+            }
+            std::vector<AtlasFrame> frameSet;
+            for (const FrameData& frame : request.frames[target]) {
+                AtlasFrame atlasFrame;
+                atlasFrame.texture = &atlas->getPage(request.atlasPages[frame.page]);
+                atlasFrame.rect = frame.rect;
+                frameSet.push_back(atlasFrame);
+            }
+            registry->setFrames(request.targets[target], frameSet);
+        }
+        request.pageImages = std::vector<sf::Image>();
+    }
+
+    size_t AssetLoader::getPageBytes(const std::vector<PageData>& pages) {
+        size_t bytes = 0;
+        for (const PageData& page : pages) {
+            bytes += static_cast<size_t>(page.width) * page.height * 4;
+        }
+        return bytes;
+    }
+
+    unsigned int AssetLoader::addRequest(const Request& request) {
+        for (unsigned int target : request.targets) {
+            registry->setFrames(target, std::vector<AtlasFrame>(1, placeholder));
+        }
+        unsigned int handle;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            handle = requests.size();
+            requests.push_back(request);
+            if (request.state == STATE::QUEUED) {
+                decodeQueue.push_back(handle);
+            }
+        }
+        wake.notify_one();
+        unfinished.push_back(handle);
+        return handle;
+    }
+
+    unsigned int AssetLoader::requestSequences(const std::vector<std::string>& paths, const std::vector<unsigned int>& targets) {
+        Request request;
+        request.paths = paths;
+        request.targets = targets;
+        request.texture = NULL;
+        request.bytes = 0;
+        request.state = STATE::QUEUED;
+        return addRequest(request);
+    }
+
+    unsigned int AssetLoader::requestTexture(const std::string& path, sf::Texture* target) {
+        Request request;
+        request.paths.push_back(path);
+        request.texture = target;
+        request.bytes = 0;
+        request.state = STATE::QUEUED;
+        return addRequest(request);
+    }
+
+    unsigned int AssetLoader::requestUpload(const std::vector<PageData>& pages, const std::vector<std::vector<FrameData>>& frames, const std::vector<unsigned int>& targets) {
+        Request request;
+        request.targets = targets;
+        request.texture = NULL;
+        request.pages = pages;
+        request.frames = frames;
+        request.bytes = getPageBytes(pages);
+        request.state = STATE::DECODED;
+        return addRequest(request);
+    }
+
+    unsigned int AssetLoader::requestTextureUpload(const PageData& page, sf::Texture* target) {
+        Request request;
+        request.texture = target;
+        request.pages.push_back(page);
+        request.bytes = getPageBytes(request.pages);
+        request.state = STATE::DECODED;
+        return addRequest(request);
+    }
+
+    size_t AssetLoader::update(size_t uploadBudget) {
+        size_t uploaded = 0;
+        std::vector<unsigned int>::iterator it = unfinished.begin();
+        while (it != unfinished.end()) {
+            Request* request;
+            STATE state;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                request = &requests[*it];
+                state = request->state;
+            }
+            if (state == STATE::FAILED) {
+                std::cout << "Could not decode " << (request->paths.empty() ? std::string("asset") : request->paths[0]) << "\n";
+                it = unfinished.erase(it);
+                continue;
+            }
+            if (state != STATE::DECODED) {
+                it++;
+                continue;
+            }
+            if (!upload(*request, uploadBudget, uploaded)) {
+                break;
+            }
+            resolve(*request);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                request->state = STATE::READY;
+            }
+            readyCount++;
+            it = unfinished.erase(it);
+        }
+        return uploaded;
+    }
+
+    bool AssetLoader::evict(unsigned int handle) {
+        Request* request;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            request = &requests[handle];
+            if (request->state != STATE::READY || request->texture) {
+                return false;
+            }
+            request->state = STATE::EVICTED;
+        }
+        for (unsigned int page : request->atlasPages) {
+            atlas->releasePage(page);
+        }
+        request->atlasPages.clear();
+        for (unsigned int target : request->targets) {
+            registry->setFrames(target, std::vector<AtlasFrame>(1, placeholder));
+        }
+        readyCount--;
+        return true;
+    }
+
+    bool AssetLoader::reload(unsigned int handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Request& request = requests[handle];
+            if (request.state != STATE::EVICTED) {
+                return false;
+            }
+            if (!request.pages.empty() && request.pages[0].pixels) {
+                request.state = STATE::DECODED;
+            }
+            else {
+                request.state = STATE::QUEUED;
+                decodeQueue.push_back(handle);
+            }
+        }
+        wake.notify_one();
+        unfinished.push_back(handle);
+        return true;
+    }
+
+    AssetLoader::STATE AssetLoader::getState(unsigned int handle) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests[handle].state;
+    }
+
+    bool AssetLoader::isReady(unsigned int handle) const {
+        return getState(handle) == STATE::READY;
+    }
+
+    size_t AssetLoader::getBytes(unsigned int handle) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests[handle].bytes;
+    }
+
+    bool AssetLoader::isFinished() const {
+        return unfinished.empty();
+    }
+
+    unsigned int AssetLoader::getRequestCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests.size();
+    }
+
+    unsigned int AssetLoader::getReadyCount() const {
+        return readyCount;
+    }
+
+    unsigned int AssetLoader::getWorkerCount() const {
+        return workers.size();
+    }
+
+    unsigned long long AssetLoader::getUploadedBytes() const {
+        return uploadedBytes;
+    }
+
+    const AtlasFrame& AssetLoader::getPlaceholder() const {
+        return placeholder;
+    }
+
+}
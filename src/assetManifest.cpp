@@ -0,0 +1,79 @@
+#include "assetManifest.hpp"
+#include <sstream>
+#include <fstream>
+
+namespace Rendering {
+
+    namespace {
+
+        bool parseKind(const std::string& text, AssetEntry::KIND& kind) {
+            if (text == "textureSet") {
+                kind = AssetEntry::KIND::TEXTURE_SET;
+            }
+            else if (text == "animation") {
+                kind = AssetEntry::KIND::ANIMATION;
+            }
+            else if (text == "background") {
+                kind = AssetEntry::KIND::BACKGROUND;
+            }
+            else if (text == "absoluteBackground") {
+                kind = AssetEntry::KIND::ABSOLUTE_BACKGROUND;
+            }
+            else if (text == "font") {
+                kind = AssetEntry::KIND::FONT;
+            }
+            else {
+                return false;
+            }
+            return true;
+        }
+
+    }
+
+    bool AssetManifest::load(const std::string& text) {
+        entries.clear();
+        lastError.clear();
+        std::istringstream lines(text);
+        std::string line;
+        unsigned int lineNumber = 0;
+        while (std::getline(lines, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            std::istringstream fields(line);
+            std::string kind;
+            AssetEntry entry;
+            if (!(fields >> kind)) {
+                continue;
+            }
+            if (!parseKind(kind, entry.kind) || !(fields >> entry.name >> entry.path)) {
+                lastError = "line " + std::to_string(lineNumber) + ": expected kind name path";
+                return false;
+            }
+            entries.push_back(entry);
+        }
+        return true;
+    }
+
+    bool AssetManifest::loadFromFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            lastError = "could not open " + path;
+            return false;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return load(contents.str());
+    }
+
+    const std::vector<AssetEntry>& AssetManifest::getEntries() const {
+        return entries;
+    }
+
+    const std::string& AssetManifest::getLastError() const {
+        return lastError;
+    }
+
+}
@@ -0,0 +1,269 @@
+#include "assetPack.hpp"
+#include "serialization.hpp"
+
+namespace Rendering {
+
+    namespace {
+
+        void writeString(Game::BinaryWriter& writer, const std::string& text) {
+            writer.write<uint16_t>(text.size());
+            writer.writeBytes(text.data(), text.size());
+        }
+
+        bool readString(Game::BinaryReader& reader, std::string& text) {
+            uint16_t length;
+            if (!reader.read(length)) {
+                return false;
+            }
+            const char* bytes = reader.skip(length);
+            if (!bytes) {
+                return false;
+            }
+            text.assign(bytes, length);
+            return true;
+        }
+
+        void writeSection(Game::BinaryWriter& writer, uint32_t tag, uint32_t count, const std::vector<char>& payload, bool checksummed) {
+            writer.write<uint32_t>(tag);
+            writer.write<uint32_t>(count);
+            writer.write<uint32_t>(payload.size());
+            writer.write<uint32_t>(checksummed ? Game::crc32(payload.data(), payload.size()) : 0);
+            writer.writeBytes(payload.data(), payload.size());
+        }
+
+    }
+
+    unsigned int AssetPack::Builder::addPage(uint32_t width, uint32_t height, const uint8_t* rgba, uint32_t flags) {
+        PageRow row;
+        row.width = width;
+        row.height = height;
+        row.offset = pixels.size();
+        row.flags = flags;
+        pixels.insert(pixels.end(), reinterpret_cast<const char*>(rgba), reinterpret_cast<const char*>(rgba) + static_cast<size_t>(width) * height * 4);
+        pages.push_back(row);
+        return pages.size() - 1;
+    }
+
+    unsigned int AssetPack::Builder::addFrame(uint32_t page, int32_t x, int32_t y, int32_t width, int32_t height) {
+        FrameRow row;
+        row.page = page;
+        row.x = x;
+        row.y = y;
+        row.width = width;
+        row.height = height;
+        frames.push_back(row);
+        return frames.size() - 1;
+    }
+
+    void AssetPack::Builder::addSet(AssetEntry::KIND kind, const std::string& name, const std::string& state, uint32_t firstFrame, uint32_t frameCount) {
+        SetEntry entry;
+        entry.kind = kind;
+        entry.name = name;
+        entry.state = state;
+        entry.firstFrame = firstFrame;
+        entry.frameCount = frameCount;
+        sets.push_back(entry);
+    }
+
+    void AssetPack::Builder::addFont(const std::string& name, const std::vector<char>& data) {
+        fonts.push_back(std::make_pair(name, data));
+    }
+
+    void AssetPack::Builder::save(std::vector<char>& out) const {
+        Game::BinaryWriter writer;
+        writer.write<uint32_t>(static_cast<uint32_t>(MAGIC));
+        writer.write<uint16_t>(static_cast<uint16_t>(VERSION));
+        writer.write<uint16_t>(5);
+
+        std::vector<char> pageBytes(pages.size() * sizeof(PageRow));
+        if (!pages.empty()) {
+            std::memcpy(pageBytes.data(), pages.data(), pageBytes.size());
+        }
+        writeSection(writer, static_cast<uint32_t>(SECTION::PAGES), pages.size(), pageBytes, isChecksummed(SECTION::PAGES));
+
+        std::vector<char> frameBytes(frames.size() * sizeof(FrameRow));
+        if (!frames.empty()) {
+            std::memcpy(frameBytes.data(), frames.data(), frameBytes.size());
+        }
+        writeSection(writer, static_cast<uint32_t>(SECTION::FRAMES), frames.size(), frameBytes, isChecksummed(SECTION::FRAMES));
+
+        Game::BinaryWriter setWriter;
+        for (const SetEntry& entry : sets) {
+            setWriter.write<uint8_t>(static_cast<uint8_t>(entry.kind));
+            writeString(setWriter, entry.name);
+            writeString(setWriter, entry.state);
+            setWriter.write<uint32_t>(entry.firstFrame);
+            setWriter.write<uint32_t>(entry.frameCount);
+        }
+        writeSection(writer, static_cast<uint32_t>(SECTION::SETS), sets.size(), setWriter.getBuffer(), isChecksummed(SECTION::SETS));
+
+        Game::BinaryWriter fontWriter;
+        for (const std::pair<std::string, std::vector<char>>& font : fonts) {
+            writeString(fontWriter, font.first);
+            fontWriter.write<uint32_t>(font.second.size());
+            fontWriter.writeBytes(font.second.data(), font.second.size());
+        }
+        writeSection(writer, static_cast<uint32_t>(SECTION::FONTS), fonts.size(), fontWriter.getBuffer(), isChecksummed(SECTION::FONTS));
+        writeSection(writer, static_cast<uint32_t>(SECTION::PIXELS), pages.size(), pixels, isChecksummed(SECTION::PIXELS));
+        out.swap(writer.getBuffer());
+    }
+
+    bool AssetPack::Builder::saveToFile(const std::string& path) const {
+        std::vector<char> contents;
+        save(contents);
+        return Game::writeFile(path, contents);
+    }
+
+    bool AssetPack::isChecksummed(SECTION section) {
+        return section == SECTION::PAGES || section == SECTION::FRAMES || section == SECTION::SETS;
+    }
+
+    AssetPack::AssetPack() {
+        pixels = NULL;
+        pixelSize = 0;
+    }
+
+    bool AssetPack::parseSets(const char* data, uint32_t size, uint32_t count) {
+        Game::BinaryReader reader(data, size);
+        sets.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            SetEntry entry;
+            uint8_t kind;
+            if (!reader.read(kind) || kind > static_cast<uint8_t>(AssetEntry::KIND::FONT) || !readString(reader, entry.name) || !readString(reader, entry.state)
+                || !reader.read(entry.firstFrame) || !reader.read(entry.frameCount) || entry.firstFrame > frames.size() || entry.frameCount > frames.size() - entry.firstFrame) {
+                return false;
+            }
+            entry.kind = static_cast<AssetEntry::KIND>(kind);
+            sets.push_back(entry);
+        }
+        return true;
+    }
+
+    bool AssetPack::parseFonts(const char* data, uint32_t size, uint32_t count) {
+        Game::BinaryReader reader(data, size);
+        fonts.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            FontEntry entry;
+            if (!readString(reader, entry.name) || !reader.read(entry.size)) {
+                return false;
+            }
+            entry.data = reader.skip(entry.size);
+            if (!entry.data) {
+                return false;
+            }
+            fonts.push_back(entry);
+        }
+        return true;
+    }
+
+    bool AssetPack::parse(const char* data, size_t size) {
+        Game::BinaryReader reader(data, size);
+        uint32_t magic;
+        uint16_t version, sectionCount;
+        if (!reader.read(magic) || !reader.read(version) || !reader.read(sectionCount) || magic != MAGIC || version != VERSION) {
+            return false;
+        }
+        const char* setData = NULL;
+        const char* fontData = NULL;
+        SectionHeader setHeader = {};
+        SectionHeader fontHeader = {};
+        for (uint16_t i = 0; i < sectionCount; i++) {
+            SectionHeader header;
+            if (!reader.read(header)) {
+                return false;
+            }
+            const char* payload = reader.skip(header.size);
+            bool checksummed = isChecksummed(static_cast<SECTION>(header.tag)) || header.checksum != 0;
+            if (!payload || (checksummed && Game::crc32(payload, header.size) != header.checksum)) {
+                return false;
+            }
+            switch (static_cast<SECTION>(header.tag)) {
+                case SECTION::PAGES:
+                    if (header.size != static_cast<uint64_t>(header.count) * sizeof(PageRow)) {
+                        return false;
+                    }
+                    pages.resize(header.count);
+                    std::memcpy(pages.data(), payload, header.size);
+                    break;
+                case SECTION::FRAMES:
+                    if (header.size != static_cast<uint64_t>(header.count) * sizeof(FrameRow)) {
+                        return false;
+                    }
+                    frames.resize(header.count);
+                    std::memcpy(frames.data(), payload, header.size);
+                    break;
+                case SECTION::SETS:
+                    setData = payload;
+                    setHeader = header;
+                    break;
+                case SECTION::FONTS:
+                    fontData = payload;
+                    fontHeader = header;
+                    break;
+                case SECTION::PIXELS:
+                    pixels = payload;
+                    pixelSize = header.size;
+                    break;
+            }
+        }
+        for (const PageRow& page : pages) {
+            if (!pixels || page.offset > pixelSize || static_cast<uint64_t>(page.width) * page.height * 4 > pixelSize - page.offset) {
+                return false;
+            }
+        }
+        for (const FrameRow& frame : frames) {
+            if (frame.page >= pages.size() || frame.x < 0 || frame.y < 0 || frame.width < 0 || frame.height < 0
+                || static_cast<int64_t>(frame.x) + frame.width > pages[frame.page].width || static_cast<int64_t>(frame.y) + frame.height > pages[frame.page].height) {
+                return false;
+            }
+        }
+        return (!setData || parseSets(setData, setHeader.size, setHeader.count)) && (!fontData || parseFonts(fontData, fontHeader.size, fontHeader.count));
+    }
+
+    bool AssetPack::open(const std::string& path) {
+        close();
+        if (!file.open(path)) {
+            return false;
+        }
+        if (!parse(file.getData(), file.getSize())) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void AssetPack::close() {
+        file.close();
+        pages.clear();
+        frames.clear();
+        sets.clear();
+        fonts.clear();
+        pixels = NULL;
+        pixelSize = 0;
+    }
+
+    bool AssetPack::isOpen() const {
+        return file.isOpen();
+    }
+
+    const std::vector<AssetPack::PageRow>& AssetPack::getPages() const {
+        return pages;
+    }
+
+    const uint8_t* AssetPack::getPagePixels(unsigned int page) const {
+        return reinterpret_cast<const uint8_t*>(pixels + pages[page].offset);
+    }
+
+    const std::vector<AssetPack::FrameRow>& AssetPack::getFrames() const {
+        return frames;
+    }
+
+    const std::vector<AssetPack::SetEntry>& AssetPack::getSets() const {
+        return sets;
+    }
+
+    const std::vector<AssetPack::FontEntry>& AssetPack::getFonts() const {
+        return fonts;
+    }
+
+}
@@ -0,0 +1,95 @@
+#include "assetRegistry.hpp"
+#include <algorithm>
+
+namespace Rendering {
+
+    AssetRegistry::AssetRegistry() {
+        missingFrame.texture = NULL;
+        missingFrame.rect = sf::IntRect(0, 0, 0, 0);
+    }
+
+    unsigned int AssetRegistry::internState(const std::string& name) {
+        unsigned int state = findState(name);
+        if (state != NONE) {
+            return state;
+        }
+        stateNames.push_back(name);
+        return stateNames.size() - 1;
+    }
+
+    unsigned int AssetRegistry::findState(const std::string& name) const {
+        for (unsigned int i = 0; i < stateNames.size(); i++) {
+            if (stateNames[i] == name) {
+                return i;
+            }
+        }
+        return NONE;
+    }
+
+    unsigned int AssetRegistry::addSet(AssetEntry::KIND kind, const std::string& name, unsigned int stateCount) {
+        std::map<std::pair<AssetEntry::KIND, std::string>, unsigned int>::iterator found = setHandles.find(std::make_pair(kind, name));
+        if (found != setHandles.end()) {
+            return found->second;
+        }
+        Set set;
+        set.firstSequence = sequences.size();
+        set.stateCount = stateCount > 0 ? stateCount : 1;
+        for (unsigned int i = 0; i < set.stateCount; i++) {
+            Sequence sequence;
+            sequence.firstFrame = frames.size();
+            sequence.frameCount = 0;
+            sequence.capacity = 0;
+            sequences.push_back(sequence);
+        }
+        sets.push_back(set);
+        setHandles[std::make_pair(kind, name)] = sets.size() - 1;
+        return sets.size() - 1;
+    }
+
+    unsigned int AssetRegistry::findSet(AssetEntry::KIND kind, const std::string& name) const {
+        std::map<std::pair<AssetEntry::KIND, std::string>, unsigned int>::const_iterator found = setHandles.find(std::make_pair(kind, name));
+        return found != setHandles.end() ? found->second : static_cast<unsigned int>(NONE);
+    }
+
+    unsigned int AssetRegistry::getSequence(unsigned int set, unsigned int state) const {
+        if (set >= sets.size() || state >= sets[set].stateCount) {
+            return NONE;
+        }
+        return sets[set].firstSequence + state;
+    }
+
+    void AssetRegistry::setFrames(unsigned int sequence, const std::vector<AtlasFrame>& sequenceFrames) {
+        Sequence& target = sequences[sequence];
+        if (sequenceFrames.size() > target.capacity) {
+            target.firstFrame = frames.size();
+            target.capacity = sequenceFrames.size();
+            frames.resize(frames.size() + sequenceFrames.size());
+        }
+        std::copy(sequenceFrames.begin(), sequenceFrames.end(), frames.begin() + target.firstFrame);
+        target.frameCount = sequenceFrames.size();
+    }
+
+    void AssetRegistry::setMissingFrame(const AtlasFrame& missingFrame_) {
+        missingFrame = missingFrame_;
+    }
+
+    unsigned int AssetRegistry::getFrameCount(unsigned int sequence) const {
+        return sequence < sequences.size() ? sequences[sequence].frameCount : 0;
+    }
+
+    const AtlasFrame& AssetRegistry::getFrame(unsigned int sequence, unsigned int index) const {
+        if (sequence >= sequences.size() || index >= sequences[sequence].frameCount) {
+            return missingFrame;
+        }
+        return frames[sequences[sequence].firstFrame + index];
+    }
+
+    unsigned int AssetRegistry::getSetCount() const {
+        return sets.size();
+    }
+
+    unsigned int AssetRegistry::getStoredFrameCount() const {
+        return frames.size();
+    }
+
+}
@@ -0,0 +1,129 @@
+#include "atlasPacker.hpp"
+#include <algorithm>
+
+namespace Rendering {
+
+    AtlasPacker::AtlasPacker(unsigned int pageSize_, unsigned int padding_) {
+        pageSize = pageSize_;
+        padding = padding_;
+    }
+
+    unsigned int AtlasPacker::add(unsigned int width, unsigned int height) {
+        AtlasPlacement placement;
+        placement.page = 0;
+        placement.x = 0;
+        placement.y = 0;
+        placement.width = width;
+        placement.height = height;
+        placements.push_back(placement);
+        return placements.size() - 1;
+    }
+
+    bool AtlasPacker::placeOnPage(PageState& page, unsigned int width, unsigned int height, unsigned int& x, unsigned int& y) {
+        if (page.dedicated) {
+            return false;
+        }
+        if (page.cursorX + width <= pageSize && height <= page.shelfHeight) {
+            x = page.cursorX;
+            y = page.shelfY;
+        }
+        else if (page.shelfY + page.shelfHeight + height <= pageSize && width <= pageSize) {
+            page.shelfY += page.shelfHeight;
+            page.shelfHeight = height;
+            page.cursorX = 0;
+            x = 0;
+            y = page.shelfY;
+        }
+        else {
+            return false;
+        }
+        page.cursorX += width;
+        page.usedWidth = std::max(page.usedWidth, page.cursorX);
+        page.usedHeight = std::max(page.usedHeight, page.shelfY + page.shelfHeight);
+        return true;
+    }
+
+    void AtlasPacker::pack() {
+        pages.clear();
+        std::vector<unsigned int> order(placements.size());
+        for (unsigned int i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](unsigned int first, unsigned int second) {
+            if (placements[first].height != placements[second].height) {
+                return placements[first].height > placements[second].height;
+            }
+            if (placements[first].width != placements[second].width) {
+                return placements[first].width > placements[second].width;
+            }
+            return first < second;
+        });
+
+        for (unsigned int index : order) {
+            AtlasPlacement& placement = placements[index];
+            unsigned int width = placement.width + padding * 2;
+            unsigned int height = placement.height + padding * 2;
+            unsigned int x = 0;
+            unsigned int y = 0;
+            bool placed = false;
+            if (width <= pageSize && height <= pageSize) {
+                for (unsigned int page = 0; page < pages.size() && !placed; page++) {
+                    if (placeOnPage(pages[page], width, height, x, y)) {
+                        placement.page = page;
+                        placed = true;
+                    }
+                }
+            }
+            if (!placed) {
+                PageState page;
+                page.shelfY = 0;
+                page.shelfHeight = 0;
+                page.cursorX = 0;
+                page.usedWidth = 0;
+                page.usedHeight = 0;
+                page.dedicated = width > pageSize || height > pageSize;
+                if (page.dedicated) {
+                    page.usedWidth = width;
+                    page.usedHeight = height;
+                }
+                else {
+                    placeOnPage(page, width, height, x, y);
+                }
+                placement.page = pages.size();
+                pages.push_back(page);
+            }
+            placement.x = x + padding;
+            placement.y = y + padding;
+        }
+    }
+
+    void AtlasPacker::clear() {
+        placements.clear();
+        pages.clear();
+    }
+
+    const AtlasPlacement& AtlasPacker::getPlacement(unsigned int index) const {
+        return placements[index];
+    }
+
+    unsigned int AtlasPacker::getPlacementCount() const {
+        return placements.size();
+    }
+
+    unsigned int AtlasPacker::getPageCount() const {
+        return pages.size();
+    }
+
+    unsigned int AtlasPacker::getPageWidth(unsigned int page) const {
+        return pages[page].usedWidth;
+    }
+
+    unsigned int AtlasPacker::getPageHeight(unsigned int page) const {
+        return pages[page].usedHeight;
+    }
+
+    unsigned int AtlasPacker::getPadding() const {
+        return padding;
+    }
+
+}
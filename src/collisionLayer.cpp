@@ -0,0 +1,118 @@
+#include "collisionLayer.hpp"
+#include <algorithm>
+
+namespace Game {
+
+    CollisionLayer::CollisionLayer() {
+
+    }
+
+    CollisionLayer::CellRange CollisionLayer::getCellRange(const Rect& rect) {
+        CellRange range;
+        range.minX = rect.topLeft.x >> CELL_SHIFT;
+        range.minY = rect.topLeft.y >> CELL_SHIFT;
+        range.maxX = (rect.topLeft.x + rect.width) >> CELL_SHIFT;
+        range.maxY = (rect.topLeft.y + rect.height) >> CELL_SHIFT;
+        return range;
+    }
+
+    int64_t CollisionLayer::getPageKey(int pageX, int pageY) {
+        return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(pageX)) << 32) | static_cast<uint32_t>(pageY));
+    }
+
+    uint64_t CollisionLayer::getRowMask(int pageX, int minX, int maxX) {
+        int pageStart = pageX * PAGE_CELLS;
+        int first = std::max(minX - pageStart, 0);
+        int last = std::min(maxX - pageStart, PAGE_CELLS - 1);
+        uint64_t upTo = (last == PAGE_CELLS - 1) ? ~static_cast<uint64_t>(0) : ((static_cast<uint64_t>(1) << (last + 1)) - 1);
+        uint64_t from = ~((static_cast<uint64_t>(1) << first) - 1);
+        return upTo & from;
+    }
+
+    void CollisionLayer::clear() {
+        pages.clear();
+    }
+
+    void CollisionLayer::fill(const Rect& rect) {
+        CellRange range = getCellRange(rect);
+        for (int pageY = range.minY >> PAGE_SHIFT; pageY <= range.maxY >> PAGE_SHIFT; pageY++) {
+            int firstRow = std::max(range.minY - pageY * PAGE_CELLS, 0);
+            int lastRow = std::min(range.maxY - pageY * PAGE_CELLS, PAGE_CELLS - 1);
+            for (int pageX = range.minX >> PAGE_SHIFT; pageX <= range.maxX >> PAGE_SHIFT; pageX++) {
+                std::unordered_map<int64_t, Page>::iterator page = pages.find(getPageKey(pageX, pageY));
+                if (page == pages.end()) {
+                    page = pages.insert(std::make_pair(getPageKey(pageX, pageY), Page())).first;
+                    std::fill(page->second.rows, page->second.rows + PAGE_CELLS, 0);
+                }
+                uint64_t mask = getRowMask(pageX, range.minX, range.maxX);
+                for (int row = firstRow; row <= lastRow; row++) {
+                    page->second.rows[row] |= mask;
+                }
+            }
+        }
+    }
+
+    void CollisionLayer::clearArea(const Rect& rect) {
+        CellRange range = getCellRange(rect);
+        for (int pageY = range.minY >> PAGE_SHIFT; pageY <= range.maxY >> PAGE_SHIFT; pageY++) {
+            int firstRow = std::max(range.minY - pageY * PAGE_CELLS, 0);
+            int lastRow = std::min(range.maxY - pageY * PAGE_CELLS, PAGE_CELLS - 1);
+            for (int pageX = range.minX >> PAGE_SHIFT; pageX <= range.maxX >> PAGE_SHIFT; pageX++) {
+                std::unordered_map<int64_t, Page>::iterator page = pages.find(getPageKey(pageX, pageY));
+                if (page == pages.end()) {
+                    continue;
+                }
+                uint64_t mask = getRowMask(pageX, range.minX, range.maxX);
+                bool empty = true;
+                for (int row = 0; row < PAGE_CELLS; row++) {
+                    if (row >= firstRow && row <= lastRow) {
+                        page->second.rows[row] &= ~mask;
+                    }
+                    empty = empty && page->second.rows[row] == 0;
+                }
+                if (empty) {
+                    pages.erase(page);
+                }
+            }
+        }
+    }
+
+    bool CollisionLayer::occupied(const Vector& point) const {
+        int cellX = point.x >> CELL_SHIFT;
+        int cellY = point.y >> CELL_SHIFT;
+        std::unordered_map<int64_t, Page>::const_iterator page = pages.find(getPageKey(cellX >> PAGE_SHIFT, cellY >> PAGE_SHIFT));
+        if (page == pages.end()) {
+            return false;
+        }
+        return (page->second.rows[cellY & (PAGE_CELLS - 1)] >> (cellX & (PAGE_CELLS - 1))) & 1;
+    }
+
+    bool CollisionLayer::intersects(const Rect& rect) const {
+        if (pages.empty()) {
+            return false;
+        }
+        CellRange range = getCellRange(rect);
+        for (int pageY = range.minY >> PAGE_SHIFT; pageY <= range.maxY >> PAGE_SHIFT; pageY++) {
+            int firstRow = std::max(range.minY - pageY * PAGE_CELLS, 0);
+            int lastRow = std::min(range.maxY - pageY * PAGE_CELLS, PAGE_CELLS - 1);
+            for (int pageX = range.minX >> PAGE_SHIFT; pageX <= range.maxX >> PAGE_SHIFT; pageX++) {
+                std::unordered_map<int64_t, Page>::const_iterator page = pages.find(getPageKey(pageX, pageY));
+                if (page == pages.end()) {
+                    continue;
+                }
+                uint64_t mask = getRowMask(pageX, range.minX, range.maxX);
+                for (int row = firstRow; row <= lastRow; row++) {
+                    if (page->second.rows[row] & mask) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    unsigned int CollisionLayer::getMemoryBytes() const {
+        return pages.size() * sizeof(Page);
+    }
+
+}
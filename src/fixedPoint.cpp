@@ -0,0 +1,94 @@
+#include "fixedPoint.hpp"
+
+namespace Game {
+
+    namespace {
+
+        const int QUARTER_TURN = ANGLES_PER_TURN / 4;
+
+        struct SineTable {
+            int32_t values[QUARTER_TURN + 1];
+        };
+
+        constexpr double taylorSin(double x) {
+            double term = x;
+            double sum = x;
+            for (int i = 1; i < 24; i++) {
+                term *= -x * x / ((2 * i) * (2 * i + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr SineTable makeSineTable() {
+            SineTable table = {};
+            for (int i = 0; i <= QUARTER_TURN; i++) {
+                double radians = 3.14159265358979323846 / 2 * i / QUARTER_TURN;
+                table.values[i] = static_cast<int32_t>(taylorSin(radians) * Fixed::ONE + 0.5);
+            }
+            return table;
+        }
+
+        constexpr SineTable SINE_TABLE = makeSineTable();
+
+    }
+
+    int degreesToAngle(int degrees) {
+        int64_t scaled = static_cast<int64_t>(degrees) * ANGLES_PER_TURN;
+        if (scaled >= 0) {
+            return static_cast<int>((scaled + 180) / 360);
+        }
+        return static_cast<int>((scaled - 180) / 360);
+    }
+
+    Fixed fixedSin(int angle) {
+        int wrapped = angle & (ANGLES_PER_TURN - 1);
+        int quadrant = wrapped / QUARTER_TURN;
+        int offset = wrapped % QUARTER_TURN;
+        switch (quadrant) {
+            case 0:
+                return Fixed::fromRaw(SINE_TABLE.values[offset]);
+            case 1:
+                return Fixed::fromRaw(SINE_TABLE.values[QUARTER_TURN - offset]);
+            case 2:
+                return Fixed::fromRaw(-SINE_TABLE.values[offset]);
+            default:
+                return Fixed::fromRaw(-SINE_TABLE.values[QUARTER_TURN - offset]);
+        }
+    }
+
+    Fixed fixedCos(int angle) {
+        return fixedSin(angle + QUARTER_TURN);
+    }
+
+    Fixed fixedSqrt(int64_t value) {
+        if (value <= 0) {
+            return Fixed();
+        }
+        return Fixed::fromRaw(static_cast<int32_t>(integerSqrt(value << 16) << (Fixed::FRACTION_BITS - 8)));
+    }
+
+    int64_t integerSqrt(int64_t value) {
+        if (value <= 0) {
+            return 0;
+        }
+        uint64_t remainder = static_cast<uint64_t>(value);
+        uint64_t root = 0;
+        uint64_t bit = static_cast<uint64_t>(1) << 62;
+        while (bit > remainder) {
+            bit >>= 2;
+        }
+        while (bit != 0) {
+            if (remainder >= root + bit) {
+                remainder -= root + bit;
+                root = (root >> 1) + bit;
+            }
+            else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return static_cast<int64_t>(root);
+    }
+
+}
@@ -4,10 +4,17 @@ namespace Main {
 
     GameInstance::GameInstance() {
         frameClock = sf::Clock();
-        map = Game::Map();
-        entityTemplates = std::map<std::string, Game::EntityTemplate>();
+        currentTick = 0;
+        eventCursor = 0;
+        lastDispatchedTick = -1;
+        viewingSharedRing = false;
+        lastSharedSequence = 0;
+        sharedLatencyTotal = 0;
+        sharedLatencySamples = 0;
+        tickRequested = false;
+        tickFinished = false;
+        simulationStopping = false;
         sf::RenderWindow window;
-        textureSets = std::map<std::string, std::map<std::string, std::vector<sf::Texture>>>();
         entityRenderers = std::vector<Rendering::EntityRenderer>();
         animations = std::vector<Rendering::Animation>();
         backgrounds = std::vector<Rendering::Background>();
@@ -16,7 +23,11 @@ namespace Main {
         keyHandlers = std::vector<IO::KeyHandler*>();
         mouseHandlers = std::vector<IO::MouseHandler*>();
         exitGame = false;
-        absoluteBackgroundTextures = std::map<std::string, std::vector<sf::Texture>>();
+        assetsReported = false;
+        playerTextureSet = Rendering::AssetRegistry::NONE;
+        dummyTextureSet = Rendering::AssetRegistry::NONE;
+        idleState = Rendering::AssetRegistry::NONE;
+        hitState = Rendering::AssetRegistry::NONE;
         videoModes = std::vector<sf::VideoMode>();
     }
 
@@ -58,73 +69,45 @@ namespace Main {
         camera.setPos(Game::Vector(0, 0));
     }
 
+    void GameInstance::indexStateSequences(unsigned int textureSet) {
+        if (textureSet >= stateSequences.size()) {
+            stateSequences.resize(textureSet + 1);
+        }
+        stateSequences[textureSet].idle = registry.getSequence(textureSet, idleState);
+        stateSequences[textureSet].hit = registry.getSequence(textureSet, hitState);
+    }
+
     void GameInstance::loadTextureSetFromPath(std::string setPath, std::string name) {
-        std::map<std::string, std::vector<sf::Texture>> textureSet;
+        unsigned int textureSet = registry.addSet(Rendering::AssetEntry::KIND::TEXTURE_SET, name, Rendering::EntityRenderer::stateTextureNames.size());
+        indexStateSequences(textureSet);
+        std::vector<std::string> paths;
+        std::vector<unsigned int> targets;
         for (std::string currentState : Rendering::EntityRenderer::stateTextureNames) {
-            std::cout << "Attempting to load " << name + " " + currentState + " texture set." << std::endl;
-            std::vector<sf::Texture> frameSet;
-            for (unsigned int i = 0;; i++) {
-                std::string fileName = setPath + "/"  + currentState + "/" + std::to_string(i) + ".png";
-                std::ifstream file(fileName);
-                if (file) {
-                    sf::Texture texture;
-                    texture.loadFromFile(fileName);
-                    frameSet.push_back(texture);
-                    std::cout << "Loaded " << fileName << " successfully." << std::endl;
-                }
-                else {
-                    break;
-                }
+            unsigned int sequence = registry.getSequence(textureSet, registry.findState(currentState));
+            if (sequence == Rendering::AssetRegistry::NONE) {
+                continue;
             }
-            textureSet[currentState] = frameSet;
+            paths.push_back(setPath + "/" + currentState);
+            targets.push_back(sequence);
         }
-        textureSets[name] = textureSet;
+        residency.trackSet(textureSet, assetLoader.requestSequences(paths, targets));
+    }
+
+    void GameInstance::loadFrameSet(Rendering::AssetEntry::KIND kind, std::string path, std::string name) {
+        unsigned int frameSet = registry.addSet(kind, name, 1);
+        residency.trackSet(frameSet, assetLoader.requestSequences(std::vector<std::string>(1, path), std::vector<unsigned int>(1, registry.getSequence(frameSet, 0))));
     }
 
     void GameInstance::loadAbsoluteBackgroundTexturesFromPath(std::string path, std::string name) {
-        std::cout << "Attempting to load " + name + " absolute background texture set." << std::endl;
-        std::vector<sf::Texture> textureSet;
-        for (unsigned int i = 0;; i++) {
-            std::string filePath = path + "/" + std::to_string(i) + ".png";
-            std::ifstream file(filePath);
-            if (file) {
-                sf::Texture texture;
-                texture.loadFromFile(filePath);
-                textureSet.push_back(texture);
-                std::cout << "Loaded " << filePath << " successfully." << std::endl;
-            }
-            else {
-                break;
-            }
-        }
-        absoluteBackgroundTextures[name] = textureSet;
+        loadFrameSet(Rendering::AssetEntry::KIND::ABSOLUTE_BACKGROUND, path, name);
     }
 
     void GameInstance::loadAnimationSet(std::string path, std::string name) {
-        std::cout << "Attempting to load " + name + " animation set." << std::endl;
-        std::vector<sf::Texture> textureSet;
-        for (unsigned int i = 0;; i++) {
-            std::string filePath = path + "/" + std::to_string(i) + ".png";
-            std::ifstream file(filePath);
-            if (file) {
-                sf::Texture texture;
-                texture.loadFromFile(filePath);
-                textureSet.push_back(texture);
-                std::cout << "Loaded " << filePath << " successfully." << std::endl;
-            }
-            else {
-                break;
-            }
-        }
-        attackAnimations[name] = textureSet;
+        loadFrameSet(Rendering::AssetEntry::KIND::ANIMATION, path, name);
     }
 
     void GameInstance::loadBackgroundTextureFromPath(std::string path, std::string name) {
-        sf::Texture texture;
-        if (texture.loadFromFile(path)) {
-            backgroundTextures[name] = texture;
-            backgroundTextures[name].setRepeated(true);
-        }
+        assetLoader.requestTexture(path, &backgroundTextures[name]);
     }
 
     void GameInstance::loadFontFromPath(std::string path, std::string name) {
@@ -134,40 +117,174 @@ namespace Main {
         }
     }
 
+    void GameInstance::loadAssetsFromManifest() {
+        Rendering::AssetManifest manifest;
+        if (!manifest.loadFromFile("resources/assets.txt")) {
+            std::cout << "Could not load asset manifest: " << manifest.getLastError() << std::endl;
+            return;
+        }
+        for (const Rendering::AssetEntry& entry : manifest.getEntries()) {
+            std::string path = "resources/" + entry.path;
+            switch (entry.kind) {
+                case Rendering::AssetEntry::KIND::TEXTURE_SET:
+                    loadTextureSetFromPath(path, entry.name);
+                    break;
+                case Rendering::AssetEntry::KIND::ANIMATION:
+                    loadAnimationSet(path, entry.name);
+                    break;
+                case Rendering::AssetEntry::KIND::BACKGROUND:
+                    loadBackgroundTextureFromPath(path, entry.name);
+                    break;
+                case Rendering::AssetEntry::KIND::ABSOLUTE_BACKGROUND:
+                    loadAbsoluteBackgroundTexturesFromPath(path, entry.name);
+                    break;
+                case Rendering::AssetEntry::KIND::FONT:
+                    loadFontFromPath(path, entry.name);
+                    break;
+            }
+        }
+    }
+
+    void GameInstance::loadAssetsFromPack() {
+        const std::vector<Rendering::AssetPack::PageRow>& pages = assetPack.getPages();
+        const std::vector<Rendering::AssetPack::FrameRow>& frameRows = assetPack.getFrames();
+        const std::vector<Rendering::AssetPack::SetEntry>& sets = assetPack.getSets();
+        unsigned int first = 0;
+        while (first < sets.size()) {
+            unsigned int last = first + 1;
+            while (last < sets.size() && sets[last].kind == sets[first].kind && sets[last].name == sets[first].name) {
+                last++;
+            }
+            if (sets[first].kind == Rendering::AssetEntry::KIND::BACKGROUND) {
+                if (sets[first].frameCount > 0) {
+                    unsigned int page = frameRows[sets[first].firstFrame].page;
+                    Rendering::AssetLoader::PageData pageData;
+                    pageData.pixels = assetPack.getPagePixels(page);
+                    pageData.width = pages[page].width;
+                    pageData.height = pages[page].height;
+                    assetLoader.requestTextureUpload(pageData, &backgroundTextures[sets[first].name]);
+                }
+                first = last;
+                continue;
+            }
+
+            if (sets[first].kind == Rendering::AssetEntry::KIND::FONT) {
+                first = last;
+                continue;
+            }
+
+            bool textureSet = sets[first].kind == Rendering::AssetEntry::KIND::TEXTURE_SET;
+            unsigned int registered = registry.addSet(sets[first].kind, sets[first].name, textureSet ? Rendering::EntityRenderer::stateTextureNames.size() : 1);
+            if (textureSet) {
+                indexStateSequences(registered);
+            }
+            std::map<unsigned int, unsigned int> localPages;
+            std::vector<Rendering::AssetLoader::PageData> groupPages;
+            std::vector<std::vector<Rendering::AssetLoader::FrameData>> groupFrames;
+            std::vector<unsigned int> targets;
+            for (unsigned int i = first; i < last; i++) {
+                const Rendering::AssetPack::SetEntry& set = sets[i];
+                unsigned int sequence = registry.getSequence(registered, textureSet ? registry.findState(set.state) : 0);
+                if (sequence == Rendering::AssetRegistry::NONE) {
+                    continue;
+                }
+                targets.push_back(sequence);
+                groupFrames.push_back(std::vector<Rendering::AssetLoader::FrameData>());
+                for (unsigned int j = set.firstFrame; j < set.firstFrame + set.frameCount; j++) {
+                    const Rendering::AssetPack::FrameRow& row = frameRows[j];
+                    std::map<unsigned int, unsigned int>::iterator localPage = localPages.find(row.page);
+                    if (localPage == localPages.end()) {
+                        Rendering::AssetLoader::PageData pageData;
+                        pageData.pixels = assetPack.getPagePixels(row.page);
+                        pageData.width = pages[row.page].width;
+                        pageData.height = pages[row.page].height;
+                        localPage = localPages.insert(std::make_pair(row.page, static_cast<unsigned int>(groupPages.size()))).first;
+                        groupPages.push_back(pageData);
+                    }
+                    Rendering::AssetLoader::FrameData frame;
+                    frame.page = localPage->second;
+                    frame.rect = sf::IntRect(row.x, row.y, row.width, row.height);
+                    groupFrames.back().push_back(frame);
+                }
+            }
+            residency.trackSet(registered, assetLoader.requestUpload(groupPages, groupFrames, targets));
+            first = last;
+        }
+        for (const Rendering::AssetPack::FontEntry& font : assetPack.getFonts()) {
+            fonts[font.name].loadFromMemory(font.data, font.size);
+        }
+    }
+
     void GameInstance::initializeTextures() {
-        loadTextureSetFromPath("resources/textures/player", "player");
-        loadTextureSetFromPath("resources/textures/dummy", "dummy");
-        loadBackgroundTextureFromPath("resources/textures/brick.png", "brick");
-        loadFontFromPath("resources/fonts/arial.ttf", "arial");
-        loadAbsoluteBackgroundTexturesFromPath("resources/textures/starry", "starry");
-        loadAnimationSet("resources/textures/defaultattack", "default");
+        assetClock.restart();
+        assetsReported = false;
+        for (std::string currentState : Rendering::EntityRenderer::stateTextureNames) {
+            registry.internState(currentState);
+        }
+        idleState = registry.findState("idle");
+        hitState = registry.findState("hit");
+        assetLoader.start(&atlas, &registry, Rendering::AssetLoader::getDefaultWorkerCount());
+        residency.setLoader(&assetLoader);
+        bool fromPack = assetPack.open("resources/assets.pack");
+        if (fromPack) {
+            loadAssetsFromPack();
+        }
+        else {
+            loadAssetsFromManifest();
+        }
+        playerTextureSet = registry.findSet(Rendering::AssetEntry::KIND::TEXTURE_SET, "player");
+        dummyTextureSet = registry.findSet(Rendering::AssetEntry::KIND::TEXTURE_SET, "dummy");
+        std::cout << "Queued " << assetLoader.getRequestCount() << " asset requests from " << (fromPack ? "resources/assets.pack" : "loose files") << " on " << assetLoader.getWorkerCount() << " workers in " << assetClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
+
+    void GameInstance::tickAssetLoading() {
+        assetLoader.update(UPLOAD_BUDGET_BYTES);
+        if (!assetsReported && assetLoader.isFinished()) {
+            assetsReported = true;
+            std::cout << "Loaded " << registry.getSetCount() << " sets on " << atlas.getResidentPageCount() << " atlas pages (" << assetLoader.getUploadedBytes() / 1024 << " KiB) in " << assetClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+        }
     }
 
     void GameInstance::initializeIO() {
         std::map<sf::Keyboard::Key, Game::Vector> wasdMovementMap = {{sf::Keyboard::W, Game::Vector(0, -1)}, {sf::Keyboard::A, Game::Vector(-1, 0)}, {sf::Keyboard::S, Game::Vector(0, 1)}, {sf::Keyboard::D, Game::Vector(1, 0)}};
-        keyHandlers.push_back(new IO::EntityMovementKeyHandler(wasdMovementMap, &map, 0));
+        keyHandlers.push_back(new IO::EntityMovementKeyHandler(wasdMovementMap, &map, &pendingIntents, 0));
 
-        mouseHandlers.push_back(new IO::PlayerAttackMouseHandler(0, &map, &camera, &window, &animations, &attackAnimations["default"]));
+        mouseHandlers.push_back(new IO::PlayerAttackMouseHandler(0, &map, &pendingIntents, &camera, &window, &animations, &registry, registry.findSet(Rendering::AssetEntry::KIND::ANIMATION, "default")));
     }
 
-    void GameInstance::initializeGameLogic() {
-        Game::EntityStats defaultStats;
-        Game::Rect defaultHitbox(Game::Vector(0, 0), 100, 100);
-
-        Game::Rect testDummyHitbox(Game::Vector(100, 100), 100, 100);
-
-        entityTemplates["player"] = Game::EntityTemplate(defaultStats, defaultHitbox, NULL, Game::Team::TEAM::PLAYER);
-        entityTemplates["testDummy"] = Game::EntityTemplate(defaultStats, testDummyHitbox, NULL, Game::Team::TEAM::ENEMY);
+    void GameInstance::initializePrefabs() {
+        if (!prefabs.loadFromFile("resources/prefabs.txt")) {
+            std::cout << "Could not load prefabs: " << prefabs.getLastError() << std::endl;
+        }
+        prefabTextureSets.assign(prefabs.getCount() + 1, static_cast<unsigned int>(Rendering::AssetRegistry::NONE));
+        for (unsigned int prefabID = 1; prefabID <= prefabs.getCount(); prefabID++) {
+            prefabTextureSets[prefabID] = registry.findSet(Rendering::AssetEntry::KIND::TEXTURE_SET, prefabs.get(static_cast<uint8_t>(prefabID))->textureSet);
+        }
+    }
 
+    void GameInstance::initializeGameLogic() {
+        initializePrefabs();
         map.setPlayableArea(Game::Rect(Game::Vector(-2000, -2000), 4000, 4000));
-        map.createEntity(entityTemplates["player"]);
-        map.createEntity(entityTemplates["testDummy"]);
+        map.setEntityReordering(true);
+        const Game::Prefab* player = prefabs.find("player");
+        const Game::Prefab* testDummy = prefabs.find("testDummy");
+        if (!player || !testDummy) {
+            std::cout << "Prefabs are missing player or testDummy" << std::endl;
+        }
+        else {
+            map.createEntities(*player, 1, Game::SpawnPlacement::grid(Game::Vector(0, 0), 1, Game::Vector(0, 0)));
+            map.createEntities(*testDummy, 1, Game::SpawnPlacement::grid(Game::Vector(100, 100), 1, Game::Vector(0, 0)));
+        }
+        worldStreamer.start(&map, "resources/world/");
+        worldStreamer.markResident(Game::Rect(Game::Vector(-2000, -2000), 4000, 4000));
+        publishSnapshot();
     }
 
     void GameInstance::initializeRendering() {
+        snapshots.acquireFront();
         camera.setViewBox(Game::Rect(Game::Vector(0, 0), window.getSize().x, window.getSize().y));
-        Rendering::EntityRenderer playerRenderer = Rendering::EntityRenderer(Rendering::EntityEventParser(&map, 0), &camera, &window, &textureSets["player"], 30);
-        entityRenderers.push_back(playerRenderer);
+        Rendering::EntityRenderer playerRenderer = Rendering::EntityRenderer(Rendering::EntityEventParser(&snapshots, 0), &camera, &window, &registry, playerTextureSet, getStateSequences(playerTextureSet), 30);
+        addEntityRenderer(playerRenderer);
         backgrounds.push_back(Rendering::Background(&backgroundTextures["brick"], &camera, &window, Game::Rect(Game::Vector(-2000, -2000), 4000, 4000)));
         for (unsigned int i = 0; i < 210; i++) {
             lastFrameTimes.push_back(TIME_PER_FRAME);
@@ -180,10 +297,10 @@ namespace Main {
         fpsText.setPosition(sf::Vector2<float>(0, 0));
         fpsText.setStyle(sf::Text::Bold);
 
-        absoluteBackground = Rendering::AbsoluteBackground(&absoluteBackgroundTextures["starry"], &window, 10);
+        absoluteBackground = Rendering::AbsoluteBackground(&registry, registry.findSet(Rendering::AssetEntry::KIND::ABSOLUTE_BACKGROUND, "starry"), &window, 10);
         absoluteBackground.setLooping(true);
 
-        entityRenderers.push_back(Rendering::EntityRenderer(Rendering::EntityEventParser(&map, 1), &camera, &window, &textureSets["dummy"], 15));
+        addEntityRenderer(Rendering::EntityRenderer(Rendering::EntityEventParser(&snapshots, 1), &camera, &window, &registry, dummyTextureSet, getStateSequences(dummyTextureSet), 15));
 
     }
 
@@ -214,20 +331,100 @@ namespace Main {
         }
     }
 
-    void GameInstance::cullRenderers() {
-        std::vector<std::vector<Rendering::EntityRenderer>::iterator> needsErasing;
-        for (std::vector<Rendering::EntityRenderer>::iterator currentRenderer = entityRenderers.begin(); currentRenderer != entityRenderers.end(); currentRenderer++) {
-            if (!currentRenderer->getEntityEventParser().entityValid()) {
-                needsErasing.push_back(currentRenderer);
+    unsigned int GameInstance::getTextureSet(const Rendering::RenderSnapshot& snapshot, unsigned int entityID) {
+        const Rendering::EntitySnapshot* entitySnapshot = snapshot.findEntity(entityID);
+        if (entitySnapshot && entitySnapshot->prefab < prefabTextureSets.size() && prefabTextureSets[entitySnapshot->prefab] != Rendering::AssetRegistry::NONE) {
+            return prefabTextureSets[entitySnapshot->prefab];
+        }
+        return entityID == snapshot.getPlayerID() ? playerTextureSet : dummyTextureSet;
+    }
+
+    Rendering::StateSequences GameInstance::getStateSequences(unsigned int textureSet) const {
+        if (textureSet < stateSequences.size()) {
+            return stateSequences[textureSet];
+        }
+        return Rendering::StateSequences();
+    }
+
+    void GameInstance::addEntityRenderer(const Rendering::EntityRenderer& renderer) {
+        entityRenderers.push_back(renderer);
+        rendererIndices[entityRenderers.back().getEntityEventParser().getEntityID()] = entityRenderers.size() - 1;
+    }
+
+    void GameInstance::indexRenderers() {
+        rendererIndices.clear();
+        for (unsigned int i = 0; i < entityRenderers.size(); i++) {
+            rendererIndices[entityRenderers[i].getEntityEventParser().getEntityID()] = i;
+        }
+    }
+
+    void GameInstance::resyncRenderers(const Rendering::RenderSnapshot& snapshot) {
+        for (unsigned int i = 0; i < snapshot.getEntityCount(); i++) {
+            const Rendering::EntitySnapshot& entitySnapshot = snapshot.getEntities()[i];
+            if (rendererIndices.find(entitySnapshot.id) == rendererIndices.end()) {
+                unsigned int textureSet = getTextureSet(snapshot, entitySnapshot.id);
+                addEntityRenderer(Rendering::EntityRenderer(Rendering::EntityEventParser(NULL, entitySnapshot.id), &camera, &window, &registry, textureSet, getStateSequences(textureSet), 15));
+            }
+        }
+        for (Rendering::EntityRenderer& renderer : entityRenderers) {
+            Game::MapEvent event;
+            event.entityID = renderer.getEntityEventParser().getEntityID();
+            event.amount = 0;
+            const Rendering::EntitySnapshot* entitySnapshot = snapshot.findEntity(event.entityID);
+            if (entitySnapshot) {
+                event.type = Game::MapEvent::TYPE::MOVED;
+                event.hitbox = entitySnapshot->hitbox;
             }
+            else {
+                event.type = Game::MapEvent::TYPE::REMOVED;
+            }
+            renderer.onEvent(event);
+        }
+    }
+
+    void GameInstance::dispatchEvents(const Rendering::RenderSnapshot& snapshot) {
+        if (static_cast<int>(snapshot.getTick()) == lastDispatchedTick) {
+            return;
+        }
+        lastDispatchedTick = snapshot.getTick();
+        bool entitiesRemoved = false;
+        for (unsigned int i = 0; i < snapshot.getEventCount(); i++) {
+            const Game::MapEvent& event = snapshot.getEvents()[i];
+            std::unordered_map<unsigned int, unsigned int>::iterator found = rendererIndices.find(event.entityID);
+            if (found != rendererIndices.end()) {
+                entityRenderers[found->second].onEvent(event);
+            }
+            else if (event.type == Game::MapEvent::TYPE::SPAWNED) {
+                unsigned int textureSet = getTextureSet(snapshot, event.entityID);
+                addEntityRenderer(Rendering::EntityRenderer(Rendering::EntityEventParser(NULL, event.entityID), &camera, &window, &registry, textureSet, getStateSequences(textureSet), 15));
+                entityRenderers.back().onEvent(event);
+            }
+            if (event.type == Game::MapEvent::TYPE::DIED || event.type == Game::MapEvent::TYPE::REMOVED) {
+                entitiesRemoved = true;
+            }
+        }
+        if (!snapshot.hasCompleteEvents()) {
+            resyncRenderers(snapshot);
+            entitiesRemoved = true;
         }
-        for (std::vector<Rendering::EntityRenderer>::iterator erasing : needsErasing) {
-            entityRenderers.erase(erasing);
+        if (entitiesRemoved) {
+            cullRenderers();
         }
     }
 
+    void GameInstance::cullRenderers() {
+        std::vector<Rendering::EntityRenderer> keptRenderers;
+        for (Rendering::EntityRenderer& renderer : entityRenderers) {
+            if (renderer.getEntityEventParser().entityValid()) {
+                keptRenderers.push_back(renderer);
+            }
+        }
+        entityRenderers.swap(keptRenderers);
+        indexRenderers();
+    }
+
     void GameInstance::drawBackgrounds() {
-        for (Rendering::Background background : backgrounds) {
+        for (Rendering::Background& background : backgrounds) {
             background.updateBackgroundSprite();
             window.draw(background.getSprite());
         }
@@ -236,8 +433,10 @@ namespace Main {
     void GameInstance::drawEntities() {
         for (Rendering::EntityRenderer& currentRenderer : entityRenderers) {
             currentRenderer.updateEntitySprite();
-            window.draw(currentRenderer.getSprite());
+            residency.useSet(currentRenderer.getTextureSet(), currentRenderer.getSprite().getGlobalBounds());
+            spriteBatch.add(currentRenderer.getSprite());
         }
+        spriteBatch.flush(window);
     }
 
     void GameInstance::cullAnimations() {
@@ -255,50 +454,269 @@ namespace Main {
     void GameInstance::drawAnimations() {
         for (Rendering::Animation& animation : animations) {
             animation.tick();
-            window.draw(animation.getSprite());
+            residency.useSet(animation.getAnimationSet(), animation.getSprite().getGlobalBounds());
+            spriteBatch.add(animation.getSprite());
         }
+        spriteBatch.flush(window);
     }
 
-    void GameInstance::updateFPSText() {
-        fpsText.setString(std::to_string(static_cast<int>(std::ceil(getAvgFPS()))));
+    void GameInstance::updateFPSText(const Rendering::RenderSnapshot& snapshot) {
+        const Game::MapStats& mapStats = snapshot.getMapStats();
+        std::string awakeText = std::to_string(mapStats.awakeEntities) + "/" + std::to_string(mapStats.awakeEntities + mapStats.sleepingEntities) + " awake";
+        std::string batchText = std::to_string(spriteBatch.getQuadCount()) + " sprites, " + std::to_string(spriteBatch.getDrawCalls()) + " draw calls";
+        std::string fpsString = std::to_string(static_cast<int>(std::ceil(getAvgFPS()))) + "\n" + awakeText + "\n" + batchText;
+        if (viewingSharedRing && sharedLatencySamples > 0) {
+            fpsString += "\n" + std::to_string(sharedLatencyTotal / sharedLatencySamples) + " ms latency";
+        }
+        fpsString += "\n" + std::to_string(residency.getResidentBytes() / (1024 * 1024)) + "/" + std::to_string(residency.getBudget() / (1024 * 1024)) + " MB textures, " + std::to_string(residency.getEvictionCount()) + " evictions, " + std::to_string(residency.getMissStallCount()) + " miss stalls";
+        if (!assetsReported) {
+            fpsString += "\n" + std::to_string(assetLoader.getReadyCount()) + "/" + std::to_string(assetLoader.getRequestCount()) + " assets";
+        }
+        fpsText.setString(fpsString);
+    }
+
+    const Rendering::RenderSnapshot& GameInstance::acquireRenderSnapshot() {
+        if (!viewingSharedRing) {
+            return snapshots.acquireFront();
+        }
+        if (!sharedRing.isOpen() || sharedStaleClock.getElapsedTime().asSeconds() > SHARED_STALE_SECONDS) {
+            sharedSnapshot.clear();
+            lastSharedSequence = 0;
+            sharedRing.open(sharedRingName);
+            sharedStaleClock.restart();
+        }
+        const Rendering::SnapshotSlot* slot = sharedRing.isOpen() ? sharedRing.acquireLatest() : NULL;
+        if (slot) {
+            if (slot->sequence != lastSharedSequence) {
+                sharedLatencyTotal += (Rendering::SnapshotRing::getTimestamp() - slot->publishedNanoseconds) / 1000000.0;
+                sharedLatencySamples++;
+                sharedStaleClock.restart();
+            }
+            bool contiguous = lastSharedSequence != 0 && (slot->sequence == lastSharedSequence || slot->sequence == lastSharedSequence + 1);
+            sharedSnapshot.view(sharedRing, *slot, contiguous);
+            lastSharedSequence = slot->sequence;
+            syncViewerPlayer(sharedSnapshot);
+        }
+        return sharedSnapshot;
+    }
+
+    void GameInstance::syncViewerPlayer(const Rendering::RenderSnapshot& snapshot) {
+        const Rendering::EntitySnapshot* player = snapshot.findEntity(snapshot.getPlayerID());
+        Game::Entity* proxy = map.getEntityWithID(map.getPlayerID());
+        if (player && proxy) {
+            Game::Rect hitbox = proxy->getHitbox();
+            proxy->moveWithoutModifier(Game::Vector(player->hitbox.topLeft.x - hitbox.topLeft.x, player->hitbox.topLeft.y - hitbox.topLeft.y));
+        }
     }
 
     void GameInstance::tickRendering() {
-        cullRenderers();
+        tickAssetLoading();
+        const Rendering::RenderSnapshot& snapshot = acquireRenderSnapshot();
+        dispatchEvents(snapshot);
         cullAnimations();
         window.clear(sf::Color::White);
 
-        camera.centerOn(map.getEntityWithID(0)->getHitbox().getCenter(), window);
+        const Rendering::EntitySnapshot* player = snapshot.findEntity(snapshot.getPlayerID());
+        if (player) {
+            camera.centerOn(player->hitbox.getCenter(), window);
+        }
 
+        sf::FloatRect windowArea(0, 0, window.getSize().x, window.getSize().y);
+        residency.beginFrame(windowArea);
         absoluteBackground.tick();
+        residency.useSet(absoluteBackground.getTextureSet(), windowArea);
         window.draw(absoluteBackground.getSprite());
 
         drawBackgrounds();
+        spriteBatch.begin(windowArea);
         drawEntities();
         drawAnimations();
-        updateFPSText();
+        residency.endFrame();
+        updateFPSText(snapshot);
         window.draw(fpsText);
 
         window.display();
     }
 
+    void GameInstance::publishSnapshot() {
+        if (sharedRing.isOpen()) {
+            sharedRing.publish(map, currentTick, eventCursor);
+            return;
+        }
+        snapshots.getBack().capture(map, currentTick, eventCursor);
+        snapshots.publish();
+    }
+
     void GameInstance::tickGame() {
+        if (!recorder.isRecording()) {
+            worldStreamer.update(streamingView);
+        }
+        for (const Game::Intent& intent : pendingIntents) {
+            intent.apply(map);
+        }
         map.tickAndApplyActions();
+        recorder.recordTick(pendingIntents, map);
+        pendingIntents.clear();
+        currentTick++;
+        publishSnapshot();
+    }
+
+    void GameInstance::runSimulationThread() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(simulationMutex);
+                simulationWake.wait(lock, [this]() {
+                    return simulationStopping || tickRequested;
+                });
+                if (simulationStopping) {
+                    return;
+                }
+                tickRequested = false;
+            }
+            tickGame();
+            {
+                std::lock_guard<std::mutex> lock(simulationMutex);
+                tickFinished = true;
+            }
+            simulationWake.notify_all();
+        }
+    }
+
+    void GameInstance::startSimulationThread() {
+        simulationStopping = false;
+        simulationThread = std::thread(&GameInstance::runSimulationThread, this);
+    }
+
+    void GameInstance::stopSimulationThread() {
+        {
+            std::lock_guard<std::mutex> lock(simulationMutex);
+            simulationStopping = true;
+        }
+        simulationWake.notify_all();
+        if (simulationThread.joinable()) {
+            simulationThread.join();
+        }
+    }
+
+    void GameInstance::requestSimulationTick() {
+        {
+            std::lock_guard<std::mutex> lock(simulationMutex);
+            tickFinished = false;
+            tickRequested = true;
+        }
+        simulationWake.notify_all();
+    }
+
+    void GameInstance::waitForSimulationTick() {
+        std::unique_lock<std::mutex> lock(simulationMutex);
+        simulationWake.wait(lock, [this]() {
+            return tickFinished;
+        });
+    }
+
+    void GameInstance::setTextureBudget(unsigned int megabytes) {
+        residency.setBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+    }
+
+    void GameInstance::record(const std::string& path) {
+        recordingPath = path;
     }
 
     void GameInstance::run() {
         initializeGame();
+        if (!recordingPath.empty()) {
+            recorder.begin(map);
+            std::cout << "World streaming is paused while recording to " << recordingPath << std::endl;
+        }
+        if (PIPELINED_SIMULATION) {
+            startSimulationThread();
+        }
         while (!exitGame) {
             frameClock.restart();
             tickIO();
+            streamingView = camera.getViewBox();
+            if (PIPELINED_SIMULATION) {
+                requestSimulationTick();
+                tickRendering();
+                waitForSimulationTick();
+            }
+            else {
+                tickGame();
+                tickRendering();
+            }
+
+            if (frameClock.getElapsedTime().asSeconds() < TIME_PER_FRAME) {
+                sf::sleep(sf::seconds(TIME_PER_FRAME) - frameClock.getElapsedTime());
+            }
+            addFrameTimeToAvg(frameClock.getElapsedTime().asSeconds());
+        }
+        stopSimulationThread();
+        if (recorder.isRecording() && !recorder.save(recordingPath)) {
+            std::cout << "Failed to write replay to " << recordingPath << std::endl;
+        }
+        worldStreamer.stop();
+    }
+
+    void GameInstance::runSimulation(const std::string& ringName) {
+        if (!sharedRing.create(ringName, SHARED_ENTITY_CAPACITY, SHARED_EVENT_CAPACITY)) {
+            std::cout << "Could not create shared snapshot ring " << ringName << std::endl;
+            return;
+        }
+        initializeGameLogic();
+        sf::Clock reportClock;
+        float tickSeconds = 0;
+        unsigned int reportTicks = 0;
+        while (!exitGame) {
+            frameClock.restart();
+            Game::Intent intent;
+            while (sharedRing.popIntent(intent)) {
+                pendingIntents.push_back(intent);
+            }
             tickGame();
-            tickRendering();
+            tickSeconds += frameClock.getElapsedTime().asSeconds();
+            reportTicks++;
+            if (reportClock.getElapsedTime().asSeconds() >= 1.f) {
+                std::cout << "Tick " << currentTick << ": " << map.getEntities().size() << " entities, " << tickSeconds * 1000.f / reportTicks << " ms per tick and publish" << std::endl;
+                reportClock.restart();
+                tickSeconds = 0;
+                reportTicks = 0;
+            }
+            if (frameClock.getElapsedTime().asSeconds() < TIME_PER_FRAME) {
+                sf::sleep(sf::seconds(TIME_PER_FRAME) - frameClock.getElapsedTime());
+            }
+        }
+        worldStreamer.stop();
+        sharedRing.close();
+    }
 
+    void GameInstance::runViewer(const std::string& ringName) {
+        viewingSharedRing = true;
+        sharedRingName = ringName;
+        initializeVideoModes();
+        initializeWindow();
+        initializeTextures();
+        initializeIO();
+        initializePrefabs();
+        map.setPlayableArea(Game::Rect(Game::Vector(-1000000, -1000000), 2000000, 2000000));
+        map.createEntity(Game::EntityTemplate(Game::EntityStats(), Game::Rect(Game::Vector(0, 0), 100, 100), NULL, Game::Team::TEAM::PLAYER));
+        initializeRendering();
+        while (!exitGame) {
+            frameClock.restart();
+            tickIO();
+            if (sharedRing.isOpen()) {
+                for (const Game::Intent& intent : pendingIntents) {
+                    sharedRing.pushIntent(intent);
+                }
+            }
+            pendingIntents.clear();
+            tickRendering();
             if (frameClock.getElapsedTime().asSeconds() < TIME_PER_FRAME) {
                 sf::sleep(sf::seconds(TIME_PER_FRAME) - frameClock.getElapsedTime());
             }
             addFrameTimeToAvg(frameClock.getElapsedTime().asSeconds());
         }
+        sharedSnapshot.clear();
+        sharedRing.close();
     }
 
 }
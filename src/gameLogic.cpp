@@ -1,118 +1,10 @@
 #include "gameLogic.hpp"
+#include "serialization.hpp"
+#include "prefabs.hpp"
 #include <iostream>
 
 namespace Game {
 
-    float manhattanDistance(Game::Vector p1, Game::Vector p2) {
-        return sqrt(pow((p1.x - p2.x), 2) + pow((p1.y - p2.y), 2));
-    }
-
-    Vector::Vector(int x_a, int y_a) {
-        x = x_a;
-        y = y_a;
-    }
-
-    Vector::Vector(const Vector& vector) {
-        x = vector.x;
-        y = vector.y;
-    }
-
-    Vector::Vector() {
-        x = 0;
-        y = 0;
-    }
-
-    Vector rotatePoint(Vector point, Vector anchor, float angle) {
-        Vector rotated;
-        rotated.x = cos(angle*PI/180) * (point.x - anchor.x) - sin(angle*PI/180) * (point.y - anchor.y) + anchor.x;
-        rotated.y = sin(angle*PI/180) * (point.x - anchor.x) + cos(angle*PI/180) * (point.y - anchor.y) + anchor.y;
-        return rotated;
-    }
-
-    Circle::Circle() {
-        center = Vector(0, 0);
-        radius = 0;
-    }
-
-    Circle::Circle(const Vector& center_a, unsigned int radius_a) {
-        center = Vector(center_a);
-        radius = radius_a;
-    }
-
-    bool Circle::intersects(const Rect& rect) const {
-        bool containsTopLeft = contains(rect.topLeft);
-        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
-        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
-        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
-        return containsTopLeft || containsTopRight || containsBottomLeft || containsBottomRight;
-    }
-
-    bool Circle::contains(const Vector& point) const {
-        return radius >= sqrt(pow((point.x - center.x),2) + pow((point.y - center.y),2));
-    }
-
-    bool Circle::contains(const Rect& rect) const {
-        bool containsTopLeft = contains(rect.topLeft);
-        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
-        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
-        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
-        return containsTopLeft && containsTopRight && containsBottomLeft && containsBottomRight;
-    }
-
-    Rect::Rect() {
-        topLeft = Vector(0, 0);
-        width = 0;
-        height = 0;
-    }
-
-    Rect::Rect(const Vector& topLeft_a, unsigned int width_a, unsigned int height_a) {
-        topLeft = topLeft_a;
-        width = width_a;
-        height = height_a;
-    }
-
-    bool Rect::contains(const Vector& point) const {
-        bool x_bound = (point.x >= topLeft.x && point.x <= topLeft.x + width);
-        bool y_bound = (point.y >= topLeft.y && point.y <= topLeft.y + height);
-        return x_bound && y_bound;
-    }
-
-    bool Rect::contains(const Rect& rect) const {
-        bool containsTopLeft = contains(rect.topLeft);
-        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
-        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
-        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
-        return containsTopLeft && containsTopRight && containsBottomLeft && containsBottomRight;
-    }
-
-    Game::Vector Rect::getCenter() const {
-        if (width <= 0 || height <= 0) {
-            return topLeft;
-        }
-        return Game::Vector(topLeft.x + width / 2, topLeft.y + height / 2);
-    }
-
-    bool Rect::intersects(const Rect& rect) const {
-        bool containsTopLeft = contains(rect.topLeft);
-        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
-        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
-        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
-
-        bool containedTopLeft = rect.contains(topLeft);
-        bool containedTopRight = rect.contains(Vector(topLeft.x + width, topLeft.y));
-        bool containedBottomLeft = rect.contains(Vector(topLeft.x, topLeft.y + height));
-        bool containedBottomRight = rect.contains(Vector(topLeft.x + width, topLeft.y + height));
-
-        bool containsOtherRect = containsTopLeft || containsTopRight || containsBottomLeft || containsBottomRight;
-        bool containedByOtherRect = containedTopLeft || containedTopRight || containedBottomLeft || containedBottomRight;
-
-        return containsOtherRect || containedByOtherRect;
-    }
-
-    bool Rect::operator==(const Rect& rect) const {
-        return topLeft.x == rect.topLeft.x && topLeft.y == rect.topLeft.y && width == rect.width && height == rect.height;
-    }
-
     EntityStats::EntityStats() {
         stats[STAT::MAX_HP] = 50;
         stats[STAT::HP] = 50;
@@ -123,12 +15,12 @@ namespace Game {
         stats[STAT::RNG] = 150;
         stats[STAT::DMG] = 1;
 
-        statModifiers[STAT_MOD::MAX_HP] = 1;
-        statModifiers[STAT_MOD::MAX_STAM] = 1;
-        statModifiers[STAT_MOD::SIGHT] = 1;
-        statModifiers[STAT_MOD::ATK_DELAY] = 1;
-        statModifiers[STAT_MOD::MOVE] = 10;
-        statModifiers[STAT_MOD::DMG] = 1;
+        statModifiers[STAT_MOD::MAX_HP] = Fixed(1);
+        statModifiers[STAT_MOD::MAX_STAM] = Fixed(1);
+        statModifiers[STAT_MOD::SIGHT] = Fixed(1);
+        statModifiers[STAT_MOD::ATK_DELAY] = Fixed(1);
+        statModifiers[STAT_MOD::MOVE] = Fixed(10);
+        statModifiers[STAT_MOD::DMG] = Fixed(1);
     }
 
     EntityStats::EntityStats(const EntityStats& copying) {
@@ -141,7 +33,7 @@ namespace Game {
         for (std::pair<STAT, int> statPair : adding.stats) {
             tempStats.stats[statPair.first] += statPair.second;
         }
-        for (std::pair<STAT_MOD, int> statPair : adding.statModifiers) {
+        for (std::pair<STAT_MOD, Fixed> statPair : adding.statModifiers) {
             tempStats.statModifiers[statPair.first] += statPair.second;
         }
         return tempStats;
@@ -152,7 +44,7 @@ namespace Game {
         for (std::pair<STAT, int> statPair : subtracting.stats) {
             tempStats.stats[statPair.first] -= statPair.second;
         }
-        for (std::pair<STAT_MOD, int> statPair : subtracting.statModifiers) {
+        for (std::pair<STAT_MOD, Fixed> statPair : subtracting.statModifiers) {
             tempStats.statModifiers[statPair.first] -= statPair.second;
         }
         return tempStats;
@@ -167,7 +59,7 @@ namespace Game {
         for (std::pair<STAT, int> statPair : adding.stats) {
             stats[statPair.first] += statPair.second;
         }
-        for (std::pair<STAT_MOD, int> statPair : adding.statModifiers) {
+        for (std::pair<STAT_MOD, Fixed> statPair : adding.statModifiers) {
             statModifiers[statPair.first] += statPair.second;
         }
     }
@@ -176,18 +68,58 @@ namespace Game {
         for (std::pair<STAT, int> statPair : subtracting.stats) {
             stats[statPair.first] -= statPair.second;
         }
-        for (std::pair<STAT_MOD, int> statPair : subtracting.statModifiers) {
+        for (std::pair<STAT_MOD, Fixed> statPair : subtracting.statModifiers) {
             statModifiers[statPair.first] -= statPair.second;
         }
     }
 
+    BehaviourProfile* BehaviourProfile::create(PROFILE profile, unsigned int entityID, Map* map) {
+        switch (profile) {
+            case PROFILE::GRUNT:
+                return new GruntBehaviourProfile(entityID, map);
+        }
+        return NULL;
+    }
+
+    BehaviourProfile::~BehaviourProfile() {
+
+    }
+
+    void BehaviourProfile::save(BinaryWriter& writer) const {
+        writer.write<uint32_t>(ticksSinceRepath);
+        std::queue<Node> path = currentPath;
+        writer.write<uint32_t>(path.size());
+        while (!path.empty()) {
+            writer.writeRect(path.front().getRect());
+            path.pop();
+        }
+    }
+
+    bool BehaviourProfile::load(BinaryReader& reader) {
+        uint32_t ticks, pathLength;
+        if (!reader.read(ticks) || !reader.read(pathLength)) {
+            return false;
+        }
+        ticksSinceRepath = ticks;
+        currentPath = std::queue<Node>();
+        for (uint32_t i = 0; i < pathLength; i++) {
+            Rect area;
+            if (!reader.readRect(area)) {
+                return false;
+            }
+            currentPath.push(Node(area, entityID, map));
+        }
+        return true;
+    }
+
     bool BehaviourProfile::entityValid() const {
         return map && map->getEntityWithID(entityID);
     }
 
-    BehaviourProfile::Node::Node(const Game::Rect& area_, unsigned int entityID_) {
+    BehaviourProfile::Node::Node(const Game::Rect& area_, unsigned int entityID_, Game::Map* map_) {
         area = area_;
         entityID = entityID_;
+        map = map_;
     }
 
     Game::Rect BehaviourProfile::Node::getRect() const {
@@ -209,7 +141,7 @@ namespace Game {
         for (Game::Vector movement : degreesOfMovement) {
             Game::Rect moveRect = Game::Rect(Game::Vector(area.topLeft.x + movement.x, area.topLeft.y + movement.y), area.width, area.height);
             if (entityValid() && map->entityCanMoveToSpace(entityID, moveRect)) {
-                adjacent.push_back(Node(moveRect, entityID));
+                adjacent.push_back(Node(moveRect, entityID, map));
             }
         }
         return adjacent;
@@ -234,18 +166,12 @@ namespace Game {
             return std::queue<BehaviourProfile::Node>();
         }
         std::queue<Node> path;
-        Node currentNode = Node(map->getEntityWithID(entityID)->getHitbox(), entityID);
+        Node currentNode = Node(map->getEntityWithID(entityID)->getHitbox(), entityID, map);
 
-        while(true) {
+        while (path.size() < maxPathLength) {
             if (currentNode.getRect().contains(target)) {
                 return path;
             }
-            if (!path.empty()) {
-                path.push(currentNode);
-            }
-            if (path.size() > 50) {
-                return std::queue<Node>();
-            }
 
             Node closestNode = currentNode;
             for (Node node : currentNode.getAdjacent()) {
@@ -253,16 +179,20 @@ namespace Game {
                     closestNode = node;
                 }
             }
+            if (closestNode == currentNode) {
+                return path;
+            }
+            path.push(closestNode);
             currentNode = closestNode;
         }
-
+        return std::queue<Node>();
     }
 
     void BehaviourProfile::traversePath() {
-        if (entityValid()) {
+        if (entityValid() && !currentPath.empty()) {
             Game::Rect nextSpot = currentPath.front().getRect();
             Game::Vector movement = Game::Vector(nextSpot.topLeft.x - map->getEntityWithID(entityID)->getHitbox().topLeft.x, nextSpot.topLeft.y - map->getEntityWithID(entityID)->getHitbox().topLeft.y);
-            map->getEntityWithID(entityID)->move(movement);
+            map->getEntityWithID(entityID)->moveWithoutModifier(movement);
             if (map->getEntityWithID(entityID)->getHitbox() == nextSpot) {
                 currentPath.pop();
             }
@@ -273,15 +203,35 @@ namespace Game {
         if (ticksSinceRepath < repathDelay) {
             ticksSinceRepath++;
         }
-        else if (entityValid()) {
+        else if (entityValid() && map->getEntityWithID(map->getPlayerID())) {
             ticksSinceRepath = 0;
             currentPath = getPath(map->getEntityWithID(map->getPlayerID())->getHitbox().getCenter());
         }
     }
 
     void BehaviourProfile::spawnDamageAction() {
-        std::unique_ptr<Targeting> rectTargeting(new RectTargeting(map->getEntityWithID(entityID)->getHitbox()));
-        map->addActionToQueue(std::unique_ptr<HitAction>(new HitAction(map->getEntityWithID(entityID)->getFinalStats().stats[EntityStats::STAT::DMG], map, std::move(rectTargeting), &EnemyTeam::ENEMY_TEAM)));
+        if (!entityValid()) {
+            return;
+        }
+        EntityStats stats = map->getEntityWithID(entityID)->getFinalStats();
+        Game::Rect hitbox = map->getEntityWithID(entityID)->getHitbox();
+        int range = stats.stats[EntityStats::STAT::RNG];
+        Game::Rect contactRect = Game::Rect(Game::Vector(hitbox.topLeft.x - range, hitbox.topLeft.y - range), hitbox.width + range * 2, hitbox.height + range * 2);
+        if (EnemyTeam::ENEMY_TEAM.canBeHit(map->getEntitiesInArea(contactRect), map).empty()) {
+            return;
+        }
+        std::unique_ptr<Targeting> contactTargeting(new RectTargeting(contactRect));
+        map->addActionToQueue(std::unique_ptr<HitAction>(new HitAction(stats.stats[EntityStats::STAT::DMG], map, std::move(contactTargeting), &EnemyTeam::ENEMY_TEAM)));
+    }
+
+    GruntBehaviourProfile::GruntBehaviourProfile(unsigned int entityID_, Map* map_) {
+        entityID = entityID_;
+        map = map_;
+        ticksSinceRepath = repathDelay;
+    }
+
+    BehaviourProfile::PROFILE GruntBehaviourProfile::getProfileType() const {
+        return PROFILE::GRUNT;
     }
 
     unsigned int GruntBehaviourProfile::getEntityID() {
@@ -310,6 +260,7 @@ namespace Game {
 
     Buff::Buff(const EntityStats& changes_, unsigned int framesMax_, unsigned int frameInterval_) {
         changes = changes_;
+        framesLeft = framesMax_;
         framesMax = framesMax_;
         frameInterval = frameInterval_;
     }
@@ -322,6 +273,18 @@ namespace Game {
         return framesMax;
     }
 
+    unsigned int Buff::getFrameInterval() const {
+        return frameInterval;
+    }
+
+    const EntityStats& Buff::getChanges() const {
+        return changes;
+    }
+
+    void Buff::setFramesLeft(unsigned int framesLeft_) {
+        framesLeft = framesLeft_;
+    }
+
     void Buff::apply(EntityStats& stats) const {
         stats += changes;
     }
@@ -335,6 +298,9 @@ namespace Game {
     EntityTemplate::EntityTemplate() {
         stats = EntityStats();
         hitbox = Rect();
+        behaviourProfile = NULL;
+        team = Team::TEAM::ENEMY;
+        prefab = 0;
     }
 
     EntityTemplate::EntityTemplate(const EntityStats& stats_, const Rect& hitbox_, BehaviourProfile* behaviourProfile_, Team::TEAM team_) {
@@ -342,18 +308,75 @@ namespace Game {
         hitbox = hitbox_;
         behaviourProfile = behaviourProfile_;
         team = team_;
+        prefab = 0;
     }
 
     EntityTemplate::EntityTemplate(const EntityTemplate& copying) {
         stats = copying.stats;
         hitbox = copying.hitbox;
         behaviourProfile = copying.behaviourProfile;
+        team = copying.team;
+        prefab = copying.prefab;
+    }
+
+    std::unique_ptr<Targeting> Targeting::load(BinaryReader& reader) {
+        uint8_t type;
+        if (!reader.read(type)) {
+            return std::unique_ptr<Targeting>();
+        }
+        switch (static_cast<TARGETING>(type)) {
+            case TARGETING::NONE:
+                return std::unique_ptr<Targeting>(new NoTargeting());
+            case TARGETING::ALL:
+                return std::unique_ptr<Targeting>(new AllTargeting());
+            case TARGETING::RECT: {
+                Rect rect;
+                if (reader.readRect(rect)) {
+                    return std::unique_ptr<Targeting>(new RectTargeting(rect));
+                }
+                break;
+            }
+            case TARGETING::CIRCLE: {
+                int32_t x, y, radius;
+                if (reader.read(x) && reader.read(y) && reader.read(radius)) {
+                    return std::unique_ptr<Targeting>(new CircleTargeting(Circle(Vector(x, y), radius)));
+                }
+                break;
+            }
+            case TARGETING::SHAPE: {
+                Shape shape;
+                if (reader.readShape(shape)) {
+                    return std::unique_ptr<Targeting>(new ShapeTargeting(shape));
+                }
+                break;
+            }
+            case TARGETING::OVERLAP: {
+                uint32_t entityID;
+                if (reader.read(entityID)) {
+                    return std::unique_ptr<Targeting>(new OverlapTargeting(entityID));
+                }
+                break;
+            }
+        }
+        return std::unique_ptr<Targeting>();
+    }
+
+    Targeting::~Targeting() {
+
+    }
+
+    void Targeting::save(BinaryWriter& writer) const {
+        writer.write<uint8_t>(static_cast<uint8_t>(getTargetingType()));
     }
 
     NoTargeting::NoTargeting() {
 
     }
 
+    Targeting::TARGETING NoTargeting::getTargetingType() const {
+        return TARGETING::NONE;
+    }
+
     std::vector<unsigned int> NoTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
         return std::vector<unsigned int>();
     }
@@ -362,6 +385,10 @@ namespace Game {
 
     }
 
+    Targeting::TARGETING AllTargeting::getTargetingType() const {
+        return TARGETING::ALL;
+    }
+
     std::vector<unsigned int> AllTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
         return entities;
     }
@@ -370,6 +397,15 @@ namespace Game {
         rect = rect_;
     }
 
+    Targeting::TARGETING RectTargeting::getTargetingType() const {
+        return TARGETING::RECT;
+    }
+
+    void RectTargeting::save(BinaryWriter& writer) const {
+        Targeting::save(writer);
+        writer.writeRect(rect);
+    }
+
     std::vector<unsigned int> RectTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
         std::vector<unsigned int> entitiesInRange;
         for (unsigned int entityID : entities) {
@@ -384,6 +420,17 @@ namespace Game {
         circle = circle_;
     }
 
+    Targeting::TARGETING CircleTargeting::getTargetingType() const {
+        return TARGETING::CIRCLE;
+    }
+
+    void CircleTargeting::save(BinaryWriter& writer) const {
+        Targeting::save(writer);
+        writer.write<int32_t>(circle.center.x);
+        writer.write<int32_t>(circle.center.y);
+        writer.write<int32_t>(circle.radius);
+    }
+
     std::vector<unsigned int> CircleTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
         std::vector<unsigned int> entitiesInRange;
         for (unsigned int entityID : entities) {
@@ -394,6 +441,96 @@ namespace Game {
         return entitiesInRange;
     }
 
+    ShapeTargeting::ShapeTargeting(const Shape& shape_) {
+        shape = shape_;
+    }
+
+    Targeting::TARGETING ShapeTargeting::getTargetingType() const {
+        return TARGETING::SHAPE;
+    }
+
+    void ShapeTargeting::save(BinaryWriter& writer) const {
+        Targeting::save(writer);
+        writer.writeShape(shape);
+    }
+
+    std::vector<unsigned int> ShapeTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
+        std::vector<unsigned int> entitiesInRange;
+        if (!map) {
+            return entitiesInRange;
+        }
+        candidateRects.clear();
+        candidateIDs.clear();
+        for (unsigned int entityID : map->getEntitiesInArea(shape.getBounds())) {
+            if (map->hasCustomShape(entityID)) {
+                if (shape.overlaps(map->getEntityShape(entityID))) {
+                    entitiesInRange.push_back(entityID);
+                }
+            }
+            else {
+                candidateIDs.push_back(entityID);
+                candidateRects.push_back(map->getEntityWithID(entityID)->getHitbox());
+            }
+        }
+        shape.overlapsRects(candidateRects, hits);
+        for (unsigned int i = 0; i < candidateIDs.size(); i++) {
+            if (hits[i]) {
+                entitiesInRange.push_back(candidateIDs[i]);
+            }
+        }
+        return entitiesInRange;
+    }
+
+    OverlapTargeting::OverlapTargeting(unsigned int entityID_) {
+        entityID = entityID_;
+    }
+
+    Targeting::TARGETING OverlapTargeting::getTargetingType() const {
+        return TARGETING::OVERLAP;
+    }
+
+    void OverlapTargeting::save(BinaryWriter& writer) const {
+        Targeting::save(writer);
+        writer.write<uint32_t>(entityID);
+    }
+
+    std::vector<unsigned int> OverlapTargeting::isInRange(const std::vector<unsigned int>& entities, Map* map) {
+        std::vector<unsigned int> entitiesInRange;
+        if (!map) {
+            return entitiesInRange;
+        }
+        for (unsigned int partnerID : map->getOverlapping(entityID)) {
+            if (map->getEntityWithID(partnerID)) {
+                entitiesInRange.push_back(partnerID);
+            }
+        }
+        return entitiesInRange;
+    }
+
+    const Team* Team::getChecker(TEAM team) {
+        switch (team) {
+            case TEAM::PLAYER:
+                return &PlayerTeam::PLAYER_TEAM;
+            case TEAM::ENEMY:
+                return &EnemyTeam::ENEMY_TEAM;
+            case TEAM::TERRAIN:
+                return &TerrainTeam::TERRAIN_TEAM;
+        }
+        return NULL;
+    }
+
+    Team::TEAM PlayerTeam::getTeamType() const {
+        return TEAM::PLAYER;
+    }
+
+    Team::TEAM EnemyTeam::getTeamType() const {
+        return TEAM::ENEMY;
+    }
+
+    Team::TEAM TerrainTeam::getTeamType() const {
+        return TEAM::TERRAIN;
+    }
+
     bool Team::validEntity(unsigned int entityID, Map* map) const {
         return map && map->getEntityWithID(entityID);
     }
@@ -491,6 +628,54 @@ namespace Game {
     Action::Action() {
         frameWait = 0;
         delayTicks = 0;
+        teamChecker = NULL;
+        ownerMap = NULL;
+    }
+
+    Action::~Action() {
+
+    }
+
+    std::unique_ptr<Action> Action::load(BinaryReader& reader, Map* ownerMap_) {
+        uint8_t type, team;
+        uint32_t frameWait_, delayTicks_;
+        if (!reader.read(type) || !reader.read(frameWait_) || !reader.read(delayTicks_) || !reader.read(team)) {
+            return std::unique_ptr<Action>();
+        }
+        std::unique_ptr<Targeting> targeting_ = Targeting::load(reader);
+        if (!targeting_ || team > static_cast<uint8_t>(Team::TEAM::TERRAIN)) {
+            return std::unique_ptr<Action>();
+        }
+        const Team* teamChecker_ = Team::getChecker(static_cast<Team::TEAM>(team));
+        std::unique_ptr<Action> action;
+        switch (static_cast<ACTION>(type)) {
+            case ACTION::HIT:
+                action.reset(new HitAction(0, ownerMap_, std::move(targeting_), teamChecker_));
+                break;
+            case ACTION::HEAL:
+                action.reset(new HealAction(0, ownerMap_, std::move(targeting_), teamChecker_));
+                break;
+            case ACTION::DISPLACEMENT:
+                action.reset(new DisplacementAction(Vector(0, 0), ownerMap_, std::move(targeting_), teamChecker_));
+                break;
+            default:
+                return std::unique_ptr<Action>();
+        }
+        action->frameWait = frameWait_;
+        action->delayTicks = delayTicks_;
+        if (!action->loadFields(reader)) {
+            return std::unique_ptr<Action>();
+        }
+        return action;
+    }
+
+    void Action::save(BinaryWriter& writer) const {
+        writer.write<uint8_t>(static_cast<uint8_t>(getActionType()));
+        writer.write<uint32_t>(frameWait);
+        writer.write<uint32_t>(delayTicks);
+        writer.write<uint8_t>(static_cast<uint8_t>(teamChecker ? teamChecker->getTeamType() : Team::TEAM::TERRAIN));
+        targeting->save(writer);
+        saveFields(writer);
     }
 
     HitAction::HitAction(unsigned int damage_, Map* ownerMap_, std::unique_ptr<Targeting> targeting_, const Team* teamChecker_) {
@@ -500,6 +685,23 @@ namespace Game {
         teamChecker = teamChecker_;
     }
 
+    Action::ACTION HitAction::getActionType() const {
+        return ACTION::HIT;
+    }
+
+    void HitAction::saveFields(BinaryWriter& writer) const {
+        writer.write<uint32_t>(damage);
+    }
+
+    bool HitAction::loadFields(BinaryReader& reader) {
+        uint32_t damage_;
+        if (!reader.read(damage_)) {
+            return false;
+        }
+        damage = damage_;
+        return true;
+    }
+
     void HitAction::applyAction(const std::vector<unsigned int>& entities) {
         std::vector<unsigned int> targetableEntities = teamChecker->canBeHit(targeting->isInRange(entities, ownerMap), ownerMap);
         for (unsigned int entityID : targetableEntities) {
@@ -508,6 +710,7 @@ namespace Game {
                 EntityStats newStats = entity->getBaseStats();
                 newStats.stats[EntityStats::STAT::HP] -= damage;
                 entity->setStats(newStats);
+                ownerMap->recordEvent(MapEvent::TYPE::DAMAGED, entityID, damage);
             }
         }
     }
@@ -519,6 +722,23 @@ namespace Game {
         teamChecker = teamChecker_;
     }
 
+    Action::ACTION HealAction::getActionType() const {
+        return ACTION::HEAL;
+    }
+
+    void HealAction::saveFields(BinaryWriter& writer) const {
+        writer.write<uint32_t>(healAmount);
+    }
+
+    bool HealAction::loadFields(BinaryReader& reader) {
+        uint32_t healAmount_;
+        if (!reader.read(healAmount_)) {
+            return false;
+        }
+        healAmount = healAmount_;
+        return true;
+    }
+
     void HealAction::applyAction(const std::vector<unsigned int>& entities) {
         std::vector<unsigned int> targetableEntities = targeting->isInRange(entities, ownerMap);
         for (unsigned int entityID : targetableEntities) {
@@ -527,6 +747,7 @@ namespace Game {
                 EntityStats newStats = entity->getBaseStats();
                 newStats.stats[EntityStats::STAT::HP] += healAmount;
                 entity->setStats(newStats);
+                ownerMap->recordEvent(MapEvent::TYPE::HEALED, entityID, healAmount);
             }
         }
     }
@@ -538,11 +759,29 @@ namespace Game {
         teamChecker = teamChecker_;
     }
 
+    Action::ACTION DisplacementAction::getActionType() const {
+        return ACTION::DISPLACEMENT;
+    }
+
+    void DisplacementAction::saveFields(BinaryWriter& writer) const {
+        writer.write<int32_t>(displaceBy.x);
+        writer.write<int32_t>(displaceBy.y);
+    }
+
+    bool DisplacementAction::loadFields(BinaryReader& reader) {
+        int32_t x, y;
+        if (!reader.read(x) || !reader.read(y)) {
+            return false;
+        }
+        displaceBy = Vector(x, y);
+        return true;
+    }
+
     void DisplacementAction::applyAction(const std::vector<unsigned int>& entities) {
         std::vector<unsigned int> targetableEntities = targeting->isInRange(entities, ownerMap);
         for (unsigned int entityID : targetableEntities) {
             if (ownerMap && ownerMap->getEntityWithID(entityID)) {
-                ownerMap->getEntityWithID(entityID)->moveWithoutModifier(displaceBy);
+                ownerMap->addImpulse(entityID, displaceBy);
             }
         }
     }
@@ -551,29 +790,35 @@ namespace Game {
         id = id_;
         hitbox = entityTemplate.hitbox;
         baseStats = entityTemplate.stats;
-        behaviourProfile = entityTemplate.behaviourProfile;
         ownerMap = owner;
         team = entityTemplate.team;
+        prefab = entityTemplate.prefab;
+        awake = false;
+        moved = false;
+        idleTicks = 0;
     }
 
-    const unsigned int Entity::getID() {
+    const unsigned int Entity::getID() const {
         return id;
     }
 
-    const Rect Entity::getHitbox() {
+    const Rect Entity::getHitbox() const {
         return hitbox;
     }
 
     void Entity::setHitbox(const Rect& newHitbox) {
         hitbox = newHitbox;
+        ownerMap->onEntityMoved(id);
     }
 
     void Entity::move(const Vector& moveBy) {
-        int newX = hitbox.topLeft.x + moveBy.x * getFinalStats().statModifiers[EntityStats::STAT_MOD::MOVE];
-        int newY = hitbox.topLeft.y + moveBy.y * getFinalStats().statModifiers[EntityStats::STAT_MOD::MOVE];
+        Fixed moveModifier = getFinalStats().statModifiers[EntityStats::STAT_MOD::MOVE];
+        int newX = hitbox.topLeft.x + (Fixed(moveBy.x) * moveModifier).toInt();
+        int newY = hitbox.topLeft.y + (Fixed(moveBy.y) * moveModifier).toInt();
         Rect newHitbox = Rect(Vector(newX, newY), hitbox.width, hitbox.height);
         if (ownerMap->entityCanMoveToSpace(id, newHitbox)) {
             hitbox = newHitbox;
+            ownerMap->onEntityMoved(id);
         }
     }
 
@@ -583,19 +828,26 @@ namespace Game {
         Rect newHitbox = Rect(Vector(newX, newY), hitbox.width, hitbox.height);
         if (ownerMap->entityCanMoveToSpace(id, newHitbox)) {
             hitbox = newHitbox;
+            ownerMap->onEntityMoved(id);
         }
     }
 
     void Entity::addBuff(const Buff& buff) {
         buffs.push_back(buff);
+        ownerMap->wakeEntity(id);
+    }
+
+    const std::vector<Buff>& Entity::getBuffs() const {
+        return buffs;
     }
 
-    const EntityStats& Entity::getBaseStats() {
+    const EntityStats& Entity::getBaseStats() const {
         return baseStats;
     }
 
     void Entity::setStats(const EntityStats& stats) {
         baseStats = stats;
+        ownerMap->wakeEntity(id);
     }
 
     EntityStats Entity::getFinalStats() {
@@ -610,101 +862,689 @@ namespace Game {
         EntityTemplate returnTemplate;
         returnTemplate.stats = baseStats;
         returnTemplate.hitbox = hitbox;
-        returnTemplate.behaviourProfile = behaviourProfile;
+        returnTemplate.behaviourProfile = NULL;
+        returnTemplate.team = team;
+        returnTemplate.prefab = prefab;
         return returnTemplate;
     }
 
-    Team::TEAM Entity::getTeam() {
+    Team::TEAM Entity::getTeam() const {
         return team;
     }
 
     void Entity::setTeam(Team::TEAM team_) {
         team = team_;
+        ownerMap->markEntityDirty(this);
+    }
+
+    uint8_t Entity::getPrefab() const {
+        return prefab;
+    }
+
+    const BehaviourProfile* Entity::getBehaviourProfile() const {
+        return ownerMap->getBehaviourProfile(id);
     }
 
     void Map::addActionToQueue(std::unique_ptr<Action> action) {
-        actions.push_back(std::move(action));
+        pendingActions.push(std::move(action));
+    }
+
+    void Map::drainPendingActions() {
+        pendingActions.drain([this](std::unique_ptr<Action> action) {
+            actions.push_back(std::move(action));
+        });
     }
 
     Map::Map() {
         currentMaxID = 0;
+        playerID = 0;
         playableArea = Rect(Vector(0, 0), 0, 0);
+        allEntitiesDirty = true;
+        reorderingEnabled = false;
+        reorderPhase = REORDER_PHASE::IDLE;
+        ticksSinceReorder = 0;
+        reorderWriteIndex = 0;
+        reorderReadIndex = 0;
+        stateGeneration = 0;
     }
 
     void Map::tickAndApplyActions() {
-        std::vector<std::vector<std::unique_ptr<Action>>::iterator> needsErasing;
-        for (std::vector<std::unique_ptr<Action>>::iterator action = actions.begin(); action != actions.end(); action++) {
-            std::vector<unsigned int> entityIDs = getActiveEntityIDs();
-            if ((*action)->tick(getActiveEntityIDs()) == 0) {
-                needsErasing.push_back(action);
+        overlaps.beginTick();
+        drainPendingActions();
+        tickActions();
+        tickBehaviours();
+        kinematics.integrate(this);
+        removeDeadEntities();
+        updateOverlaps();
+        wakeEntitiesNearObservers();
+        updateSleepingEntities();
+        tickReordering();
+        publishMovedEvents();
+        drainPendingActions();
+    }
+
+    void Map::tickActions() {
+        std::vector<unsigned int> entityIDs = getActiveEntityIDs();
+        std::vector<std::unique_ptr<Action>> stillWaiting;
+        for (std::unique_ptr<Action>& action : actions) {
+            if (action->tick(entityIDs) != 0) {
+                stillWaiting.push_back(std::move(action));
             }
         }
-        for (std::vector<std::unique_ptr<Action>>::iterator erasing : needsErasing) {
-            actions.erase(erasing);
+        actions.swap(stillWaiting);
+    }
+
+    void Map::tickBehaviours() {
+        std::vector<unsigned int> ticking = awakeEntities;
+        for (unsigned int entityID : ticking) {
+            std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>>::iterator profile = behaviourProfiles.find(entityID);
+            if (profile != behaviourProfiles.end() && getEntityWithID(entityID)) {
+                profile->second->tick();
+                markEntityDirty(getEntityWithID(entityID));
+            }
         }
+    }
 
-        std::vector<std::vector<std::unique_ptr<Entity>>::iterator> deadEntities;
-        for (std::vector<std::unique_ptr<Entity>>::iterator entity = entities.begin(); entity != entities.end(); entity++) {
-            if ((*entity)->getFinalStats().stats[EntityStats::STAT::HP] < 1) {
-                deadEntities.push_back(entity);
+    void Map::removeDeadEntities() {
+        std::vector<unsigned int> deadIDs;
+        for (unsigned int entityID : awakeEntities) {
+            Entity* entity = getEntityWithID(entityID);
+            if (entity && entity->getFinalStats().stats[EntityStats::STAT::HP] < 1) {
+                deadIDs.push_back(entityID);
             }
         }
-        for (std::vector<std::unique_ptr<Entity>>::iterator deadEntity : deadEntities) {
-            entities.erase(deadEntity);
+        if (deadIDs.empty()) {
+            return;
+        }
+        for (unsigned int deadID : deadIDs) {
+            recordEvent(MapEvent::TYPE::DIED, deadID, 0);
+            eraseEntity(deadID);
         }
     }
 
-    Entity* Map::getEntityWithID(unsigned int ID) {
-        for (std::unique_ptr<Entity>& currentEntity : entities) {
-            if (currentEntity->getID() == ID) {
-                return currentEntity.get();
+    void Map::updateOverlaps() {
+        overlaps.update(grid, [this](unsigned int entityID, Rect& bounds) {
+            Entity* entity = getEntityWithID(entityID);
+            if (!entity) {
+                return false;
+            }
+            bounds = entity->getHitbox();
+            return true;
+        });
+    }
+
+    bool Map::removeEntity(unsigned int entityID) {
+        if (!getEntityWithID(entityID)) {
+            return false;
+        }
+        recordEvent(MapEvent::TYPE::REMOVED, entityID, 0);
+        return eraseEntity(entityID);
+    }
+
+    bool Map::eraseEntity(unsigned int entityID) {
+        std::unordered_map<unsigned int, unsigned int>::iterator found = entityIndices.find(entityID);
+        if (found == entityIndices.end()) {
+            return false;
+        }
+        swapEntities(found->second, entities.size() - 1);
+        entities.pop_back();
+        entityIndices.erase(entityID);
+        grid.remove(entityID);
+        kinematics.remove(entityID);
+        overlaps.remove(entityID);
+        entityShapes.erase(entityID);
+        behaviourProfiles.erase(entityID);
+        return true;
+    }
+
+    std::vector<unsigned int> Map::getEntitiesInArea(const Rect& area) {
+        std::vector<unsigned int> found;
+        queryResults.clear();
+        grid.query(area, queryResults);
+        for (unsigned int entityID : queryResults) {
+            if (getEntityWithID(entityID)->getHitbox().intersects(area)) {
+                found.push_back(entityID);
+            }
+        }
+        return found;
+    }
+
+    void Map::wakeEntitiesNearObservers() {
+        wakeEntitiesNear(getPlayerID());
+        for (unsigned int observerID : observerEntities) {
+            if (observerID != getPlayerID()) {
+                wakeEntitiesNear(observerID);
+            }
+        }
+    }
+
+    void Map::wakeEntitiesNear(unsigned int entityID) {
+        Entity* observer = getEntityWithID(entityID);
+        if (!observer) {
+            return;
+        }
+        Rect observerHitbox = observer->getHitbox();
+        Rect wakeArea = Rect(Vector(observerHitbox.topLeft.x - WAKE_DISTANCE, observerHitbox.topLeft.y - WAKE_DISTANCE), observerHitbox.width + WAKE_DISTANCE * 2, observerHitbox.height + WAKE_DISTANCE * 2);
+        queryResults.clear();
+        grid.query(wakeArea, queryResults);
+        for (unsigned int nearbyID : queryResults) {
+            wakeEntity(nearbyID);
+        }
+    }
+
+    void Map::updateSleepingEntities() {
+        std::vector<unsigned int> stillAwake;
+        for (unsigned int entityID : awakeEntities) {
+            Entity* entity = getEntityWithID(entityID);
+            if (!entity) {
+                continue;
+            }
+            markEntityDirty(entity);
+            if (!entity->buffs.empty() || kinematics.isMoving(entityID)) {
+                entity->idleTicks = 0;
+            }
+            else {
+                entity->idleTicks++;
+            }
+            if (entity->idleTicks >= SLEEP_DELAY) {
+                entity->awake = false;
+            }
+            else {
+                stillAwake.push_back(entityID);
+            }
+        }
+        awakeEntities.swap(stillAwake);
+    }
+
+    void Map::wakeEntity(unsigned int entityID) {
+        Entity* entity = getEntityWithID(entityID);
+        if (!entity) {
+            return;
+        }
+        markEntityDirty(entity);
+        entity->idleTicks = 0;
+        if (!entity->awake) {
+            entity->awake = true;
+            awakeEntities.push_back(entityID);
+        }
+    }
+
+    void Map::onEntityMoved(unsigned int entityID) {
+        Entity* entity = getEntityWithID(entityID);
+        if (entity) {
+            grid.update(entityID, entity->getHitbox());
+            overlaps.markMoved(entityID);
+            if (!entity->moved) {
+                entity->moved = true;
+                movedEntities.push_back(entityID);
+            }
+            wakeEntity(entityID);
+        }
+    }
+
+    uint32_t Map::getMortonCode(const Entity& entity) const {
+        Vector center = entity.getHitbox().getCenter();
+        int64_t x = (static_cast<int64_t>(center.x) - playableArea.topLeft.x) >> MORTON_CELL_SHIFT;
+        int64_t y = (static_cast<int64_t>(center.y) - playableArea.topLeft.y) >> MORTON_CELL_SHIFT;
+        x = std::min<int64_t>(std::max<int64_t>(x, 0), 0xffff);
+        y = std::min<int64_t>(std::max<int64_t>(y, 0), 0xffff);
+        return mortonCode(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+    }
+
+    void Map::swapEntities(unsigned int first, unsigned int second) {
+        if (first == second) {
+            return;
+        }
+        std::swap(entities[first], entities[second]);
+        entityIndices[entities[first].getID()] = first;
+        entityIndices[entities[second].getID()] = second;
+        markEntityDirty(&entities[first]);
+        markEntityDirty(&entities[second]);
+    }
+
+    void Map::markEntityDirty(const Entity* entity) {
+        if (entities.empty() || entity < entities.data() || entity >= entities.data() + entities.size()) {
+            return;
+        }
+        unsigned int page = (entity - entities.data()) / ENTITY_PAGE_SIZE;
+        if (page >= dirtyPages.size()) {
+            dirtyPages.resize(page + 1, 0);
+        }
+        dirtyPages[page] = 1;
+    }
+
+    void Map::beginReorder() {
+        std::vector<MortonSorter::Key> keys;
+        keys.reserve(entities.size());
+        for (const Entity& entity : entities) {
+            MortonSorter::Key key;
+            key.code = getMortonCode(entity);
+            key.entityID = entity.getID();
+            keys.push_back(key);
+        }
+        mortonSorter.begin(keys);
+        reorderPhase = REORDER_PHASE::SORTING;
+    }
+
+    void Map::applyReorder(unsigned int budget) {
+        const std::vector<MortonSorter::Key>& order = mortonSorter.getOrder();
+        while (budget > 0 && reorderReadIndex < order.size() && reorderWriteIndex < entities.size()) {
+            std::unordered_map<unsigned int, unsigned int>::iterator found = entityIndices.find(order[reorderReadIndex].entityID);
+            reorderReadIndex++;
+            if (found == entityIndices.end()) {
+                continue;
             }
+            swapEntities(reorderWriteIndex, found->second);
+            reorderWriteIndex++;
+            budget--;
+        }
+        if (reorderReadIndex >= order.size() || reorderWriteIndex >= entities.size()) {
+            reorderPhase = REORDER_PHASE::IDLE;
+            ticksSinceReorder = 0;
+        }
+    }
+
+    void Map::tickReordering() {
+        if (!reorderingEnabled) {
+            return;
+        }
+        switch (reorderPhase) {
+            case REORDER_PHASE::IDLE:
+                ticksSinceReorder++;
+                if (ticksSinceReorder >= REORDER_INTERVAL) {
+                    beginReorder();
+                }
+                break;
+            case REORDER_PHASE::SORTING:
+                if (mortonSorter.step(REORDER_BUDGET)) {
+                    reorderPhase = REORDER_PHASE::APPLYING;
+                    reorderReadIndex = 0;
+                    reorderWriteIndex = 0;
+                }
+                break;
+            case REORDER_PHASE::APPLYING:
+                applyReorder(REORDER_BUDGET);
+                break;
+        }
+    }
+
+    void Map::setEntityReordering(bool enabled) {
+        reorderingEnabled = enabled;
+    }
+
+    void Map::reorderEntitiesNow() {
+        beginReorder();
+        while (!mortonSorter.step(REORDER_BUDGET)) {
+        }
+        reorderReadIndex = 0;
+        reorderWriteIndex = 0;
+        reorderPhase = REORDER_PHASE::APPLYING;
+        while (reorderPhase == REORDER_PHASE::APPLYING) {
+            applyReorder(REORDER_BUDGET);
+        }
+    }
+
+    bool Map::isAwake(unsigned int entityID) {
+        Entity* entity = getEntityWithID(entityID);
+        return entity && entity->awake;
+    }
+
+    const std::vector<unsigned int>& Map::getAwakeEntityIDs() const {
+        return awakeEntities;
+    }
+
+    const std::vector<unsigned int>& Map::getOverlapping(unsigned int entityID) const {
+        return overlaps.getOverlapping(entityID);
+    }
+
+    void Map::setEntityShape(unsigned int entityID, const Shape& localShape) {
+        if (getEntityWithID(entityID)) {
+            entityShapes[entityID] = localShape;
+        }
+    }
+
+    bool Map::hasCustomShape(unsigned int entityID) const {
+        return entityShapes.find(entityID) != entityShapes.end();
+    }
+
+    bool Map::getLocalShape(unsigned int entityID, Shape& localShape) const {
+        std::unordered_map<unsigned int, Shape>::const_iterator found = entityShapes.find(entityID);
+        if (found == entityShapes.end()) {
+            return false;
+        }
+        localShape = found->second;
+        return true;
+    }
+
+    Shape Map::getEntityShape(unsigned int entityID) {
+        Entity* entity = getEntityWithID(entityID);
+        if (!entity) {
+            return Shape();
+        }
+        std::unordered_map<unsigned int, Shape>::iterator found = entityShapes.find(entityID);
+        if (found == entityShapes.end()) {
+            return Shape::aabb(entity->getHitbox());
+        }
+        return found->second.translated(entity->getHitbox().topLeft);
+    }
+
+    const std::vector<OverlapEvent>& Map::getOverlapEvents() const {
+        return overlaps.getEvents();
+    }
+
+    void Map::recordEvent(MapEvent::TYPE type, unsigned int entityID, int amount) {
+        MapEvent event;
+        event.type = type;
+        event.entityID = entityID;
+        event.amount = amount;
+        Entity* entity = getEntityWithID(entityID);
+        if (entity) {
+            event.hitbox = entity->getHitbox();
+        }
+        events.push(event);
+    }
+
+    void Map::publishMovedEvents() {
+        for (unsigned int entityID : movedEntities) {
+            Entity* entity = getEntityWithID(entityID);
+            if (entity) {
+                markEntityDirty(entity);
+                entity->moved = false;
+                recordEvent(MapEvent::TYPE::MOVED, entityID, 0);
+            }
+        }
+        movedEntities.clear();
+    }
+
+    const EventRing& Map::getEvents() const {
+        return events;
+    }
+
+    unsigned int Map::getStateGeneration() const {
+        return stateGeneration;
+    }
+
+    MapStats Map::getStats() const {
+        MapStats stats;
+        stats.awakeEntities = awakeEntities.size();
+        stats.sleepingEntities = entities.size() - awakeEntities.size();
+        return stats;
+    }
+
+    uint64_t Map::getStateHash() const {
+        uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](int32_t value) {
+            hash = (hash ^ static_cast<uint32_t>(value)) * 1099511628211ULL;
+        };
+        auto mixBytes = [&mix](const std::vector<char>& bytes) {
+            size_t words = bytes.size() / sizeof(int32_t);
+            for (size_t i = 0; i < words; i++) {
+                int32_t word;
+                std::memcpy(&word, bytes.data() + i * sizeof(int32_t), sizeof(int32_t));
+                mix(word);
+            }
+            for (size_t i = words * sizeof(int32_t); i < bytes.size(); i++) {
+                mix(static_cast<uint8_t>(bytes[i]));
+            }
+        };
+        mix(currentMaxID);
+        mix(entities.size());
+        mix(actions.size());
+        BinaryWriter state;
+        for (const std::unique_ptr<Action>& action : actions) {
+            action->save(state);
+        }
+        mixBytes(state.getBuffer());
+        for (const Entity& entity : entities) {
+            mix(entity.id);
+            mix(entity.hitbox.topLeft.x);
+            mix(entity.hitbox.topLeft.y);
+            mix(entity.hitbox.width);
+            mix(entity.hitbox.height);
+            mix(static_cast<int32_t>(entity.team));
+            for (std::pair<EntityStats::STAT, int> stat : entity.baseStats.stats) {
+                mix(stat.second);
+            }
+            for (std::pair<EntityStats::STAT_MOD, Fixed> modifier : entity.baseStats.statModifiers) {
+                mix(modifier.second.getRaw());
+            }
+            mix(entity.buffs.size());
+            for (const Buff& buff : entity.buffs) {
+                mix(buff.getFramesLeft());
+            }
+            Kinematics::Motion motion = kinematics.getMotion(entity.id);
+            mix(motion.velocityX);
+            mix(motion.velocityY);
+            mix(motion.remainderX);
+            mix(motion.remainderY);
+            std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>>::const_iterator profile = behaviourProfiles.find(entity.id);
+            if (profile != behaviourProfiles.end()) {
+                mix(static_cast<int32_t>(profile->second->getProfileType()));
+                state.getBuffer().clear();
+                profile->second->save(state);
+                mixBytes(state.getBuffer());
+            }
+        }
+        return hash;
+    }
+
+    Entity* Map::getEntityWithID(unsigned int ID) {
+        std::unordered_map<unsigned int, unsigned int>::iterator found = entityIndices.find(ID);
+        if (found != entityIndices.end()) {
+            return &entities[found->second];
         }
         return NULL;
     }
 
     unsigned int Map::createEntity(const EntityTemplate& entityTemplate) {
-        entities.push_back(std::move(std::unique_ptr<Entity>(new Entity(entityTemplate, currentMaxID, this))));
+        if (entityTemplate.team == Team::TEAM::TERRAIN) {
+            addStaticGeometry(entityTemplate.hitbox);
+            currentMaxID += 1;
+            return currentMaxID - 1;
+        }
+        insertEntity(currentMaxID, entityTemplate);
         currentMaxID += 1;
         return currentMaxID - 1;
     }
 
+    unsigned int Map::restoreEntity(unsigned int entityID, const EntityTemplate& entityTemplate) {
+        if (entityTemplate.team == Team::TEAM::TERRAIN || entityIndices.find(entityID) != entityIndices.end()) {
+            return createEntity(entityTemplate);
+        }
+        insertEntity(entityID, entityTemplate);
+        if (entityID >= currentMaxID) {
+            currentMaxID = entityID + 1;
+        }
+        return entityID;
+    }
+
+    void Map::insertEntity(unsigned int entityID, const EntityTemplate& entityTemplate) {
+        entities.push_back(Entity(entityTemplate, entityID, this));
+        entityIndices[entityID] = entities.size() - 1;
+        if (entityTemplate.behaviourProfile) {
+            behaviourProfiles[entityID].reset(entityTemplate.behaviourProfile);
+        }
+        grid.insert(entityID, entityTemplate.hitbox);
+        kinematics.add(entityID);
+        overlaps.markMoved(entityID);
+        wakeEntity(entityID);
+        recordEvent(MapEvent::TYPE::SPAWNED, entityID, 0);
+    }
+
+    void Map::setBehaviourProfile(unsigned int entityID, std::unique_ptr<BehaviourProfile> profile) {
+        Entity* entity = getEntityWithID(entityID);
+        if (!entity) {
+            return;
+        }
+        if (!profile) {
+            behaviourProfiles.erase(entityID);
+            return;
+        }
+        behaviourProfiles[entityID] = std::move(profile);
+        markEntityDirty(entity);
+        wakeEntity(entityID);
+    }
+
+    const BehaviourProfile* Map::getBehaviourProfile(unsigned int entityID) const {
+        std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>>::const_iterator found = behaviourProfiles.find(entityID);
+        if (found == behaviourProfiles.end()) {
+            return NULL;
+        }
+        return found->second.get();
+    }
+
+    unsigned int Map::createEntities(const Prefab& prefab, unsigned int count, const SpawnPlacement& placement) {
+        unsigned int firstID = currentMaxID;
+        EntityTemplate entityTemplate = prefab.entityTemplate;
+        uint32_t placementState = placement.seed;
+        if (entityTemplate.team == Team::TEAM::TERRAIN) {
+            staticGeometry.reserve(staticGeometry.size() + count);
+            for (unsigned int i = 0; i < count; i++) {
+                addStaticGeometry(Rect(placement.getPosition(i, placementState), prefab.entityTemplate.hitbox.width, prefab.entityTemplate.hitbox.height));
+            }
+            currentMaxID += count;
+            return firstID;
+        }
+        unsigned int total = entities.size() + count;
+        entities.reserve(total);
+        entityIndices.reserve(total);
+        grid.reserve(total);
+        kinematics.reserve(total);
+        awakeEntities.reserve(awakeEntities.size() + count);
+        if (prefab.hasBehaviour) {
+            behaviourProfiles.reserve(behaviourProfiles.size() + count);
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            unsigned int entityID = currentMaxID;
+            entityTemplate.hitbox.topLeft = placement.getPosition(i, placementState);
+            if (prefab.hasBehaviour) {
+                behaviourProfiles[entityID].reset(BehaviourProfile::create(prefab.behaviour, entityID, this));
+            }
+            entities.push_back(Entity(entityTemplate, entityID, this));
+            entityIndices[entityID] = entities.size() - 1;
+            grid.insert(entityID, entityTemplate.hitbox);
+            kinematics.add(entityID);
+            overlaps.markMoved(entityID);
+            entities.back().awake = true;
+            awakeEntities.push_back(entityID);
+            recordEvent(MapEvent::TYPE::SPAWNED, entityID, 0);
+            currentMaxID += 1;
+        }
+        unsigned int firstPage = (entities.size() - count) / ENTITY_PAGE_SIZE;
+        unsigned int lastPage = entities.empty() ? 0 : (entities.size() - 1) / ENTITY_PAGE_SIZE;
+        if (count > 0) {
+            if (lastPage >= dirtyPages.size()) {
+                dirtyPages.resize(lastPage + 1, 0);
+            }
+            std::fill(dirtyPages.begin() + firstPage, dirtyPages.begin() + lastPage + 1, 1);
+        }
+        return firstID;
+    }
+
     std::vector<unsigned int> Map::getActiveEntityIDs() {
         std::vector<unsigned int> returnVec;
-        for (std::unique_ptr<Entity>& currentEntity : entities) {
-            returnVec.push_back(currentEntity->getID());
+        for (Entity& currentEntity : entities) {
+            returnVec.push_back(currentEntity.getID());
         }
         return returnVec;
     }
 
+    const std::vector<Entity>& Map::getEntities() const {
+        return entities;
+    }
+
     bool Map::spaceEmpty(const Rect& space) {
-        bool empty = true;
-        for (std::unique_ptr<Entity>& currentEntity : entities) {
-            if (currentEntity->getHitbox().intersects(space)) {
-                empty = false;
+        if (staticLayer.intersects(space)) {
+            return false;
+        }
+        queryResults.clear();
+        grid.query(space, queryResults);
+        for (unsigned int entityID : queryResults) {
+            if (getEntityWithID(entityID)->getHitbox().intersects(space)) {
+                return false;
             }
         }
-        return empty;
+        return true;
     }
 
     void Map::setPlayableArea(const Rect& playableArea_) {
         playableArea = playableArea_;
     }
 
+    void Map::addStaticGeometry(const Rect& rect) {
+        staticGeometry.push_back(rect);
+        staticLayer.fill(rect);
+    }
+
+    std::vector<Rect> Map::removeStaticGeometryIn(const Rect& region) {
+        std::vector<Rect> removed;
+        std::vector<Rect> kept;
+        for (const Rect& rect : staticGeometry) {
+            if (region.contains(rect.getCenter())) {
+                removed.push_back(rect);
+            }
+            else {
+                kept.push_back(rect);
+            }
+        }
+        if (removed.empty()) {
+            return removed;
+        }
+        staticGeometry.swap(kept);
+        for (const Rect& rect : removed) {
+            staticLayer.clearArea(rect);
+        }
+        for (const Rect& rect : staticGeometry) {
+            for (const Rect& cleared : removed) {
+                if (rect.intersects(cleared)) {
+                    staticLayer.fill(rect);
+                    break;
+                }
+            }
+        }
+        return removed;
+    }
+
+    const std::vector<Rect>& Map::getStaticGeometry() const {
+        return staticGeometry;
+    }
+
     bool Map::entityCanMoveToSpace(unsigned int entityID, const Rect& space) {
-        bool moveable = true;
-        bool inPlayableArea = playableArea.contains(space);
-        for (std::unique_ptr<Entity>& currentEntity : entities) {
-            bool spaceNotEmpty = currentEntity->getHitbox().intersects(space) && currentEntity->getID() != entityID;
-            if (spaceNotEmpty || !inPlayableArea) {
-                moveable = false;
+        if (!playableArea.contains(space) || staticLayer.intersects(space)) {
+            return false;
+        }
+        queryResults.clear();
+        grid.query(space, queryResults);
+        for (unsigned int otherID : queryResults) {
+            if (otherID != entityID && getEntityWithID(otherID)->getHitbox().intersects(space)) {
+                return false;
             }
         }
-        return moveable;
+        return true;
+    }
+
+    void Map::addImpulse(unsigned int entityID, const Vector& displacement) {
+        wakeEntity(entityID);
+        Fixed impulseScale = Fixed(1) - kinematics.getDamping();
+        kinematics.addImpulse(entityID, Fixed(displacement.x) * impulseScale, Fixed(displacement.y) * impulseScale);
     }
 
     unsigned int Map::getPlayerID() {
-        return 0;
+        return playerID;
+    }
+
+    void Map::setPlayerID(unsigned int playerID_) {
+        playerID = playerID_;
+    }
+
+    void Map::addObserverEntity(unsigned int entityID) {
+        if (std::find(observerEntities.begin(), observerEntities.end(), entityID) == observerEntities.end()) {
+            observerEntities.push_back(entityID);
+        }
+    }
+
+    void Map::removeObserverEntity(unsigned int entityID) {
+        observerEntities.erase(std::remove(observerEntities.begin(), observerEntities.end(), entityID), observerEntities.end());
     }
 
 }
@@ -0,0 +1,113 @@
+#include "geometry.hpp"
+
+namespace Game {
+
+    int64_t manhattanDistance(Game::Vector p1, Game::Vector p2) {
+        int64_t dx = p1.x - p2.x;
+        int64_t dy = p1.y - p2.y;
+        return integerSqrt(dx * dx + dy * dy);
+    }
+
+    Vector::Vector(int x_a, int y_a) {
+        x = x_a;
+        y = y_a;
+    }
+
+    Vector::Vector(const Vector& vector) {
+        x = vector.x;
+        y = vector.y;
+    }
+
+    Vector::Vector() {
+        x = 0;
+        y = 0;
+    }
+
+    Vector rotatePoint(Vector point, Vector anchor, int degrees) {
+        int angle = degreesToAngle(degrees);
+        Fixed cosAngle = fixedCos(angle);
+        Fixed sinAngle = fixedSin(angle);
+        Fixed offsetX = Fixed(point.x - anchor.x);
+        Fixed offsetY = Fixed(point.y - anchor.y);
+        Vector rotated;
+        rotated.x = (cosAngle * offsetX - sinAngle * offsetY).toInt() + anchor.x;
+        rotated.y = (sinAngle * offsetX + cosAngle * offsetY).toInt() + anchor.y;
+        return rotated;
+    }
+
+    Circle::Circle() {
+        center = Vector(0, 0);
+        radius = 0;
+    }
+
+    Circle::Circle(const Vector& center_a, unsigned int radius_a) {
+        center = Vector(center_a);
+        radius = radius_a;
+    }
+
+    bool Circle::intersects(const Rect& rect) const {
+        bool containsTopLeft = contains(rect.topLeft);
+        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
+        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
+        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
+        return containsTopLeft || containsTopRight || containsBottomLeft || containsBottomRight;
+    }
+
+    bool Circle::contains(const Vector& point) const {
+        int64_t dx = point.x - center.x;
+        int64_t dy = point.y - center.y;
+        return static_cast<int64_t>(radius) * radius >= dx * dx + dy * dy;
+    }
+
+    bool Circle::contains(const Rect& rect) const {
+        bool containsTopLeft = contains(rect.topLeft);
+        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
+        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
+        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
+        return containsTopLeft && containsTopRight && containsBottomLeft && containsBottomRight;
+    }
+
+    Rect::Rect() {
+        topLeft = Vector(0, 0);
+        width = 0;
+        height = 0;
+    }
+
+    Rect::Rect(const Vector& topLeft_a, unsigned int width_a, unsigned int height_a) {
+        topLeft = topLeft_a;
+        width = width_a;
+        height = height_a;
+    }
+
+    bool Rect::contains(const Vector& point) const {
+        bool x_bound = (point.x >= topLeft.x && point.x <= topLeft.x + width);
+        bool y_bound = (point.y >= topLeft.y && point.y <= topLeft.y + height);
+        return x_bound && y_bound;
+    }
+
+    bool Rect::contains(const Rect& rect) const {
+        bool containsTopLeft = contains(rect.topLeft);
+        bool containsTopRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y));
+        bool containsBottomLeft = contains(Vector(rect.topLeft.x, rect.topLeft.y + rect.height));
+        bool containsBottomRight = contains(Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height));
+        return containsTopLeft && containsTopRight && containsBottomLeft && containsBottomRight;
+    }
+
+    Game::Vector Rect::getCenter() const {
+        if (width <= 0 || height <= 0) {
+            return topLeft;
+        }
+        return Game::Vector(topLeft.x + width / 2, topLeft.y + height / 2);
+    }
+
+    bool Rect::intersects(const Rect& rect) const {
+        bool xOverlap = topLeft.x <= rect.topLeft.x + rect.width && rect.topLeft.x <= topLeft.x + width;
+        bool yOverlap = topLeft.y <= rect.topLeft.y + rect.height && rect.topLeft.y <= topLeft.y + height;
+        return xOverlap && yOverlap;
+    }
+
+    bool Rect::operator==(const Rect& rect) const {
+        return topLeft.x == rect.topLeft.x && topLeft.y == rect.topLeft.y && width == rect.width && height == rect.height;
+    }
+
+}
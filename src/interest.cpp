@@ -0,0 +1,119 @@
+#include "interest.hpp"
+#include <algorithm>
+
+namespace Game {
+
+    namespace {
+
+        Rect expand(const Rect& rect, int margin) {
+            return Rect(Vector(rect.topLeft.x - margin, rect.topLeft.y - margin), rect.width + margin * 2, rect.height + margin * 2);
+        }
+
+        int getGap(const Rect& viewBox, const Rect& hitbox) {
+            int gapX = std::max(viewBox.topLeft.x - (hitbox.topLeft.x + hitbox.width), hitbox.topLeft.x - (viewBox.topLeft.x + viewBox.width));
+            int gapY = std::max(viewBox.topLeft.y - (hitbox.topLeft.y + hitbox.height), hitbox.topLeft.y - (viewBox.topLeft.y + viewBox.height));
+            return std::max(std::max(gapX, gapY), 0);
+        }
+
+        bool relevanceLess(const Relevance& relevance, unsigned int entityID) {
+            return relevance.entityID < entityID;
+        }
+
+    }
+
+    bool Relevance::isDue(unsigned int tick) const {
+        return (tick + entityID) % updateInterval == 0;
+    }
+
+    InterestManager::InterestManager() {
+        nextObserverID = 0;
+        lastCandidateCount = 0;
+    }
+
+    unsigned int InterestManager::addObserver(const Rect& viewBox) {
+        unsigned int observerID = nextObserverID++;
+        observers[observerID].viewBox = viewBox;
+        return observerID;
+    }
+
+    void InterestManager::removeObserver(unsigned int observerID) {
+        observers.erase(observerID);
+    }
+
+    void InterestManager::setViewBox(unsigned int observerID, const Rect& viewBox) {
+        observers.at(observerID).viewBox = viewBox;
+    }
+
+    void InterestManager::updateObserver(Map& map, Observer& observer) {
+        observer.entered.clear();
+        observer.left.clear();
+        Rect enterBox = expand(observer.viewBox, ENTER_MARGIN);
+        std::vector<unsigned int> candidates = map.getEntitiesInArea(expand(observer.viewBox, LEAVE_MARGIN));
+        std::sort(candidates.begin(), candidates.end());
+        lastCandidateCount += candidates.size();
+
+        scratch.clear();
+        std::vector<Relevance>::const_iterator previous = observer.relevant.begin();
+        for (unsigned int entityID : candidates) {
+            while (previous != observer.relevant.end() && previous->entityID < entityID) {
+                observer.left.push_back(previous->entityID);
+                previous++;
+            }
+            bool wasRelevant = previous != observer.relevant.end() && previous->entityID == entityID;
+            if (wasRelevant) {
+                previous++;
+            }
+            Rect hitbox = map.getEntityWithID(entityID)->getHitbox();
+            if (!wasRelevant && !hitbox.intersects(enterBox)) {
+                continue;
+            }
+            if (!wasRelevant) {
+                observer.entered.push_back(entityID);
+            }
+            int gap = getGap(observer.viewBox, hitbox);
+            Relevance relevance;
+            relevance.entityID = entityID;
+            relevance.updateInterval = gap == 0 ? 1 : (gap <= ENTER_MARGIN ? NEAR_INTERVAL : FAR_INTERVAL);
+            scratch.push_back(relevance);
+        }
+        for (; previous != observer.relevant.end(); previous++) {
+            observer.left.push_back(previous->entityID);
+        }
+        observer.relevant.swap(scratch);
+    }
+
+    void InterestManager::update(Map& map) {
+        lastCandidateCount = 0;
+        for (std::pair<const unsigned int, Observer>& entry : observers) {
+            updateObserver(map, entry.second);
+        }
+    }
+
+    void InterestManager::update(Map& map, unsigned int observerID) {
+        lastCandidateCount = 0;
+        updateObserver(map, observers.at(observerID));
+    }
+
+    const std::vector<Relevance>& InterestManager::getRelevant(unsigned int observerID) const {
+        return observers.at(observerID).relevant;
+    }
+
+    const std::vector<unsigned int>& InterestManager::getEntered(unsigned int observerID) const {
+        return observers.at(observerID).entered;
+    }
+
+    const std::vector<unsigned int>& InterestManager::getLeft(unsigned int observerID) const {
+        return observers.at(observerID).left;
+    }
+
+    bool InterestManager::isRelevant(unsigned int observerID, unsigned int entityID) const {
+        const std::vector<Relevance>& relevant = observers.at(observerID).relevant;
+        std::vector<Relevance>::const_iterator found = std::lower_bound(relevant.begin(), relevant.end(), entityID, relevanceLess);
+        return found != relevant.end() && found->entityID == entityID;
+    }
+
+    unsigned int InterestManager::getLastCandidateCount() const {
+        return lastCandidateCount;
+    }
+
+}
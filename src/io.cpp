@@ -3,9 +3,10 @@
 
 namespace IO {
 
-    EntityMovementKeyHandler::EntityMovementKeyHandler(const std::map<sf::Keyboard::Key, Game::Vector>& keyMovementMap_, Game::Map* map_, unsigned int entityID_) {
+    EntityMovementKeyHandler::EntityMovementKeyHandler(const std::map<sf::Keyboard::Key, Game::Vector>& keyMovementMap_, Game::Map* map_, std::vector<Game::Intent>* intents_, unsigned int entityID_) {
         keyMovementMap = keyMovementMap_;
         map = map_;
+        intents = intents_;
         entityID = entityID_;
     }
 
@@ -25,17 +26,19 @@ namespace IO {
     }
 
     void EntityMovementKeyHandler::onKeyPress(sf::Keyboard::Key pressed) {
-        if (entityValid()) {
-            map->getEntityWithID(entityID)->move(keyMovementMap[pressed]);
+        if (entityValid() && intents) {
+            intents->push_back(Game::Intent(Game::Intent::TYPE::MOVE, entityID, keyMovementMap[pressed]));
         }
     }
 
-    PlayerAttackMouseHandler::PlayerAttackMouseHandler(unsigned int entityID_, Game::Map* map_, Rendering::Camera* camera_, sf::Window* window_, std::vector<Rendering::Animation>* animations_, std::vector<sf::Texture>* attackAnimation_) {
+    PlayerAttackMouseHandler::PlayerAttackMouseHandler(unsigned int entityID_, Game::Map* map_, std::vector<Game::Intent>* intents_, Rendering::Camera* camera_, sf::Window* window_, std::vector<Rendering::Animation>* animations_, const Rendering::AssetRegistry* registry_, unsigned int attackAnimation_) {
         entityID = entityID_;
         map = map_;
+        intents = intents_;
         camera = camera_;
         framesSinceAttack = 0;
         animations = animations_;
+        registry = registry_;
         attackAnimation = attackAnimation_;
         window = window_;
     }
@@ -46,12 +49,11 @@ namespace IO {
 
     void PlayerAttackMouseHandler::spawnAttackAction(Game::Vector pos) {
         int entityRange = map->getEntityWithID(entityID)->getFinalStats().stats[Game::EntityStats::STAT::RNG];
-        int entityDamage = map->getEntityWithID(entityID)->getFinalStats().stats[Game::EntityStats::STAT::DMG];
-
-        std::unique_ptr<Game::CircleTargeting> targeting(new Game::CircleTargeting(Game::Circle(pos, entityRange)));
-        map->addActionToQueue(std::move(std::unique_ptr<Game::Action>(new Game::HitAction(static_cast<unsigned int>(entityDamage), map, std::move(targeting), &Game::PlayerTeam::PLAYER_TEAM))));
+        if (intents) {
+            intents->push_back(Game::Intent(Game::Intent::TYPE::ATTACK, entityID, pos));
+        }
 
-        animations->push_back(Rendering::Animation(attackAnimation, camera, window, Game::Rect(Game::Vector(pos.x + entityRange / 2, pos.y - entityRange / 2), entityRange, entityRange), 10));
+        animations->push_back(Rendering::Animation(registry, attackAnimation, camera, window, Game::Rect(Game::Vector(pos.x + entityRange / 2, pos.y - entityRange / 2), entityRange, entityRange), 10));
     }
 
     void PlayerAttackMouseHandler::onMouseEvent(sf::Vector2<int> position, sf::Mouse::Button pressed) {
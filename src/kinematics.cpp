@@ -0,0 +1,241 @@
+#include "kinematics.hpp"
+#include "gameLogic.hpp"
+
+namespace Game {
+
+    Kinematics::Kinematics() {
+        damping = Fixed::fromFraction(1, 2);
+    }
+
+    void Kinematics::add(unsigned int entityID) {
+        if (slots.find(entityID) != slots.end()) {
+            return;
+        }
+        slots[entityID] = entityIDs.size();
+        entityIDs.push_back(entityID);
+        velocityX.push_back(0);
+        velocityY.push_back(0);
+        impulseX.push_back(0);
+        impulseY.push_back(0);
+        remainderX.push_back(0);
+        remainderY.push_back(0);
+        stepX.push_back(0);
+        stepY.push_back(0);
+    }
+
+    void Kinematics::remove(unsigned int entityID) {
+        std::unordered_map<unsigned int, unsigned int>::iterator slot = slots.find(entityID);
+        if (slot == slots.end()) {
+            return;
+        }
+        unsigned int index = slot->second;
+        unsigned int last = entityIDs.size() - 1;
+        if (index != last) {
+            entityIDs[index] = entityIDs[last];
+            velocityX[index] = velocityX[last];
+            velocityY[index] = velocityY[last];
+            impulseX[index] = impulseX[last];
+            impulseY[index] = impulseY[last];
+            remainderX[index] = remainderX[last];
+            remainderY[index] = remainderY[last];
+            stepX[index] = stepX[last];
+            stepY[index] = stepY[last];
+            slots[entityIDs[index]] = index;
+        }
+        entityIDs.pop_back();
+        velocityX.pop_back();
+        velocityY.pop_back();
+        impulseX.pop_back();
+        impulseY.pop_back();
+        remainderX.pop_back();
+        remainderY.pop_back();
+        stepX.pop_back();
+        stepY.pop_back();
+        slots.erase(slot);
+    }
+
+    void Kinematics::addImpulse(unsigned int entityID, Fixed x, Fixed y) {
+        std::unordered_map<unsigned int, unsigned int>::iterator slot = slots.find(entityID);
+        if (slot != slots.end()) {
+            impulseX[slot->second] += x.getRaw();
+            impulseY[slot->second] += y.getRaw();
+        }
+    }
+
+    void Kinematics::setVelocity(unsigned int entityID, Fixed x, Fixed y) {
+        std::unordered_map<unsigned int, unsigned int>::iterator slot = slots.find(entityID);
+        if (slot != slots.end()) {
+            velocityX[slot->second] = x.getRaw();
+            velocityY[slot->second] = y.getRaw();
+        }
+    }
+
+    Kinematics::Motion Kinematics::getMotion(unsigned int entityID) const {
+        Motion motion = {};
+        std::unordered_map<unsigned int, unsigned int>::const_iterator slot = slots.find(entityID);
+        if (slot != slots.end()) {
+            motion.velocityX = velocityX[slot->second];
+            motion.velocityY = velocityY[slot->second];
+            motion.impulseX = impulseX[slot->second];
+            motion.impulseY = impulseY[slot->second];
+            motion.remainderX = remainderX[slot->second];
+            motion.remainderY = remainderY[slot->second];
+        }
+        return motion;
+    }
+
+    void Kinematics::setMotion(unsigned int entityID, const Motion& motion) {
+        std::unordered_map<unsigned int, unsigned int>::iterator slot = slots.find(entityID);
+        if (slot != slots.end()) {
+            velocityX[slot->second] = motion.velocityX;
+            velocityY[slot->second] = motion.velocityY;
+            impulseX[slot->second] = motion.impulseX;
+            impulseY[slot->second] = motion.impulseY;
+            remainderX[slot->second] = motion.remainderX;
+            remainderY[slot->second] = motion.remainderY;
+        }
+    }
+
+    void Kinematics::clear() {
+        entityIDs.clear();
+        velocityX.clear();
+        velocityY.clear();
+        impulseX.clear();
+        impulseY.clear();
+        remainderX.clear();
+        remainderY.clear();
+        stepX.clear();
+        stepY.clear();
+        slots.clear();
+    }
+
+    void Kinematics::reserve(unsigned int entityCount) {
+        slots.reserve(entityCount);
+        entityIDs.reserve(entityCount);
+        velocityX.reserve(entityCount);
+        velocityY.reserve(entityCount);
+        impulseX.reserve(entityCount);
+        impulseY.reserve(entityCount);
+        remainderX.reserve(entityCount);
+        remainderY.reserve(entityCount);
+        stepX.reserve(entityCount);
+        stepY.reserve(entityCount);
+    }
+
+    void Kinematics::build(const std::vector<unsigned int>& entityIDs_, const std::vector<Motion>& motions) {
+        clear();
+        reserve(entityIDs_.size());
+        entityIDs = entityIDs_;
+        for (unsigned int i = 0; i < entityIDs.size(); i++) {
+            slots[entityIDs[i]] = i;
+            velocityX.push_back(motions[i].velocityX);
+            velocityY.push_back(motions[i].velocityY);
+            impulseX.push_back(motions[i].impulseX);
+            impulseY.push_back(motions[i].impulseY);
+            remainderX.push_back(motions[i].remainderX);
+            remainderY.push_back(motions[i].remainderY);
+        }
+        stepX.assign(entityIDs.size(), 0);
+        stepY.assign(entityIDs.size(), 0);
+    }
+
+    Fixed Kinematics::getDamping() const {
+        return damping;
+    }
+
+    bool Kinematics::isMoving(unsigned int entityID) const {
+        std::unordered_map<unsigned int, unsigned int>::const_iterator slot = slots.find(entityID);
+        if (slot == slots.end()) {
+            return false;
+        }
+        return velocityX[slot->second] != 0 || velocityY[slot->second] != 0 || impulseX[slot->second] != 0 || impulseY[slot->second] != 0;
+    }
+
+    unsigned int Kinematics::getCount() const {
+        return entityIDs.size();
+    }
+
+    void Kinematics::applyImpulses() {
+        const unsigned int count = entityIDs.size();
+        int32_t* vx = velocityX.data();
+        int32_t* vy = velocityY.data();
+        int32_t* ix = impulseX.data();
+        int32_t* iy = impulseY.data();
+        for (unsigned int i = 0; i < count; i++) {
+            vx[i] += ix[i];
+            vy[i] += iy[i];
+            ix[i] = 0;
+            iy[i] = 0;
+        }
+    }
+
+    void Kinematics::computeSubstep() {
+        const unsigned int count = entityIDs.size();
+        const int32_t* vx = velocityX.data();
+        const int32_t* vy = velocityY.data();
+        int32_t* rx = remainderX.data();
+        int32_t* ry = remainderY.data();
+        int32_t* sx = stepX.data();
+        int32_t* sy = stepY.data();
+        for (unsigned int i = 0; i < count; i++) {
+            int32_t totalX = rx[i] + vx[i] / static_cast<int32_t>(SUBSTEPS);
+            int32_t totalY = ry[i] + vy[i] / static_cast<int32_t>(SUBSTEPS);
+            sx[i] = totalX / Fixed::ONE;
+            sy[i] = totalY / Fixed::ONE;
+            rx[i] = totalX - sx[i] * Fixed::ONE;
+            ry[i] = totalY - sy[i] * Fixed::ONE;
+        }
+    }
+
+    void Kinematics::resolveSubstep(Map* map) {
+        const unsigned int count = entityIDs.size();
+        for (unsigned int i = 0; i < count; i++) {
+            if (stepX[i] == 0 && stepY[i] == 0) {
+                continue;
+            }
+            Entity* entity = map->getEntityWithID(entityIDs[i]);
+            if (!entity) {
+                continue;
+            }
+            if (stepX[i] != 0) {
+                Rect before = entity->getHitbox();
+                entity->moveWithoutModifier(Vector(stepX[i], 0));
+                if (entity->getHitbox() == before) {
+                    velocityX[i] = 0;
+                    remainderX[i] = 0;
+                }
+            }
+            if (stepY[i] != 0) {
+                Rect before = entity->getHitbox();
+                entity->moveWithoutModifier(Vector(0, stepY[i]));
+                if (entity->getHitbox() == before) {
+                    velocityY[i] = 0;
+                    remainderY[i] = 0;
+                }
+            }
+        }
+    }
+
+    void Kinematics::applyDamping() {
+        const unsigned int count = entityIDs.size();
+        const int64_t dampingRaw = damping.getRaw();
+        int32_t* vx = velocityX.data();
+        int32_t* vy = velocityY.data();
+        for (unsigned int i = 0; i < count; i++) {
+            int32_t dampedX = static_cast<int32_t>(vx[i] * dampingRaw / Fixed::ONE);
+            int32_t dampedY = static_cast<int32_t>(vy[i] * dampingRaw / Fixed::ONE);
+            vx[i] = (dampedX > -REST_THRESHOLD && dampedX < REST_THRESHOLD) ? 0 : dampedX;
+            vy[i] = (dampedY > -REST_THRESHOLD && dampedY < REST_THRESHOLD) ? 0 : dampedY;
+        }
+    }
+
+    void Kinematics::integrate(Map* map) {
+        applyImpulses();
+        for (unsigned int substep = 0; substep < SUBSTEPS; substep++) {
+            computeSubstep();
+            resolveSubstep(map);
+        }
+        applyDamping();
+    }
+
+}
@@ -1,7 +1,138 @@
 #include "game.hpp"
+#include "network.hpp"
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+namespace {
+
+    bool parseUnsigned(const char* text, unsigned long maxValue, unsigned long& value) {
+        if (text[0] < '0' || text[0] > '9') {
+            return false;
+        }
+        char* end = NULL;
+        errno = 0;
+        value = std::strtoul(text, &end, 10);
+        return errno == 0 && *end == '\0' && value <= maxValue;
+    }
+
+    bool parseSeconds(const char* text, float& value) {
+        char* end = NULL;
+        errno = 0;
+        value = std::strtof(text, &end);
+        return end != text && errno == 0 && *end == '\0' && value >= 0;
+    }
+
+    int printUsage(const char* program) {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "  " << program << " [--record <path>] [--texture-budget <megabytes>]" << std::endl;
+        std::cout << "  " << program << " --replay <path>" << std::endl;
+        std::cout << "  " << program << " --server <port> [bots] [seconds]" << std::endl;
+        std::cout << "  " << program << " --simulate <ring name>" << std::endl;
+        std::cout << "  " << program << " --view <ring name>" << std::endl;
+        return 1;
+    }
+
+}
 
 int main(int argc, char * argv[]) {
+    std::string mode = argc >= 2 ? argv[1] : "";
+    if ((mode == "--replay" || mode == "--simulate" || mode == "--view") && argc != 3) {
+        return printUsage(argv[0]);
+    }
+
+    if (mode == "--replay") {
+        Game::ReplayPlayer player;
+        if (!player.open(argv[2])) {
+            std::cout << "Could not read replay " << argv[2] << std::endl;
+            return 1;
+        }
+        Game::Map map;
+        Game::ReplayResult result = player.play(map);
+        if (!result.loaded) {
+            std::cout << "Replay " << argv[2] << " has an unreadable initial snapshot." << std::endl;
+            return 1;
+        }
+        std::cout << "Played " << result.ticksPlayed << " of " << result.ticksRecorded << " ticks in " << result.milliseconds << " ms";
+        if (result.ticksPlayed > 0) {
+            std::cout << " (" << result.milliseconds * 1000 / result.ticksPlayed << " us per tick)";
+        }
+        std::cout << std::endl;
+        if (result.firstDivergentTick >= 0) {
+            std::cout << "State diverged at tick " << result.firstDivergentTick << std::endl;
+            return 2;
+        }
+        return 0;
+    }
+
+    if (mode == "--server") {
+        unsigned long port = 0;
+        unsigned long botCount = 0;
+        float seconds = 0;
+        if (argc < 3 || argc > 5 || !parseUnsigned(argv[2], USHRT_MAX, port) || port == 0
+            || (argc >= 4 && !parseUnsigned(argv[3], UINT_MAX, botCount))
+            || (argc >= 5 && !parseSeconds(argv[4], seconds))) {
+            return printUsage(argv[0]);
+        }
+        Net::GameServer server(static_cast<unsigned short>(port), 30);
+        if (!server.start()) {
+            std::cout << "Could not bind UDP port " << port << std::endl;
+            return 1;
+        }
+        std::atomic<bool> stopping(false);
+        std::vector<std::unique_ptr<Net::BotClient>> bots;
+        std::vector<std::thread> botThreads;
+        for (unsigned long i = 0; i < botCount; i++) {
+            bots.push_back(std::unique_ptr<Net::BotClient>(new Net::BotClient(sf::IpAddress::LocalHost, static_cast<unsigned short>(port), i + 1)));
+            botThreads.push_back(std::thread(&Net::BotClient::run, bots.back().get(), &stopping));
+        }
+        server.run(seconds, NULL);
+        stopping.store(true);
+        for (std::thread& botThread : botThreads) {
+            botThread.join();
+        }
+        for (const std::unique_ptr<Net::BotClient>& bot : bots) {
+            std::cout << "Bot entity " << bot->getEntityID() << ": " << bot->getBytesSent() << " B up, " << bot->getBytesReceived() << " B down, " << bot->getSnapshotsReceived() << " snapshots, " << bot->getSnapshotsDropped() << " dropped, " << bot->getVisibleEntityCount() << " entities visible" << std::endl;
+        }
+        return 0;
+    }
+
+    std::string recordingPath;
+    unsigned long textureBudget = 0;
+    bool textureBudgetSet = false;
+    if (mode != "--simulate" && mode != "--view") {
+        for (int i = 1; i < argc; i += 2) {
+            std::string option = argv[i];
+            if (i + 1 >= argc) {
+                return printUsage(argv[0]);
+            }
+            if (option == "--record") {
+                recordingPath = argv[i + 1];
+            }
+            else if (option == "--texture-budget" && parseUnsigned(argv[i + 1], UINT_MAX / (1024 * 1024), textureBudget)) {
+                textureBudgetSet = true;
+            }
+            else {
+                return printUsage(argv[0]);
+            }
+        }
+    }
+
     Main::GameInstance game;
+    if (mode == "--simulate") {
+        game.runSimulation(argv[2]);
+        return 0;
+    }
+    if (mode == "--view") {
+        game.runViewer(argv[2]);
+        return 0;
+    }
+    if (textureBudgetSet) {
+        game.setTextureBudget(static_cast<unsigned int>(textureBudget));
+    }
+    if (!recordingPath.empty()) {
+        game.record(recordingPath);
+    }
     game.run();
 
     return 0;
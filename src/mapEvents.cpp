@@ -0,0 +1,19 @@
+#include "mapEvents.hpp"
+
+namespace Game {
+
+    EventRing::EventRing() {
+        events.resize(CAPACITY);
+        head = 0;
+    }
+
+    void EventRing::push(const MapEvent& event) {
+        events[head & (CAPACITY - 1)] = event;
+        head++;
+    }
+
+    uint64_t EventRing::getHead() const {
+        return head;
+    }
+
+}
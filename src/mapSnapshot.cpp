@@ -0,0 +1,354 @@
+#include "mapSnapshot.hpp"
+#include "serialization.hpp"
+#include "mappedFile.hpp"
+
+namespace Game {
+
+    void MapSnapshot::writeSection(BinaryWriter& writer, SECTION tag, uint32_t count, const std::vector<char>& payload) {
+        SectionHeader header;
+        header.tag = static_cast<uint32_t>(tag);
+        header.count = count;
+        header.size = payload.size();
+        header.checksum = crc32(payload.data(), payload.size());
+        writer.write(header);
+        writer.writeBytes(payload.data(), payload.size());
+    }
+
+    void MapSnapshot::packStats(const EntityStats& stats, int32_t* values, int32_t* modifiers) {
+        for (std::pair<EntityStats::STAT, int> stat : stats.stats) {
+            values[static_cast<unsigned int>(stat.first)] = stat.second;
+        }
+        for (std::pair<EntityStats::STAT_MOD, Fixed> modifier : stats.statModifiers) {
+            modifiers[static_cast<unsigned int>(modifier.first)] = modifier.second.getRaw();
+        }
+    }
+
+    EntityStats MapSnapshot::unpackStats(const int32_t* values, const int32_t* modifiers) {
+        EntityStats stats;
+        for (unsigned int i = 0; i < EntityStats::STAT_COUNT; i++) {
+            stats.stats[static_cast<EntityStats::STAT>(i)] = values[i];
+        }
+        for (unsigned int i = 0; i < EntityStats::STAT_MOD_COUNT; i++) {
+            stats.statModifiers[static_cast<EntityStats::STAT_MOD>(i)] = Fixed::fromRaw(modifiers[i]);
+        }
+        return stats;
+    }
+
+    const MapSnapshot::Section* MapSnapshot::findSection(const std::vector<Section>& sections, SECTION tag) {
+        for (const Section& section : sections) {
+            if (section.tag == tag) {
+                return &section;
+            }
+        }
+        return NULL;
+    }
+
+    void MapSnapshot::save(Map& map, std::vector<char>& out) {
+        map.drainPendingActions();
+        BinaryWriter writer;
+        writer.write<uint32_t>(static_cast<uint32_t>(MAGIC));
+        writer.write<uint16_t>(static_cast<uint16_t>(VERSION));
+        writer.write<uint16_t>(7);
+
+        BinaryWriter meta;
+        meta.write<uint32_t>(map.currentMaxID);
+        meta.writeRect(map.playableArea);
+        meta.write<uint8_t>(map.reorderingEnabled ? 1 : 0);
+        meta.write<uint32_t>(map.playerID);
+        writeSection(writer, SECTION::META, 1, meta.getBuffer());
+
+        std::vector<EntityRow> rows(map.entities.size());
+        std::vector<BuffRow> buffRows;
+        BinaryWriter behaviours;
+        uint32_t behaviourCount = 0;
+        for (size_t i = 0; i < map.entities.size(); i++) {
+            const Entity& entity = map.entities[i];
+            EntityRow& row = rows[i];
+            std::memset(&row, 0, sizeof(EntityRow));
+            row.id = entity.id;
+            row.x = entity.hitbox.topLeft.x;
+            row.y = entity.hitbox.topLeft.y;
+            row.width = entity.hitbox.width;
+            row.height = entity.hitbox.height;
+            packStats(entity.baseStats, row.stats, row.statModifiers);
+            row.buffStart = buffRows.size();
+            row.buffCount = entity.buffs.size();
+            for (const Buff& buff : entity.buffs) {
+                BuffRow buffRow;
+                packStats(buff.getChanges(), buffRow.stats, buffRow.statModifiers);
+                buffRow.framesLeft = buff.getFramesLeft();
+                buffRow.framesMax = buff.getMaxFrames();
+                buffRow.frameInterval = buff.getFrameInterval();
+                buffRows.push_back(buffRow);
+            }
+            row.idleTicks = entity.idleTicks;
+            row.motion = map.kinematics.getMotion(entity.id);
+            row.team = static_cast<uint8_t>(entity.team);
+            row.awake = entity.awake ? 1 : 0;
+            const BehaviourProfile* profile = map.getBehaviourProfile(entity.id);
+            row.hasBehaviour = profile ? 1 : 0;
+            row.prefab = entity.prefab;
+            if (profile) {
+                behaviours.write<uint32_t>(entity.id);
+                behaviours.write<uint8_t>(static_cast<uint8_t>(profile->getProfileType()));
+                profile->save(behaviours);
+                behaviourCount++;
+            }
+        }
+        std::vector<char> entityBytes(rows.size() * sizeof(EntityRow));
+        if (!rows.empty()) {
+            std::memcpy(entityBytes.data(), rows.data(), entityBytes.size());
+        }
+        writeSection(writer, SECTION::ENTITIES, rows.size(), entityBytes);
+
+        std::vector<char> buffBytes(buffRows.size() * sizeof(BuffRow));
+        if (!buffRows.empty()) {
+            std::memcpy(buffBytes.data(), buffRows.data(), buffBytes.size());
+        }
+        writeSection(writer, SECTION::BUFFS, buffRows.size(), buffBytes);
+
+        BinaryWriter geometry;
+        for (const Rect& rect : map.staticGeometry) {
+            geometry.writeRect(rect);
+        }
+        writeSection(writer, SECTION::GEOMETRY, map.staticGeometry.size(), geometry.getBuffer());
+
+        BinaryWriter shapes;
+        for (std::unordered_map<unsigned int, Shape>::const_iterator it = map.entityShapes.begin(); it != map.entityShapes.end(); it++) {
+            shapes.write<uint32_t>(it->first);
+            shapes.writeShape(it->second);
+        }
+        writeSection(writer, SECTION::SHAPES, map.entityShapes.size(), shapes.getBuffer());
+
+        writeSection(writer, SECTION::BEHAVIOURS, behaviourCount, behaviours.getBuffer());
+
+        BinaryWriter actions;
+        for (const std::unique_ptr<Action>& action : map.actions) {
+            action->save(actions);
+        }
+        writeSection(writer, SECTION::ACTIONS, map.actions.size(), actions.getBuffer());
+
+        out.swap(writer.getBuffer());
+    }
+
+    void MapSnapshot::reset(Map& map) {
+        map.drainPendingActions();
+        map.actions.clear();
+        map.entities.clear();
+        map.entityIndices.clear();
+        map.grid.clear();
+        map.kinematics.clear();
+        map.staticLayer.clear();
+        map.staticGeometry.clear();
+        map.overlaps.clear();
+        map.entityShapes.clear();
+        map.movedEntities.clear();
+        map.awakeEntities.clear();
+        map.behaviourProfiles.clear();
+        map.reorderPhase = Map::REORDER_PHASE::IDLE;
+        map.ticksSinceReorder = 0;
+        map.reorderWriteIndex = 0;
+        map.reorderReadIndex = 0;
+        map.allEntitiesDirty = true;
+        map.stateGeneration++;
+    }
+
+    bool MapSnapshot::loadMeta(LoadedMap& loaded, const Section& section) {
+        BinaryReader reader(section.data, section.size);
+        uint8_t reorderingEnabled;
+        if (!reader.read(loaded.currentMaxID) || !reader.readRect(loaded.playableArea) || !reader.read(reorderingEnabled)) {
+            return false;
+        }
+        loaded.reorderingEnabled = reorderingEnabled != 0;
+        loaded.playerID = 0;
+        reader.read(loaded.playerID);
+        return true;
+    }
+
+    bool MapSnapshot::loadEntities(Map& map, LoadedMap& loaded, const Section& entitySection, const Section* buffSection) {
+        if (entitySection.size != static_cast<uint64_t>(entitySection.count) * sizeof(EntityRow)) {
+            return false;
+        }
+        uint32_t buffCount = buffSection ? buffSection->count : 0;
+        if (buffSection && buffSection->size != static_cast<uint64_t>(buffCount) * sizeof(BuffRow)) {
+            return false;
+        }
+        loaded.entities.reserve(entitySection.count);
+        loaded.entityIndices.reserve(entitySection.count);
+        loaded.entityIDs.reserve(entitySection.count);
+        loaded.hitboxes.reserve(entitySection.count);
+        loaded.motions.reserve(entitySection.count);
+        EntityRow row;
+        BuffRow buffRow;
+        for (uint32_t rowIndex = 0; rowIndex < entitySection.count; rowIndex++) {
+            std::memcpy(&row, entitySection.data + static_cast<size_t>(rowIndex) * sizeof(EntityRow), sizeof(EntityRow));
+            if (row.team > static_cast<uint8_t>(Team::TEAM::TERRAIN) || row.buffStart > buffCount || row.buffCount > buffCount - row.buffStart) {
+                return false;
+            }
+            if (row.id >= loaded.currentMaxID || !loaded.entityIndices.insert(std::make_pair(row.id, loaded.entities.size())).second) {
+                return false;
+            }
+            Rect hitbox(Vector(row.x, row.y), row.width, row.height);
+            EntityTemplate entityTemplate(unpackStats(row.stats, row.statModifiers), hitbox, NULL, static_cast<Team::TEAM>(row.team));
+            entityTemplate.prefab = row.prefab;
+            loaded.entities.push_back(Entity(entityTemplate, row.id, &map));
+            Entity& entity = loaded.entities.back();
+            entity.buffs.reserve(row.buffCount);
+            for (uint32_t i = row.buffStart; i < row.buffStart + row.buffCount; i++) {
+                std::memcpy(&buffRow, buffSection->data + static_cast<size_t>(i) * sizeof(BuffRow), sizeof(BuffRow));
+                Buff buff(unpackStats(buffRow.stats, buffRow.statModifiers), buffRow.framesMax, buffRow.frameInterval);
+                buff.setFramesLeft(buffRow.framesLeft);
+                entity.buffs.push_back(buff);
+            }
+            entity.idleTicks = row.idleTicks;
+            loaded.entityIDs.push_back(row.id);
+            loaded.hitboxes.push_back(hitbox);
+            loaded.motions.push_back(row.motion);
+            if (row.awake) {
+                entity.awake = true;
+                loaded.awakeEntities.push_back(row.id);
+            }
+        }
+        return true;
+    }
+
+    bool MapSnapshot::loadGeometry(LoadedMap& loaded, const Section& section) {
+        BinaryReader reader(section.data, section.size);
+        loaded.staticGeometry.reserve(section.count);
+        for (uint32_t i = 0; i < section.count; i++) {
+            Rect rect;
+            if (!reader.readRect(rect)) {
+                return false;
+            }
+            loaded.staticGeometry.push_back(rect);
+        }
+        return true;
+    }
+
+    bool MapSnapshot::loadBehaviours(Map& map, LoadedMap& loaded, const Section& section) {
+        BinaryReader reader(section.data, section.size);
+        for (uint32_t i = 0; i < section.count; i++) {
+            uint32_t entityID;
+            uint8_t profileType;
+            if (!reader.read(entityID) || !reader.read(profileType)) {
+                return false;
+            }
+            std::unordered_map<unsigned int, unsigned int>::const_iterator index = loaded.entityIndices.find(entityID);
+            if (index == loaded.entityIndices.end() || profileType > static_cast<uint8_t>(BehaviourProfile::PROFILE::GRUNT)) {
+                return false;
+            }
+            std::unique_ptr<BehaviourProfile> profile(BehaviourProfile::create(static_cast<BehaviourProfile::PROFILE>(profileType), entityID, &map));
+            if (!profile || !profile->load(reader)) {
+                return false;
+            }
+            loaded.behaviourProfiles[entityID] = std::move(profile);
+        }
+        return true;
+    }
+
+    bool MapSnapshot::loadShapes(LoadedMap& loaded, const Section& section) {
+        BinaryReader reader(section.data, section.size);
+        loaded.entityShapes.reserve(section.count);
+        for (uint32_t i = 0; i < section.count; i++) {
+            uint32_t entityID;
+            Shape shape;
+            if (!reader.read(entityID) || !reader.readShape(shape)) {
+                return false;
+            }
+            loaded.entityShapes[entityID] = shape;
+        }
+        return true;
+    }
+
+    bool MapSnapshot::loadActions(Map& map, LoadedMap& loaded, const Section& section) {
+        BinaryReader reader(section.data, section.size);
+        loaded.actions.reserve(section.count);
+        for (uint32_t i = 0; i < section.count; i++) {
+            std::unique_ptr<Action> action = Action::load(reader, &map);
+            if (!action) {
+                return false;
+            }
+            loaded.actions.push_back(std::move(action));
+        }
+        return true;
+    }
+
+    void MapSnapshot::commit(Map& map, LoadedMap& loaded) {
+        reset(map);
+        map.currentMaxID = loaded.currentMaxID;
+        map.playableArea = loaded.playableArea;
+        map.reorderingEnabled = loaded.reorderingEnabled;
+        map.playerID = loaded.playerID;
+        for (const Rect& rect : loaded.staticGeometry) {
+            map.addStaticGeometry(rect);
+        }
+        map.entities.swap(loaded.entities);
+        map.entityIndices.swap(loaded.entityIndices);
+        map.grid.build(loaded.entityIDs, loaded.hitboxes);
+        map.kinematics.build(loaded.entityIDs, loaded.motions);
+        map.overlaps.markMoved(loaded.entityIDs);
+        map.awakeEntities.swap(loaded.awakeEntities);
+        map.entityShapes.swap(loaded.entityShapes);
+        map.behaviourProfiles.swap(loaded.behaviourProfiles);
+        map.actions.swap(loaded.actions);
+    }
+
+    bool MapSnapshot::load(Map& map, const char* data, size_t size) {
+        BinaryReader reader(data, size);
+        uint32_t magic;
+        uint16_t version, sectionCount;
+        if (!reader.read(magic) || !reader.read(version) || !reader.read(sectionCount) || magic != MAGIC || version != VERSION) {
+            return false;
+        }
+        std::vector<Section> sections;
+        for (uint16_t i = 0; i < sectionCount; i++) {
+            SectionHeader header;
+            if (!reader.read(header)) {
+                return false;
+            }
+            const char* payload = reader.skip(header.size);
+            if (!payload || crc32(payload, header.size) != header.checksum) {
+                return false;
+            }
+            Section section;
+            section.tag = static_cast<SECTION>(header.tag);
+            section.count = header.count;
+            section.data = payload;
+            section.size = header.size;
+            sections.push_back(section);
+        }
+        const Section* meta = findSection(sections, SECTION::META);
+        const Section* entitySection = findSection(sections, SECTION::ENTITIES);
+        const Section* geometry = findSection(sections, SECTION::GEOMETRY);
+        const Section* shapes = findSection(sections, SECTION::SHAPES);
+        const Section* behaviours = findSection(sections, SECTION::BEHAVIOURS);
+        const Section* actions = findSection(sections, SECTION::ACTIONS);
+        LoadedMap loaded;
+        if (!meta || !entitySection
+            || !loadMeta(loaded, *meta)
+            || !loadEntities(map, loaded, *entitySection, findSection(sections, SECTION::BUFFS))
+            || (geometry && !loadGeometry(loaded, *geometry))
+            || (shapes && !loadShapes(loaded, *shapes))
+            || (behaviours && !loadBehaviours(map, loaded, *behaviours))
+            || (actions && !loadActions(map, loaded, *actions))) {
+            return false;
+        }
+        commit(map, loaded);
+        return true;
+    }
+
+    bool MapSnapshot::saveToFile(Map& map, const std::string& path) {
+        std::vector<char> contents;
+        save(map, contents);
+        return writeFile(path, contents);
+    }
+
+    bool MapSnapshot::loadFromFile(Map& map, const std::string& path) {
+        MappedFile file;
+        if (!file.open(path)) {
+            return false;
+        }
+        return load(map, file.getData(), file.getSize());
+    }
+
+}
@@ -0,0 +1,116 @@
+#include "mappedFile.hpp"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Game {
+
+    MappedFile::MappedFile() {
+        data = NULL;
+        size = 0;
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = NULL;
+#else
+        descriptor = -1;
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path) {
+        close();
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mappingHandle) {
+            close();
+            return false;
+        }
+        data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (!data) {
+            close();
+            return false;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle != INVALID_HANDLE_VALUE) {
+            CloseHandle(fileHandle);
+        }
+        data = NULL;
+        size = 0;
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    bool MappedFile::open(const std::string& path) {
+        close();
+        descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+            close();
+            return false;
+        }
+        void* mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        data = static_cast<const char*>(mapped);
+        size = status.st_size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+        data = NULL;
+        size = 0;
+        descriptor = -1;
+    }
+#endif
+
+    bool MappedFile::isOpen() const {
+        return data != NULL;
+    }
+
+    const char* MappedFile::getData() const {
+        return data;
+    }
+
+    size_t MappedFile::getSize() const {
+        return size;
+    }
+
+}
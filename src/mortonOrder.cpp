@@ -0,0 +1,89 @@
+#include "mortonOrder.hpp"
+#include <algorithm>
+
+namespace Game {
+
+    namespace {
+
+        uint32_t spreadBits(uint32_t value) {
+            value &= 0x0000ffff;
+            value = (value | (value << 8)) & 0x00ff00ff;
+            value = (value | (value << 4)) & 0x0f0f0f0f;
+            value = (value | (value << 2)) & 0x33333333;
+            value = (value | (value << 1)) & 0x55555555;
+            return value;
+        }
+
+    }
+
+    uint32_t mortonCode(uint32_t x, uint32_t y) {
+        return spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    MortonSorter::MortonSorter() {
+        width = 1;
+        runStart = 0;
+        left = leftEnd = right = rightEnd = output = 0;
+        mergingRun = false;
+        sorting = false;
+    }
+
+    void MortonSorter::begin(std::vector<Key>& keys_) {
+        keys.swap(keys_);
+        scratch.resize(keys.size());
+        width = 1;
+        runStart = 0;
+        mergingRun = false;
+        sorting = keys.size() > 1;
+    }
+
+    void MortonSorter::startRun() {
+        unsigned int size = keys.size();
+        left = runStart;
+        leftEnd = std::min(runStart + width, size);
+        right = leftEnd;
+        rightEnd = std::min(runStart + width * 2, size);
+        output = runStart;
+        mergingRun = true;
+    }
+
+    bool MortonSorter::step(unsigned int budget) {
+        while (sorting && budget > 0) {
+            if (!mergingRun) {
+                startRun();
+            }
+            while (budget > 0 && output < rightEnd) {
+                if (right >= rightEnd || (left < leftEnd && keys[left].code <= keys[right].code)) {
+                    scratch[output++] = keys[left++];
+                }
+                else {
+                    scratch[output++] = keys[right++];
+                }
+                budget--;
+            }
+            if (output < rightEnd) {
+                break;
+            }
+            mergingRun = false;
+            runStart = rightEnd;
+            if (runStart >= keys.size()) {
+                keys.swap(scratch);
+                runStart = 0;
+                width *= 2;
+                if (width >= keys.size()) {
+                    sorting = false;
+                }
+            }
+        }
+        return !sorting;
+    }
+
+    bool MortonSorter::isSorting() const {
+        return sorting;
+    }
+
+    const std::vector<MortonSorter::Key>& MortonSorter::getOrder() const {
+        return keys;
+    }
+
+}
@@ -0,0 +1,336 @@
+#include "netProtocol.hpp"
+#include <algorithm>
+
+namespace Net {
+
+    namespace {
+
+        const uint8_t FIELD_X = 1;
+        const uint8_t FIELD_Y = 2;
+        const uint8_t FIELD_SIZE = 4;
+        const uint8_t FIELD_HP = 8;
+        const uint8_t FIELD_TEAM = 16;
+        const uint8_t FIELD_ALL = FIELD_X | FIELD_Y | FIELD_SIZE | FIELD_HP | FIELD_TEAM;
+
+        uint16_t clampToShort(int value) {
+            return static_cast<uint16_t>(std::min(std::max(value, 0), 0xffff));
+        }
+
+        uint8_t getChangedFields(const EntityState& current, const EntityState* base) {
+            if (!base) {
+                return FIELD_ALL;
+            }
+            uint8_t fields = 0;
+            fields |= current.x != base->x ? FIELD_X : 0;
+            fields |= current.y != base->y ? FIELD_Y : 0;
+            fields |= current.width != base->width || current.height != base->height ? FIELD_SIZE : 0;
+            fields |= current.hp != base->hp ? FIELD_HP : 0;
+            fields |= current.team != base->team ? FIELD_TEAM : 0;
+            return fields;
+        }
+
+        bool idLess(const EntityState& state, uint32_t id) {
+            return state.id < id;
+        }
+
+    }
+
+    const EntityState* WorldState::find(uint32_t id) const {
+        std::vector<EntityState>::const_iterator found = std::lower_bound(entities.begin(), entities.end(), id, idLess);
+        if (found == entities.end() || found->id != id) {
+            return NULL;
+        }
+        return &*found;
+    }
+
+    EntityState quantiseEntity(const Game::Entity& entity) {
+        Game::Rect hitbox = entity.getHitbox();
+        EntityState state;
+        state.id = entity.getID();
+        state.x = hitbox.topLeft.x;
+        state.y = hitbox.topLeft.y;
+        state.width = clampToShort(hitbox.width);
+        state.height = clampToShort(hitbox.height);
+        state.hp = clampToShort(entity.getBaseStats().stats[Game::EntityStats::STAT::HP]);
+        state.team = static_cast<uint8_t>(entity.getTeam());
+        return state;
+    }
+
+    void captureWorldState(const Game::Map& map, uint32_t tick, WorldState& state) {
+        state.tick = tick;
+        state.entities.clear();
+        state.entities.reserve(map.getEntities().size());
+        for (const Game::Entity& entity : map.getEntities()) {
+            state.entities.push_back(quantiseEntity(entity));
+        }
+        std::sort(state.entities.begin(), state.entities.end(), [](const EntityState& first, const EntityState& second) {
+            return first.id < second.id;
+        });
+    }
+
+    void captureRelevantState(Game::Map& map, uint32_t tick, const std::vector<Game::Relevance>& relevant, const WorldState* lastSent, WorldState& state) {
+        state.tick = tick;
+        state.entities.clear();
+        state.entities.reserve(relevant.size());
+        for (const Game::Relevance& relevance : relevant) {
+            const EntityState* previous = lastSent ? lastSent->find(relevance.entityID) : NULL;
+            if (previous && !relevance.isDue(tick)) {
+                state.entities.push_back(*previous);
+            }
+            else {
+                state.entities.push_back(quantiseEntity(*map.getEntityWithID(relevance.entityID)));
+            }
+        }
+    }
+
+    void trimWorldState(WorldState& state, const Game::Vector& center, std::size_t count) {
+        if (state.entities.size() <= count) {
+            return;
+        }
+        auto distanceSquared = [&center](const EntityState& entity) {
+            int64_t dx = static_cast<int64_t>(entity.x) + entity.width / 2 - center.x;
+            int64_t dy = static_cast<int64_t>(entity.y) + entity.height / 2 - center.y;
+            return dx * dx + dy * dy;
+        };
+        std::nth_element(state.entities.begin(), state.entities.begin() + count, state.entities.end(), [&distanceSquared](const EntityState& first, const EntityState& second) {
+            return distanceSquared(first) < distanceSquared(second);
+        });
+        state.entities.resize(count);
+        std::sort(state.entities.begin(), state.entities.end(), [](const EntityState& first, const EntityState& second) {
+            return first.id < second.id;
+        });
+    }
+
+    void writeSnapshot(Game::BinaryWriter& writer, const WorldState& current, const WorldState* base) {
+        writer.write<uint8_t>(static_cast<uint8_t>(PACKET::SNAPSHOT));
+        writer.writeVarint(current.tick);
+        writer.write<uint8_t>(base ? 1 : 0);
+        if (base) {
+            writer.writeVarint(current.tick - base->tick);
+        }
+
+        std::vector<uint32_t> removed;
+        if (base) {
+            std::vector<EntityState>::const_iterator it = current.entities.begin();
+            for (const EntityState& previous : base->entities) {
+                while (it != current.entities.end() && it->id < previous.id) {
+                    it++;
+                }
+                if (it == current.entities.end() || it->id != previous.id) {
+                    removed.push_back(previous.id);
+                }
+            }
+        }
+        writer.writeVarint(removed.size());
+        uint32_t lastID = 0;
+        for (uint32_t id : removed) {
+            writer.writeVarint(id - lastID);
+            lastID = id;
+        }
+
+        Game::BinaryWriter changes;
+        uint32_t changedCount = 0;
+        lastID = 0;
+        std::vector<EntityState>::const_iterator baseIt;
+        if (base) {
+            baseIt = base->entities.begin();
+        }
+        for (const EntityState& state : current.entities) {
+            const EntityState* previous = NULL;
+            if (base) {
+                while (baseIt != base->entities.end() && baseIt->id < state.id) {
+                    baseIt++;
+                }
+                if (baseIt != base->entities.end() && baseIt->id == state.id) {
+                    previous = &*baseIt;
+                }
+            }
+            uint8_t fields = getChangedFields(state, previous);
+            if (fields == 0) {
+                continue;
+            }
+            changes.writeVarint(state.id - lastID);
+            lastID = state.id;
+            changes.write<uint8_t>(fields | (previous ? 0 : 0x80));
+            if (fields & FIELD_X) {
+                changes.writeSignedVarint(state.x - (previous ? previous->x : 0));
+            }
+            if (fields & FIELD_Y) {
+                changes.writeSignedVarint(state.y - (previous ? previous->y : 0));
+            }
+            if (fields & FIELD_SIZE) {
+                changes.writeVarint(state.width);
+                changes.writeVarint(state.height);
+            }
+            if (fields & FIELD_HP) {
+                changes.writeVarint(state.hp);
+            }
+            if (fields & FIELD_TEAM) {
+                changes.write<uint8_t>(state.team);
+            }
+            changedCount++;
+        }
+        writer.writeVarint(changedCount);
+        writer.writeBytes(changes.getBuffer().data(), changes.getSize());
+    }
+
+    bool readSnapshotHeader(Game::BinaryReader& reader, uint32_t& tick, bool& hasBase, uint32_t& baseTick) {
+        uint8_t type, baseFlag;
+        if (!reader.read(type) || type != static_cast<uint8_t>(PACKET::SNAPSHOT) || !reader.readVarint(tick) || !reader.read(baseFlag)) {
+            return false;
+        }
+        hasBase = baseFlag != 0;
+        baseTick = 0;
+        if (hasBase) {
+            uint32_t age;
+            if (!reader.readVarint(age) || age > tick) {
+                return false;
+            }
+            baseTick = tick - age;
+        }
+        return true;
+    }
+
+    bool readSnapshotBody(Game::BinaryReader& reader, const WorldState* base, WorldState& out) {
+        uint32_t removedCount;
+        if (!reader.readVarint(removedCount)) {
+            return false;
+        }
+        std::vector<uint32_t> removed;
+        uint32_t lastID = 0;
+        for (uint32_t i = 0; i < removedCount; i++) {
+            uint32_t delta;
+            if (!reader.readVarint(delta)) {
+                return false;
+            }
+            lastID += delta;
+            removed.push_back(lastID);
+        }
+
+        uint32_t changedCount;
+        if (!reader.readVarint(changedCount)) {
+            return false;
+        }
+        std::vector<EntityState> changed;
+        lastID = 0;
+        for (uint32_t i = 0; i < changedCount; i++) {
+            uint32_t delta;
+            uint8_t fields;
+            if (!reader.readVarint(delta) || !reader.read(fields)) {
+                return false;
+            }
+            lastID += delta;
+            const EntityState* previous = (fields & 0x80) || !base ? NULL : base->find(lastID);
+            if (!previous && (fields & FIELD_ALL) != FIELD_ALL) {
+                return false;
+            }
+            EntityState state;
+            if (previous) {
+                state = *previous;
+            }
+            state.id = lastID;
+            int32_t offset;
+            uint32_t value;
+            if (fields & FIELD_X) {
+                if (!reader.readSignedVarint(offset)) {
+                    return false;
+                }
+                state.x = (previous ? previous->x : 0) + offset;
+            }
+            if (fields & FIELD_Y) {
+                if (!reader.readSignedVarint(offset)) {
+                    return false;
+                }
+                state.y = (previous ? previous->y : 0) + offset;
+            }
+            if (fields & FIELD_SIZE) {
+                uint32_t height;
+                if (!reader.readVarint(value) || !reader.readVarint(height)) {
+                    return false;
+                }
+                state.width = clampToShort(value);
+                state.height = clampToShort(height);
+            }
+            if (fields & FIELD_HP) {
+                if (!reader.readVarint(value)) {
+                    return false;
+                }
+                state.hp = clampToShort(value);
+            }
+            if ((fields & FIELD_TEAM) && !reader.read(state.team)) {
+                return false;
+            }
+            changed.push_back(state);
+        }
+
+        out.entities.clear();
+        std::vector<uint32_t>::const_iterator removedIt = removed.begin();
+        std::vector<EntityState>::const_iterator changedIt = changed.begin();
+        if (base) {
+            for (const EntityState& previous : base->entities) {
+                while (changedIt != changed.end() && changedIt->id < previous.id) {
+                    out.entities.push_back(*changedIt);
+                    changedIt++;
+                }
+                while (removedIt != removed.end() && *removedIt < previous.id) {
+                    removedIt++;
+                }
+                if (removedIt != removed.end() && *removedIt == previous.id) {
+                    continue;
+                }
+                if (changedIt != changed.end() && changedIt->id == previous.id) {
+                    out.entities.push_back(*changedIt);
+                    changedIt++;
+                }
+                else {
+                    out.entities.push_back(previous);
+                }
+            }
+        }
+        out.entities.insert(out.entities.end(), changedIt, std::vector<EntityState>::const_iterator(changed.end()));
+        return true;
+    }
+
+    void writeInput(Game::BinaryWriter& writer, const InputPacket& input) {
+        writer.write<uint8_t>(static_cast<uint8_t>(PACKET::INPUT));
+        writer.write<uint8_t>(input.hasAck ? 1 : 0);
+        writer.writeVarint(input.ackedTick);
+        writer.write<uint8_t>(input.frames.size());
+        for (const InputFrame& frame : input.frames) {
+            writer.writeVarint(frame.sequence);
+            writer.write<uint8_t>(frame.intents.size());
+            for (const Game::Intent& intent : frame.intents) {
+                writer.write<uint8_t>(static_cast<uint8_t>(intent.type));
+                writer.writeSignedVarint(intent.vector.x);
+                writer.writeSignedVarint(intent.vector.y);
+            }
+        }
+    }
+
+    bool readInput(Game::BinaryReader& reader, InputPacket& input) {
+        uint8_t type, ackFlag, frameCount;
+        if (!reader.read(type) || type != static_cast<uint8_t>(PACKET::INPUT) || !reader.read(ackFlag) || !reader.readVarint(input.ackedTick) || !reader.read(frameCount)) {
+            return false;
+        }
+        input.hasAck = ackFlag != 0;
+        input.frames.clear();
+        for (uint8_t i = 0; i < frameCount; i++) {
+            InputFrame frame;
+            uint8_t intentCount;
+            if (!reader.readVarint(frame.sequence) || !reader.read(intentCount)) {
+                return false;
+            }
+            for (uint8_t j = 0; j < intentCount; j++) {
+                uint8_t intentType;
+                int32_t x, y;
+                if (!reader.read(intentType) || !reader.readSignedVarint(x) || !reader.readSignedVarint(y) || intentType > static_cast<uint8_t>(Game::Intent::TYPE::ATTACK)) {
+                    return false;
+                }
+                frame.intents.push_back(Game::Intent(static_cast<Game::Intent::TYPE>(intentType), 0, Game::Vector(x, y)));
+            }
+            input.frames.push_back(frame);
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,457 @@
+#include "network.hpp"
+#include <iostream>
+#include <algorithm>
+
+namespace Net {
+
+    namespace {
+
+        const float CLIENT_TIMEOUT = 5.f;
+        const float CONNECT_RETRY = 0.25f;
+        const int BOT_SPEED = 1;
+        const int VIEW_WIDTH = 1920;
+        const int VIEW_HEIGHT = 1080;
+
+        Game::Rect getViewAround(const Game::Entity& entity) {
+            Game::Vector center = entity.getHitbox().getCenter();
+            return Game::Rect(Game::Vector(center.x - VIEW_WIDTH / 2, center.y - VIEW_HEIGHT / 2), VIEW_WIDTH, VIEW_HEIGHT);
+        }
+
+        std::pair<uint32_t, unsigned short> makeClientKey(const sf::IpAddress& address, unsigned short port) {
+            return std::make_pair(address.toInteger(), port);
+        }
+
+        void sendPacket(sf::UdpSocket& socket, Game::BinaryWriter& writer, const sf::IpAddress& address, unsigned short port) {
+            socket.send(writer.getBuffer().data(), writer.getSize(), address, port);
+        }
+
+    }
+
+    GameServer::GameServer(unsigned short port_, unsigned int tickRate_) {
+        port = port_;
+        tickRate = tickRate_;
+        currentTick = 0;
+        datagram.resize(sf::UdpSocket::MaxDatagramSize);
+        intervalCPU = 0;
+        intervalMaxCPU = 0;
+        intervalTicks = 0;
+        oversizedSnapshots = 0;
+        intervalRelevant = 0;
+        map.setPlayableArea(Game::Rect(Game::Vector(-2000, -2000), 4000, 4000));
+        map.setEntityReordering(true);
+        map.createEntity(Game::EntityTemplate(Game::EntityStats(), Game::Rect(Game::Vector(100, 100), 100, 100), NULL, Game::Team::TEAM::ENEMY));
+    }
+
+    bool GameServer::start() {
+        if (socket.bind(port) != sf::Socket::Done) {
+            return false;
+        }
+        socket.setBlocking(false);
+        uptime.restart();
+        return true;
+    }
+
+    void GameServer::addClient(const sf::IpAddress& address, unsigned short port) {
+        std::pair<uint32_t, unsigned short> key = makeClientKey(address, port);
+        if (clients.find(key) == clients.end()) {
+            int spawnOffset = static_cast<int>(clients.size() % 16) * 150 - 1200;
+            Client client;
+            client.address = address;
+            client.port = port;
+            client.entityID = map.createEntity(Game::EntityTemplate(Game::EntityStats(), Game::Rect(Game::Vector(spawnOffset, -600), 100, 100), NULL, Game::Team::TEAM::PLAYER));
+            client.observerID = interest.addObserver(getViewAround(*map.getEntityWithID(client.entityID)));
+            map.addObserverEntity(client.entityID);
+            client.sent.resize(HISTORY_SIZE);
+            for (WorldState& state : client.sent) {
+                state.tick = UINT32_MAX;
+            }
+            client.lastSequence = 0;
+            client.ackedTick = 0;
+            client.hasAck = false;
+            client.lastAttackTick = 0;
+            client.hasAttacked = false;
+            client.tickIntents = 0;
+            client.bytesSent = 0;
+            client.bytesReceived = 0;
+            client.intervalBytesSent = 0;
+            client.lastHeard = uptime.getElapsedTime().asSeconds();
+            clients[key] = client;
+            std::cout << "Client " << address.toString() << ":" << port << " joined as entity " << client.entityID << std::endl;
+        }
+        Game::BinaryWriter welcome;
+        welcome.write<uint8_t>(static_cast<uint8_t>(PACKET::WELCOME));
+        welcome.writeVarint(clients[key].entityID);
+        welcome.writeVarint(tickRate);
+        sendPacket(socket, welcome, address, port);
+    }
+
+    void GameServer::removeClient(std::map<std::pair<uint32_t, unsigned short>, Client>::iterator client) {
+        std::cout << "Client " << client->second.address.toString() << ":" << client->second.port << " left" << std::endl;
+        map.removeObserverEntity(client->second.entityID);
+        map.removeEntity(client->second.entityID);
+        interest.removeObserver(client->second.observerID);
+        clients.erase(client);
+    }
+
+    void GameServer::handlePacket(const sf::IpAddress& address, unsigned short port, const char* data, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        PACKET type = static_cast<PACKET>(data[0]);
+        if (type == PACKET::CONNECT) {
+            addClient(address, port);
+            return;
+        }
+        std::map<std::pair<uint32_t, unsigned short>, Client>::iterator found = clients.find(makeClientKey(address, port));
+        if (found == clients.end()) {
+            return;
+        }
+        Client& client = found->second;
+        client.lastHeard = uptime.getElapsedTime().asSeconds();
+        client.bytesReceived += size;
+        if (type == PACKET::DISCONNECT) {
+            removeClient(found);
+            return;
+        }
+        if (type != PACKET::INPUT) {
+            return;
+        }
+        Game::BinaryReader reader(data, size);
+        InputPacket input;
+        if (!readInput(reader, input)) {
+            return;
+        }
+        if (input.hasAck && input.ackedTick <= currentTick && (!client.hasAck || input.ackedTick > client.ackedTick)) {
+            client.ackedTick = input.ackedTick;
+            client.hasAck = true;
+        }
+        for (InputFrame& frame : input.frames) {
+            if (frame.sequence <= client.lastSequence) {
+                continue;
+            }
+            client.lastSequence = frame.sequence;
+            for (unsigned int i = 0; i < frame.intents.size() && i < MAX_INTENTS_PER_FRAME; i++) {
+                Game::Intent& intent = frame.intents[i];
+                if (acceptIntent(client, intent)) {
+                    pendingIntents.push_back(intent);
+                }
+            }
+        }
+    }
+
+    bool GameServer::acceptIntent(Client& client, Game::Intent& intent) {
+        Game::Entity* entity = map.getEntityWithID(client.entityID);
+        if (!entity || client.tickIntents >= MAX_INTENTS_PER_TICK) {
+            return false;
+        }
+        intent.entityID = client.entityID;
+        if (intent.type == Game::Intent::TYPE::MOVE) {
+            intent.vector = Game::Vector(std::max(-1, std::min(1, intent.vector.x)), std::max(-1, std::min(1, intent.vector.y)));
+        }
+        else {
+            uint32_t attackDelay = static_cast<uint32_t>(std::max(0, entity->getFinalStats().stats[Game::EntityStats::STAT::ATK_DELAY]));
+            if (client.hasAttacked && currentTick - client.lastAttackTick < attackDelay) {
+                return false;
+            }
+            client.lastAttackTick = currentTick;
+            client.hasAttacked = true;
+        }
+        client.tickIntents++;
+        return true;
+    }
+
+    void GameServer::receivePackets() {
+        sf::IpAddress address;
+        unsigned short remotePort;
+        std::size_t received;
+        while (socket.receive(datagram.data(), datagram.size(), received, address, remotePort) == sf::Socket::Done) {
+            handlePacket(address, remotePort, datagram.data(), received);
+        }
+    }
+
+    void GameServer::removeTimedOutClients() {
+        float now = uptime.getElapsedTime().asSeconds();
+        std::map<std::pair<uint32_t, unsigned short>, Client>::iterator it = clients.begin();
+        while (it != clients.end()) {
+            std::map<std::pair<uint32_t, unsigned short>, Client>::iterator current = it++;
+            if (now - current->second.lastHeard > CLIENT_TIMEOUT) {
+                removeClient(current);
+            }
+        }
+    }
+
+    void GameServer::updateInterest() {
+        for (std::pair<const std::pair<uint32_t, unsigned short>, Client>& entry : clients) {
+            Game::Entity* entity = map.getEntityWithID(entry.second.entityID);
+            if (entity) {
+                interest.setViewBox(entry.second.observerID, getViewAround(*entity));
+            }
+        }
+        interest.update(map);
+    }
+
+    void GameServer::sendSnapshots() {
+        for (std::pair<const std::pair<uint32_t, unsigned short>, Client>& entry : clients) {
+            Client& client = entry.second;
+            const WorldState* base = NULL;
+            if (client.hasAck && currentTick - client.ackedTick < HISTORY_SIZE && client.sent[client.ackedTick % HISTORY_SIZE].tick == client.ackedTick) {
+                base = &client.sent[client.ackedTick % HISTORY_SIZE];
+            }
+            const WorldState* lastSent = NULL;
+            if (currentTick > 0 && client.sent[(currentTick - 1) % HISTORY_SIZE].tick == currentTick - 1) {
+                lastSent = &client.sent[(currentTick - 1) % HISTORY_SIZE];
+            }
+            WorldState& current = client.sent[currentTick % HISTORY_SIZE];
+            const std::vector<Game::Relevance>& relevant = interest.getRelevant(client.observerID);
+            captureRelevantState(map, currentTick, relevant, lastSent, current);
+            intervalRelevant += relevant.size();
+            Game::BinaryWriter writer;
+            writeSnapshot(writer, current, base);
+            if (writer.getSize() > sf::UdpSocket::MaxDatagramSize) {
+                oversizedSnapshots++;
+                Game::Entity* entity = map.getEntityWithID(client.entityID);
+                Game::Vector center = entity ? entity->getHitbox().getCenter() : Game::Vector(0, 0);
+                while (writer.getSize() > sf::UdpSocket::MaxDatagramSize && !current.entities.empty()) {
+                    uint64_t count = static_cast<uint64_t>(current.entities.size()) * sf::UdpSocket::MaxDatagramSize / writer.getSize() * 9 / 10;
+                    trimWorldState(current, center, static_cast<std::size_t>(count));
+                    writer = Game::BinaryWriter();
+                    writeSnapshot(writer, current, base);
+                }
+                if (writer.getSize() > sf::UdpSocket::MaxDatagramSize) {
+                    continue;
+                }
+            }
+            sendPacket(socket, writer, client.address, client.port);
+            client.bytesSent += writer.getSize();
+            client.intervalBytesSent += writer.getSize();
+        }
+    }
+
+    void GameServer::tick() {
+        sf::Clock cpuClock;
+        receivePackets();
+        removeTimedOutClients();
+        for (const Game::Intent& intent : pendingIntents) {
+            intent.apply(map);
+        }
+        pendingIntents.clear();
+        for (std::pair<const std::pair<uint32_t, unsigned short>, Client>& entry : clients) {
+            entry.second.tickIntents = 0;
+        }
+        map.tickAndApplyActions();
+        currentTick++;
+        updateInterest();
+        sendSnapshots();
+
+        float cpu = cpuClock.getElapsedTime().asSeconds() * 1000.f;
+        intervalCPU += cpu;
+        intervalMaxCPU = std::max(intervalMaxCPU, cpu);
+        intervalTicks++;
+        if (intervalTicks == tickRate) {
+            report();
+        }
+    }
+
+    void GameServer::report() {
+        std::cout << "Tick " << currentTick << ": " << map.getEntities().size() << " entities, CPU " << intervalCPU / intervalTicks << " ms avg, " << intervalMaxCPU << " ms max per tick";
+        if (oversizedSnapshots > 0) {
+            std::cout << ", " << oversizedSnapshots << " oversized snapshots trimmed";
+        }
+        if (!clients.empty()) {
+            std::cout << ", " << intervalRelevant / (intervalTicks * clients.size()) << " relevant entities per client";
+        }
+        std::cout << std::endl;
+        float seconds = static_cast<float>(intervalTicks) / tickRate;
+        for (std::pair<const std::pair<uint32_t, unsigned short>, Client>& entry : clients) {
+            Client& client = entry.second;
+            std::cout << "    entity " << client.entityID << " (" << client.address.toString() << ":" << client.port << "): " << client.intervalBytesSent / seconds << " B/s down, acked tick " << client.ackedTick << std::endl;
+            client.intervalBytesSent = 0;
+        }
+        intervalCPU = 0;
+        intervalMaxCPU = 0;
+        intervalTicks = 0;
+        oversizedSnapshots = 0;
+        intervalRelevant = 0;
+    }
+
+    void GameServer::run(float seconds, const std::atomic<bool>* stopping) {
+        sf::Time tickTime = sf::seconds(1.f / tickRate);
+        sf::Clock runClock;
+        sf::Time nextTick = sf::Time::Zero;
+        while ((seconds <= 0 || runClock.getElapsedTime().asSeconds() < seconds) && !(stopping && stopping->load())) {
+            tick();
+            nextTick += tickTime;
+            sf::Time remaining = nextTick - runClock.getElapsedTime();
+            if (remaining > sf::Time::Zero) {
+                sf::sleep(remaining);
+            }
+            else {
+                nextTick = runClock.getElapsedTime();
+            }
+        }
+    }
+
+    unsigned int GameServer::getClientCount() const {
+        return clients.size();
+    }
+
+    uint32_t GameServer::getCurrentTick() const {
+        return currentTick;
+    }
+
+    BotClient::BotClient(const sf::IpAddress& serverAddress_, unsigned short serverPort_, unsigned int seed) {
+        serverAddress = serverAddress_;
+        serverPort = serverPort_;
+        random.seed(seed);
+        connected = false;
+        entityID = 0;
+        tickRate = 30;
+        sequence = 0;
+        latestTick = 0;
+        hasSnapshot = false;
+        datagram.resize(sf::UdpSocket::MaxDatagramSize);
+        bytesSent = 0;
+        bytesReceived = 0;
+        snapshotsReceived = 0;
+        snapshotsDropped = 0;
+        for (unsigned int i = 0; i < HISTORY_SIZE; i++) {
+            history[i].tick = UINT32_MAX;
+        }
+        socket.bind(sf::Socket::AnyPort);
+        socket.setBlocking(false);
+    }
+
+    void BotClient::handleSnapshot(const char* data, std::size_t size) {
+        Game::BinaryReader reader(data, size);
+        uint32_t tick, baseTick;
+        bool hasBase;
+        if (!readSnapshotHeader(reader, tick, hasBase, baseTick) || (hasSnapshot && tick <= latestTick)) {
+            snapshotsDropped++;
+            return;
+        }
+        const WorldState* base = NULL;
+        if (hasBase) {
+            base = &history[baseTick % HISTORY_SIZE];
+            if (base->tick != baseTick) {
+                snapshotsDropped++;
+                return;
+            }
+        }
+        WorldState decoded;
+        decoded.tick = tick;
+        if (!readSnapshotBody(reader, base, decoded)) {
+            snapshotsDropped++;
+            return;
+        }
+        history[tick % HISTORY_SIZE] = std::move(decoded);
+        latestTick = tick;
+        hasSnapshot = true;
+        snapshotsReceived++;
+    }
+
+    void BotClient::receivePackets() {
+        sf::IpAddress address;
+        unsigned short port;
+        std::size_t received;
+        while (socket.receive(datagram.data(), datagram.size(), received, address, port) == sf::Socket::Done) {
+            if (address != serverAddress || port != serverPort || received == 0) {
+                continue;
+            }
+            bytesReceived += received;
+            PACKET type = static_cast<PACKET>(datagram[0]);
+            if (type == PACKET::WELCOME) {
+                Game::BinaryReader reader(datagram.data() + 1, received - 1);
+                uint32_t welcomeID, welcomeRate;
+                if (reader.readVarint(welcomeID) && reader.readVarint(welcomeRate) && welcomeRate > 0) {
+                    entityID = welcomeID;
+                    tickRate = welcomeRate;
+                    connected = true;
+                }
+            }
+            else if (type == PACKET::SNAPSHOT && connected) {
+                handleSnapshot(datagram.data(), received);
+            }
+        }
+    }
+
+    void BotClient::sendInput() {
+        std::uniform_int_distribution<int> speed(-BOT_SPEED, BOT_SPEED);
+        InputFrame frame;
+        frame.sequence = ++sequence;
+        frame.intents.push_back(Game::Intent(Game::Intent::TYPE::MOVE, entityID, Game::Vector(speed(random), speed(random))));
+        recentFrames.push_back(frame);
+        if (recentFrames.size() > REDUNDANT_FRAMES) {
+            recentFrames.erase(recentFrames.begin());
+        }
+
+        InputPacket input;
+        input.hasAck = hasSnapshot;
+        input.ackedTick = latestTick;
+        input.frames = recentFrames;
+        Game::BinaryWriter writer;
+        writeInput(writer, input);
+        sendPacket(socket, writer, serverAddress, serverPort);
+        bytesSent += writer.getSize();
+    }
+
+    void BotClient::run(const std::atomic<bool>* stopping) {
+        sf::Clock retryClock;
+        sf::Clock tickClock;
+        bool sentConnect = false;
+        while (!(stopping && stopping->load())) {
+            receivePackets();
+            if (!connected) {
+                if (!sentConnect || retryClock.getElapsedTime().asSeconds() > CONNECT_RETRY) {
+                    Game::BinaryWriter writer;
+                    writer.write<uint8_t>(static_cast<uint8_t>(PACKET::CONNECT));
+                    sendPacket(socket, writer, serverAddress, serverPort);
+                    bytesSent += writer.getSize();
+                    retryClock.restart();
+                    sentConnect = true;
+                }
+            }
+            else if (tickClock.getElapsedTime().asSeconds() >= 1.f / tickRate) {
+                tickClock.restart();
+                sendInput();
+            }
+            sf::sleep(sf::milliseconds(1));
+        }
+        if (connected) {
+            Game::BinaryWriter writer;
+            writer.write<uint8_t>(static_cast<uint8_t>(PACKET::DISCONNECT));
+            sendPacket(socket, writer, serverAddress, serverPort);
+        }
+    }
+
+    bool BotClient::isConnected() const {
+        return connected;
+    }
+
+    unsigned int BotClient::getEntityID() const {
+        return entityID;
+    }
+
+    uint64_t BotClient::getBytesSent() const {
+        return bytesSent;
+    }
+
+    uint64_t BotClient::getBytesReceived() const {
+        return bytesReceived;
+    }
+
+    unsigned int BotClient::getSnapshotsReceived() const {
+        return snapshotsReceived;
+    }
+
+    unsigned int BotClient::getSnapshotsDropped() const {
+        return snapshotsDropped;
+    }
+
+    std::size_t BotClient::getVisibleEntityCount() const {
+        if (!hasSnapshot) {
+            return 0;
+        }
+        return history[latestTick % HISTORY_SIZE].entities.size();
+    }
+
+}
@@ -0,0 +1,133 @@
+#include "overlapCache.hpp"
+#include <iterator>
+
+namespace Game {
+
+    namespace {
+
+        const std::vector<unsigned int> NO_PARTNERS;
+
+    }
+
+    OverlapCache::OverlapCache() {
+        stamp = 0;
+        pairTests = 0;
+    }
+
+    uint64_t OverlapCache::getPairKey(unsigned int first, unsigned int second) {
+        if (first > second) {
+            std::swap(first, second);
+        }
+        return (static_cast<uint64_t>(first) << 32) | second;
+    }
+
+    void OverlapCache::pushEvent(OverlapEvent::TYPE type, unsigned int first, unsigned int second) {
+        OverlapEvent event;
+        event.type = type;
+        event.first = std::min(first, second);
+        event.second = std::max(first, second);
+        events.push_back(event);
+    }
+
+    void OverlapCache::addPair(unsigned int first, unsigned int second) {
+        std::vector<unsigned int>& firstPartners = partners[first];
+        firstPartners.insert(std::lower_bound(firstPartners.begin(), firstPartners.end(), second), second);
+        std::vector<unsigned int>& secondPartners = partners[second];
+        secondPartners.insert(std::lower_bound(secondPartners.begin(), secondPartners.end(), first), first);
+        pairStamps[getPairKey(first, second)] = stamp;
+        pushEvent(OverlapEvent::TYPE::ENTER, first, second);
+    }
+
+    void OverlapCache::removePair(unsigned int first, unsigned int second) {
+        std::vector<unsigned int>& firstPartners = partners[first];
+        firstPartners.erase(std::lower_bound(firstPartners.begin(), firstPartners.end(), second));
+        std::vector<unsigned int>& secondPartners = partners[second];
+        secondPartners.erase(std::lower_bound(secondPartners.begin(), secondPartners.end(), first));
+        pairStamps.erase(getPairKey(first, second));
+        pushEvent(OverlapEvent::TYPE::EXIT, first, second);
+    }
+
+    void OverlapCache::refreshEntity(unsigned int entityID) {
+        std::vector<unsigned int>& previous = partners[entityID];
+        exited.clear();
+        std::set_difference(previous.begin(), previous.end(), current.begin(), current.end(), std::back_inserter(exited));
+        for (unsigned int partner : exited) {
+            removePair(entityID, partner);
+        }
+        for (unsigned int partner : current) {
+            std::unordered_map<uint64_t, unsigned int>::iterator pair = pairStamps.find(getPairKey(entityID, partner));
+            if (pair == pairStamps.end()) {
+                addPair(entityID, partner);
+            }
+            else if (pair->second != stamp) {
+                pair->second = stamp;
+                pushEvent(OverlapEvent::TYPE::STAY, entityID, partner);
+            }
+        }
+    }
+
+    void OverlapCache::beginTick() {
+        events.clear();
+    }
+
+    void OverlapCache::markMoved(unsigned int entityID) {
+        if (movedSet.insert(entityID).second) {
+            moved.push_back(entityID);
+        }
+    }
+
+    void OverlapCache::markMoved(const std::vector<unsigned int>& entityIDs) {
+        movedSet.reserve(movedSet.size() + entityIDs.size());
+        moved.reserve(moved.size() + entityIDs.size());
+        for (unsigned int entityID : entityIDs) {
+            markMoved(entityID);
+        }
+    }
+
+    void OverlapCache::remove(unsigned int entityID) {
+        std::unordered_map<unsigned int, std::vector<unsigned int>>::iterator found = partners.find(entityID);
+        if (found != partners.end()) {
+            std::vector<unsigned int> removing = found->second;
+            for (unsigned int partner : removing) {
+                removePair(entityID, partner);
+            }
+            partners.erase(entityID);
+        }
+        if (movedSet.erase(entityID)) {
+            moved.erase(std::find(moved.begin(), moved.end(), entityID));
+        }
+    }
+
+    void OverlapCache::clear() {
+        partners.clear();
+        pairStamps.clear();
+        moved.clear();
+        movedSet.clear();
+        events.clear();
+    }
+
+    const std::vector<unsigned int>& OverlapCache::getOverlapping(unsigned int entityID) const {
+        std::unordered_map<unsigned int, std::vector<unsigned int>>::const_iterator found = partners.find(entityID);
+        if (found == partners.end()) {
+            return NO_PARTNERS;
+        }
+        return found->second;
+    }
+
+    bool OverlapCache::overlapping(unsigned int first, unsigned int second) const {
+        return pairStamps.find(getPairKey(first, second)) != pairStamps.end();
+    }
+
+    const std::vector<OverlapEvent>& OverlapCache::getEvents() const {
+        return events;
+    }
+
+    unsigned int OverlapCache::getPairCount() const {
+        return pairStamps.size();
+    }
+
+    unsigned int OverlapCache::getPairTestCount() const {
+        return pairTests;
+    }
+
+}
@@ -0,0 +1,239 @@
+#include "prefabs.hpp"
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+
+namespace Game {
+
+    namespace {
+
+        const char* STAT_NAMES[EntityStats::STAT_COUNT] = { "MAX_HP", "HP", "MAX_STAM", "STAM", "SIGHT", "ATK_DELAY", "RNG", "DMG" };
+        const char* STAT_MOD_NAMES[EntityStats::STAT_MOD_COUNT] = { "MAX_HP", "MAX_STAM", "SIGHT", "ATK_DELAY", "MOVE", "DMG" };
+
+        bool parseTeam(const std::string& text, Team::TEAM& team) {
+            if (text == "PLAYER") {
+                team = Team::TEAM::PLAYER;
+            }
+            else if (text == "ENEMY") {
+                team = Team::TEAM::ENEMY;
+            }
+            else if (text == "TERRAIN") {
+                team = Team::TEAM::TERRAIN;
+            }
+            else {
+                return false;
+            }
+            return true;
+        }
+
+        bool parseInteger(const std::string& text, int& value) {
+            char* end = NULL;
+            long parsed = std::strtol(text.c_str(), &end, 10);
+            if (text.empty() || *end != '\0') {
+                return false;
+            }
+            value = static_cast<int>(parsed);
+            return true;
+        }
+
+        bool parseFixed(const std::string& text, Fixed& value) {
+            size_t point = text.find('.');
+            if (point == std::string::npos) {
+                int whole;
+                if (!parseInteger(text, whole)) {
+                    return false;
+                }
+                value = Fixed(whole);
+                return true;
+            }
+            std::string digits = text.substr(0, point) + text.substr(point + 1);
+            int numerator;
+            if (!parseInteger(digits, numerator) || text.size() - point - 1 > 4) {
+                return false;
+            }
+            int denominator = 1;
+            for (size_t i = point + 1; i < text.size(); i++) {
+                denominator *= 10;
+            }
+            value = Fixed::fromFraction(numerator, denominator);
+            return true;
+        }
+
+        int findName(const char* const* names, unsigned int count, const std::string& name) {
+            for (unsigned int i = 0; i < count; i++) {
+                if (name == names[i]) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+    }
+
+    SpawnPlacement SpawnPlacement::grid(const Vector& origin, unsigned int columns, const Vector& spacing) {
+        SpawnPlacement placement;
+        placement.type = TYPE::GRID;
+        placement.area = Rect(origin, 0, 0);
+        placement.columns = columns > 0 ? columns : 1;
+        placement.spacing = spacing;
+        placement.seed = 0;
+        return placement;
+    }
+
+    SpawnPlacement SpawnPlacement::scatter(const Rect& area, uint32_t seed) {
+        SpawnPlacement placement;
+        placement.type = TYPE::SCATTER;
+        placement.area = area;
+        placement.columns = 1;
+        placement.spacing = Vector(0, 0);
+        placement.seed = seed != 0 ? seed : 1;
+        return placement;
+    }
+
+    Vector SpawnPlacement::getPosition(unsigned int index, uint32_t& state) const {
+        if (type == TYPE::GRID) {
+            int column = static_cast<int>(index % columns);
+            int row = static_cast<int>(index / columns);
+            return Vector(area.topLeft.x + column * spacing.x, area.topLeft.y + row * spacing.y);
+        }
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int x = area.width > 0 ? static_cast<int>(state % static_cast<uint32_t>(area.width)) : 0;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int y = area.height > 0 ? static_cast<int>(state % static_cast<uint32_t>(area.height)) : 0;
+        return Vector(area.topLeft.x + x, area.topLeft.y + y);
+    }
+
+    bool PrefabLibrary::parseLine(const std::string& line, Prefab& prefab) {
+        std::istringstream fields(line);
+        std::string team, behaviour, width, height;
+        if (!(fields >> prefab.name >> team >> behaviour >> prefab.textureSet >> width >> height)) {
+            lastError = "expected: name team behaviour textureSet width height";
+            return false;
+        }
+        EntityStats stats;
+        Team::TEAM parsedTeam;
+        int parsedWidth, parsedHeight;
+        if (!parseTeam(team, parsedTeam)) {
+            lastError = "unknown team " + team;
+            return false;
+        }
+        if (!parseInteger(width, parsedWidth) || !parseInteger(height, parsedHeight) || parsedWidth <= 0 || parsedHeight <= 0) {
+            lastError = "bad hitbox size " + width + " " + height;
+            return false;
+        }
+        if (behaviour == "NONE") {
+            prefab.hasBehaviour = false;
+            prefab.behaviour = BehaviourProfile::PROFILE::GRUNT;
+        }
+        else if (behaviour == "GRUNT") {
+            prefab.hasBehaviour = true;
+            prefab.behaviour = BehaviourProfile::PROFILE::GRUNT;
+        }
+        else {
+            lastError = "unknown behaviour " + behaviour;
+            return false;
+        }
+
+        std::string field;
+        while (fields >> field) {
+            size_t split = field.find_first_of("=*");
+            if (split == std::string::npos) {
+                lastError = "expected STAT=value or MODIFIER*value, got " + field;
+                return false;
+            }
+            std::string name = field.substr(0, split);
+            std::string value = field.substr(split + 1);
+            if (field[split] == '=') {
+                int stat = findName(STAT_NAMES, EntityStats::STAT_COUNT, name);
+                int parsed;
+                if (stat < 0 || !parseInteger(value, parsed)) {
+                    lastError = "bad stat " + field;
+                    return false;
+                }
+                stats.stats[static_cast<EntityStats::STAT>(stat)] = parsed;
+            }
+            else {
+                int modifier = findName(STAT_MOD_NAMES, EntityStats::STAT_MOD_COUNT, name);
+                Fixed parsed;
+                if (modifier < 0 || !parseFixed(value, parsed)) {
+                    lastError = "bad modifier " + field;
+                    return false;
+                }
+                stats.statModifiers[static_cast<EntityStats::STAT_MOD>(modifier)] = parsed;
+            }
+        }
+        prefab.entityTemplate = EntityTemplate(stats, Rect(Vector(0, 0), parsedWidth, parsedHeight), NULL, parsedTeam);
+        return true;
+    }
+
+    bool PrefabLibrary::load(const std::string& text) {
+        prefabs.clear();
+        indices.clear();
+        lastError.clear();
+        std::istringstream lines(text);
+        std::string line;
+        unsigned int lineNumber = 0;
+        while (std::getline(lines, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            Prefab prefab;
+            if (!parseLine(line, prefab)) {
+                lastError = "line " + std::to_string(lineNumber) + ": " + lastError;
+                return false;
+            }
+            if (indices.count(prefab.name) > 0 || prefabs.size() == MAX_PREFABS) {
+                lastError = "line " + std::to_string(lineNumber) + ": duplicate prefab or too many prefabs";
+                return false;
+            }
+            prefab.entityTemplate.prefab = static_cast<uint8_t>(prefabs.size() + 1);
+            indices[prefab.name] = prefabs.size();
+            prefabs.push_back(prefab);
+        }
+        return true;
+    }
+
+    bool PrefabLibrary::loadFromFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            lastError = "could not open " + path;
+            return false;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return load(contents.str());
+    }
+
+    const Prefab* PrefabLibrary::find(const std::string& name) const {
+        std::unordered_map<std::string, unsigned int>::const_iterator found = indices.find(name);
+        if (found == indices.end()) {
+            return NULL;
+        }
+        return &prefabs[found->second];
+    }
+
+    const Prefab* PrefabLibrary::get(uint8_t prefabID) const {
+        if (prefabID == 0 || prefabID > prefabs.size()) {
+            return NULL;
+        }
+        return &prefabs[prefabID - 1];
+    }
+
+    unsigned int PrefabLibrary::getCount() const {
+        return prefabs.size();
+    }
+
+    const std::string& PrefabLibrary::getLastError() const {
+        return lastError;
+    }
+
+}
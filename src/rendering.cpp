@@ -1,6 +1,7 @@
 #include "rendering.hpp"
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include <cstdlib>
 
 
 namespace Rendering {
@@ -23,6 +24,10 @@ namespace Rendering {
         viewBox = newViewBox;
     }
 
+    Game::Rect Camera::getViewBox() const {
+        return viewBox;
+    }
+
     sf::Vector2<float> Camera::translate(const Game::Vector& gameCoords) {
         return sf::Vector2<float>(gameCoords.x - viewBox.topLeft.x, gameCoords.y - viewBox.topLeft.y);
     }
@@ -44,17 +49,19 @@ namespace Rendering {
     }
 
     sf::Vector2<float> scaleSpriteRelativeToWindow(const sf::Sprite& sprite, const sf::Window& window, const sf::Vector2<float>& size) {
-        const sf::Texture* spriteTexture = sprite.getTexture();
-        if (!spriteTexture || spriteTexture->getSize().x <= 0 || spriteTexture->getSize().y <= 0) {
+        const sf::IntRect& frameRect = sprite.getTextureRect();
+        if (!sprite.getTexture() || frameRect.width == 0 || frameRect.height == 0) {
             return sf::Vector2<float>(0.f, 0.f);
         }
-        float xScale = window.getSize().x * size.x / spriteTexture->getSize().x;
-        float yScale = window.getSize().y * size.y / spriteTexture->getSize().y;
+        float xScale = window.getSize().x * size.x / std::abs(frameRect.width);
+        float yScale = window.getSize().y * size.y / std::abs(frameRect.height);
         return sf::Vector2<float>(xScale, yScale);
     }
 
-    Animation::Animation(std::vector<sf::Texture>* animationSet_, Camera* camera_, sf::Window* window_, Game::Rect renderbox_, unsigned int frameDelay_) {
+    Animation::Animation(const AssetRegistry* registry_, unsigned int animationSet_, Camera* camera_, sf::Window* window_, Game::Rect renderbox_, unsigned int frameDelay_) {
+        registry = registry_;
         animationSet = animationSet_;
+        sequence = registry->getSequence(animationSet, 0);
         renderbox = renderbox_;
         frameDelay = frameDelay_;
         camera = camera_;
@@ -63,15 +70,13 @@ namespace Rendering {
         ticksSinceFrameChange = 0;
         done = false;
 
-        if (animationSet_) {
-            sprite.setTexture((*animationSet)[0]);
-        }
+        applyFrame(sprite, registry->getFrame(sequence, 0));
         scaleSprite();
         updateSprite();
     }
 
     void Animation::advanceSpriteFrame() {
-        if (currentFrame < animationSet->size() - 1) {
+        if (currentFrame + 1 < registry->getFrameCount(sequence)) {
             currentFrame++;
             updateSprite();
             scaleSprite();
@@ -86,7 +91,7 @@ namespace Rendering {
     }
 
     void Animation::updateSprite() {
-        sprite.setTexture((*animationSet)[currentFrame]);
+        applyFrame(sprite, registry->getFrame(sequence, currentFrame));
         sprite.setPosition(camera->translate(renderbox.topLeft));
     }
 
@@ -103,6 +108,10 @@ namespace Rendering {
         return sprite;
     }
 
+    unsigned int Animation::getAnimationSet() const {
+        return animationSet;
+    }
+
     bool Animation::doneAnimating() {
         return done;
     }
@@ -116,33 +125,261 @@ namespace Rendering {
         }
     }
 
-    EntityEventParser::EntityEventParser(Game::Map* map_, unsigned int entityID_) {
-        map = map_;
+    RenderSnapshot::RenderSnapshot() {
+        entities = NULL;
+        entityCount = 0;
+        events = NULL;
+        eventCount = 0;
+        tick = 0;
+        playerID = 0;
+        eventsComplete = true;
+        mapStats.awakeEntities = 0;
+        mapStats.sleepingEntities = 0;
+        syncedMap = NULL;
+        syncedCursor = 0;
+        syncedGeneration = 0;
+    }
+
+    void RenderSnapshot::fillEntity(EntitySnapshot& entitySnapshot, const Game::Entity& entity, bool awake) {
+        entitySnapshot.id = entity.getID();
+        entitySnapshot.hitbox = entity.getHitbox();
+        entitySnapshot.hp = entity.getBaseStats().stats.at(Game::EntityStats::STAT::HP);
+        entitySnapshot.awake = awake;
+        entitySnapshot.prefab = entity.getPrefab();
+    }
+
+    EntitySnapshot* RenderSnapshot::findStoredEntity(unsigned int entityID) {
+        std::vector<EntitySnapshot>::iterator found = std::lower_bound(entityStorage.begin(), entityStorage.end(), entityID, [](const EntitySnapshot& entitySnapshot, unsigned int id) {
+            return entitySnapshot.id < id;
+        });
+        if (found != entityStorage.end() && found->id == entityID) {
+            return &*found;
+        }
+        return NULL;
+    }
+
+    void RenderSnapshot::rebuildEntities(Game::Map& map) {
+        entityStorage.clear();
+        for (const Game::Entity& entity : map.getEntities()) {
+            EntitySnapshot entitySnapshot;
+            fillEntity(entitySnapshot, entity, map.isAwake(entity.getID()));
+            entityStorage.push_back(entitySnapshot);
+        }
+        std::sort(entityStorage.begin(), entityStorage.end(), [](const EntitySnapshot& first, const EntitySnapshot& second) {
+            return first.id < second.id;
+        });
+        awakeIDs = map.getAwakeEntityIDs();
+    }
+
+    bool RenderSnapshot::updateEntities(Game::Map& map) {
+        changedIDs.clear();
+        removedIDs.clear();
+        addedEntities.clear();
+        bool complete = map.getEvents().read(syncedCursor, [this](const Game::MapEvent& event) {
+            if (event.type == Game::MapEvent::TYPE::DIED || event.type == Game::MapEvent::TYPE::REMOVED) {
+                removedIDs.push_back(event.entityID);
+            }
+            else {
+                changedIDs.push_back(event.entityID);
+            }
+        });
+        if (!complete) {
+            return false;
+        }
+        for (unsigned int entityID : awakeIDs) {
+            EntitySnapshot* stored = findStoredEntity(entityID);
+            if (stored) {
+                stored->awake = false;
+            }
+        }
+        awakeIDs = map.getAwakeEntityIDs();
+        changedIDs.insert(changedIDs.end(), awakeIDs.begin(), awakeIDs.end());
+        for (unsigned int entityID : changedIDs) {
+            Game::Entity* entity = map.getEntityWithID(entityID);
+            if (!entity) {
+                removedIDs.push_back(entityID);
+                continue;
+            }
+            EntitySnapshot* stored = findStoredEntity(entityID);
+            if (stored) {
+                fillEntity(*stored, *entity, map.isAwake(entityID));
+            }
+            else {
+                EntitySnapshot entitySnapshot;
+                fillEntity(entitySnapshot, *entity, map.isAwake(entityID));
+                addedEntities.push_back(entitySnapshot);
+            }
+        }
+        if (!removedIDs.empty()) {
+            std::sort(removedIDs.begin(), removedIDs.end());
+            entityStorage.erase(std::remove_if(entityStorage.begin(), entityStorage.end(), [this, &map](const EntitySnapshot& entitySnapshot) {
+                return std::binary_search(removedIDs.begin(), removedIDs.end(), entitySnapshot.id) && !map.getEntityWithID(entitySnapshot.id);
+            }), entityStorage.end());
+        }
+        if (!addedEntities.empty()) {
+            std::sort(addedEntities.begin(), addedEntities.end(), [](const EntitySnapshot& first, const EntitySnapshot& second) {
+                return first.id < second.id;
+            });
+            addedEntities.erase(std::unique(addedEntities.begin(), addedEntities.end(), [](const EntitySnapshot& first, const EntitySnapshot& second) {
+                return first.id == second.id;
+            }), addedEntities.end());
+            size_t middle = entityStorage.size();
+            entityStorage.insert(entityStorage.end(), addedEntities.begin(), addedEntities.end());
+            if (middle > 0 && entityStorage[middle - 1].id > entityStorage[middle].id) {
+                std::inplace_merge(entityStorage.begin(), entityStorage.begin() + middle, entityStorage.end(), [](const EntitySnapshot& first, const EntitySnapshot& second) {
+                    return first.id < second.id;
+                });
+            }
+        }
+        return true;
+    }
+
+    void RenderSnapshot::capture(Game::Map& map, unsigned int tick_, uint64_t& eventCursor) {
+        tick = tick_;
+        playerID = map.getPlayerID();
+        mapStats = map.getStats();
+        eventStorage.clear();
+        eventsComplete = map.getEvents().read(eventCursor, [this](const Game::MapEvent& event) {
+            eventStorage.push_back(event);
+        });
+        if (syncedMap != &map || syncedGeneration != map.getStateGeneration() || !updateEntities(map)) {
+            rebuildEntities(map);
+        }
+        syncedMap = &map;
+        syncedGeneration = map.getStateGeneration();
+        syncedCursor = map.getEvents().getHead();
+        entities = entityStorage.data();
+        entityCount = entityStorage.size();
+        events = eventStorage.data();
+        eventCount = eventStorage.size();
+    }
+
+    void RenderSnapshot::view(const SnapshotRing& ring, const SnapshotSlot& slot, bool eventsContiguous) {
+        tick = slot.tick;
+        playerID = slot.playerID;
+        mapStats.awakeEntities = slot.awakeEntities;
+        mapStats.sleepingEntities = slot.sleepingEntities;
+        eventsComplete = eventsContiguous && slot.eventsComplete != 0;
+        entities = ring.getEntities(&slot);
+        entityCount = slot.entityCount;
+        events = ring.getEvents(&slot);
+        eventCount = slot.eventCount;
+    }
+
+    void RenderSnapshot::clear() {
+        syncedMap = NULL;
+        awakeIDs.clear();
+        entityStorage.clear();
+        eventStorage.clear();
+        entities = NULL;
+        entityCount = 0;
+        events = NULL;
+        eventCount = 0;
+        eventsComplete = false;
+    }
+
+    const EntitySnapshot* RenderSnapshot::findEntity(unsigned int entityID) const {
+        const EntitySnapshot* end = entities + entityCount;
+        const EntitySnapshot* found = std::lower_bound(entities, end, entityID, [](const EntitySnapshot& entitySnapshot, unsigned int id) {
+            return entitySnapshot.id < id;
+        });
+        if (found != end && found->id == entityID) {
+            return found;
+        }
+        return NULL;
+    }
+
+    const EntitySnapshot* RenderSnapshot::getEntities() const {
+        return entities;
+    }
+
+    unsigned int RenderSnapshot::getEntityCount() const {
+        return entityCount;
+    }
+
+    const Game::MapEvent* RenderSnapshot::getEvents() const {
+        return events;
+    }
+
+    unsigned int RenderSnapshot::getEventCount() const {
+        return eventCount;
+    }
+
+    bool RenderSnapshot::hasCompleteEvents() const {
+        return eventsComplete;
+    }
+
+    const Game::MapStats& RenderSnapshot::getMapStats() const {
+        return mapStats;
+    }
+
+    unsigned int RenderSnapshot::getTick() const {
+        return tick;
+    }
+
+    unsigned int RenderSnapshot::getPlayerID() const {
+        return playerID;
+    }
+
+    SnapshotBuffer::SnapshotBuffer() {
+        back = 0;
+        middle.store(1);
+        front = 2;
+    }
+
+    RenderSnapshot& SnapshotBuffer::getBack() {
+        return snapshots[back];
+    }
+
+    void SnapshotBuffer::publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    const RenderSnapshot& SnapshotBuffer::acquireFront() {
+        if (middle.load(std::memory_order_relaxed) & FRESH) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return snapshots[front];
+    }
+
+    const RenderSnapshot& SnapshotBuffer::getFront() const {
+        return snapshots[front];
+    }
+
+    EntityEventParser::EntityEventParser(const SnapshotBuffer* snapshots_, unsigned int entityID_) {
         entityID = entityID_;
+        hitPending = false;
         currentState = STATE::IDLE;
-
-        if (entityValid()) {
-            lastState = map_->getEntityWithID(entityID_)->getState();
+        const EntitySnapshot* entitySnapshot = NULL;
+        if (snapshots_) {
+            entitySnapshot = snapshots_->getFront().findEntity(entityID);
+        }
+        alive = entitySnapshot != NULL;
+        if (entitySnapshot) {
+            hitbox = entitySnapshot->hitbox;
         }
         else {
-            lastState = Game::EntityTemplate();
+            hitbox = Game::Rect(Game::Vector(0, 0), 1, 1);
         }
     }
 
     EntityEventParser::EntityEventParser(const EntityEventParser& copying) {
-        map = copying.map;
         entityID = copying.entityID;
-        lastState = copying.lastState;
+        hitbox = copying.hitbox;
+        alive = copying.alive;
+        hitPending = copying.hitPending;
         currentState = STATE::IDLE;
     }
 
     EntityEventParser::EntityEventParser() {
-        map = NULL;
         entityID = 0;
+        hitbox = Game::Rect(Game::Vector(0, 0), 1, 1);
+        alive = false;
+        hitPending = false;
         currentState = STATE::IDLE;
     }
 
-    unsigned int EntityEventParser::getEntityID() {
+    unsigned int EntityEventParser::getEntityID() const {
         return entityID;
     }
 
@@ -150,56 +387,68 @@ namespace Rendering {
         entityID = newID;
     }
 
-    void EntityEventParser::updateCurrentState() {
-        if (entityValid()) {
-            Game::EntityStats currentEntityState = map->getEntityWithID(entityID)->getState().stats;
-
-            if (lastState.stats.stats[Game::EntityStats::STAT::HP] > currentEntityState.stats[Game::EntityStats::STAT::HP]) {
-                currentState = EntityEventParser::STATE::HIT;
-            }
-            else {
-                currentState = EntityEventParser::STATE::IDLE;
-            }
+    void EntityEventParser::onEvent(const Game::MapEvent& event) {
+        if (event.entityID != entityID) {
+            return;
+        }
+        switch (event.type) {
+            case Game::MapEvent::TYPE::DAMAGED:
+                hitPending = true;
+                break;
+            case Game::MapEvent::TYPE::SPAWNED:
+            case Game::MapEvent::TYPE::MOVED:
+                hitbox = event.hitbox;
+                alive = true;
+                break;
+            case Game::MapEvent::TYPE::DIED:
+            case Game::MapEvent::TYPE::REMOVED:
+                alive = false;
+                break;
+            default:
+                break;
         }
     }
 
-    void EntityEventParser::grabEntityState() {
-        if (entityValid()) {
-            lastState = map->getEntityWithID(entityID)->getState();
+    void EntityEventParser::updateCurrentState() {
+        if (hitPending) {
+            currentState = EntityEventParser::STATE::HIT;
+            hitPending = false;
+        }
+        else {
+            currentState = EntityEventParser::STATE::IDLE;
         }
     }
 
     bool EntityEventParser::entityValid() const {
-        if (map && map->getEntityWithID(entityID)) {
-            return true;
-        }
-        return false;
+        return alive;
     }
 
     EntityEventParser::STATE EntityEventParser::getEntityState() {
         updateCurrentState();
-        grabEntityState();
         return currentState;
     }
 
     Game::Rect EntityEventParser::getEntityHitbox() {
-        if (entityValid()) {
-            return map->getEntityWithID(entityID)->getHitbox();
-        }
-        return Game::Rect(Game::Vector(0, 0), 1, 1);
+        return hitbox;
     }
 
-    const std::vector<std::string> EntityRenderer::stateTextureNames = { "idle", "hit" };
+    const std::vector<std::string> EntityRenderer::stateTextureNames = { "hit", "idle" };
 
-    const std::map <EntityEventParser::STATE, std::string> EntityRenderer::stateToTextureName = { {EntityEventParser::STATE::HIT, "hit"}, {EntityEventParser::STATE::IDLE, "idle"} };
+    StateSequences::StateSequences() {
+        idle = AssetRegistry::NONE;
+        hit = AssetRegistry::NONE;
+    }
 
-    EntityRenderer::EntityRenderer(const EntityEventParser& entityEventParser_, Rendering::Camera* camera_, sf::Window* window_, std::map<std::string, std::vector<sf::Texture>>* textureSet_, unsigned int frameDelay_) {
+    EntityRenderer::EntityRenderer(const EntityEventParser& entityEventParser_, Rendering::Camera* camera_, sf::Window* window_, const AssetRegistry* registry_, unsigned int textureSet_, const StateSequences& sequences, unsigned int frameDelay_) {
         entityEventParser = EntityEventParser(entityEventParser_);
         camera = camera_;
+        registry = registry_;
         textureSet = textureSet_;
         window = window_;
         lastState = EntityEventParser::STATE::IDLE;
-        currentTextureSet = &(*textureSet)["idle"];
+        idleSequence = sequences.idle;
+        hitSequence = sequences.hit;
+        currentSequence = idleSequence;
         frameDelay = frameDelay_;
         currentFrame = 0;
         ticksSinceFrameChange = 0;
@@ -220,7 +469,11 @@ namespace Rendering {
     }
 
     void EntityRenderer::switchAnim(EntityEventParser::STATE newState) {
-        currentTextureSet = &(*textureSet)[stateToTextureName.find(newState)->second];
+        unsigned int sequence = newState == EntityEventParser::STATE::HIT ? hitSequence : idleSequence;
+        if (sequence == AssetRegistry::NONE && newState != EntityEventParser::STATE::IDLE) {
+            return;
+        }
+        currentSequence = sequence;
         currentlyAnimating = newState;
         currentFrame = 0;
         if (frameDelay != 0) {
@@ -233,13 +486,13 @@ namespace Rendering {
     }
 
     void EntityRenderer::tickCurrentAnim() {
-        if (currentFrame < currentTextureSet->size() - 1) {
+        if (currentFrame + 1 < registry->getFrameCount(currentSequence)) {
             currentFrame++;
         }
         else {
             switchAnim(EntityEventParser::STATE::IDLE);
         }
-        sprite.setTexture((*currentTextureSet)[currentFrame]);
+        applyFrame(sprite, registry->getFrame(currentSequence, currentFrame));
         scaleSprite();
     }
 
@@ -269,6 +522,10 @@ namespace Rendering {
         }
     }
 
+    void EntityRenderer::onEvent(const Game::MapEvent& event) {
+        entityEventParser.onEvent(event);
+    }
+
     void EntityRenderer::setCamera(Camera* camera_) {
         camera = camera_;
     }
@@ -277,6 +534,10 @@ namespace Rendering {
         return entityEventParser;
     }
 
+    unsigned int EntityRenderer::getTextureSet() const {
+        return textureSet;
+    }
+
     Camera* EntityRenderer::getCamera() {
         return camera;
     }
@@ -299,9 +560,9 @@ namespace Rendering {
 
     void Background::updateBackgroundSprite() {
         sf::Rect<int> newTextureRect = sprite.getTextureRect();
-        sf::Vector2<float> rectScale = camera->scaleSpriteToMatcHitbox(sprite, *window, renderZone);
-        newTextureRect.width = (float)newTextureRect.width * rectScale.x;
-        newTextureRect.height = (float)newTextureRect.height * rectScale.y;
+        Game::Rect viewBox = camera->getViewBox();
+        newTextureRect.width = (float)window->getSize().x * renderZone.width / viewBox.width;
+        newTextureRect.height = (float)window->getSize().y * renderZone.height / viewBox.height;
         sprite.setTextureRect(newTextureRect);
         sprite.setPosition(camera->translate(renderZone.topLeft));
     }
@@ -311,7 +572,9 @@ namespace Rendering {
     }
 
     AbsoluteBackground::AbsoluteBackground() {
-        backgroundFrames = NULL;
+        registry = NULL;
+        backgroundSet = AssetRegistry::NONE;
+        sequence = AssetRegistry::NONE;
         currentFrame = 0;
         window = NULL;
         frameDelay = 1;
@@ -321,7 +584,9 @@ namespace Rendering {
     }
 
     AbsoluteBackground::AbsoluteBackground(const AbsoluteBackground& copying) {
-        backgroundFrames = copying.backgroundFrames;
+        registry = copying.registry;
+        backgroundSet = copying.backgroundSet;
+        sequence = copying.sequence;
         currentFrame = copying.currentFrame;
         window = copying.window;
         frameDelay = copying.frameDelay;
@@ -330,8 +595,10 @@ namespace Rendering {
         frameAscending = copying.frameAscending;
     }
 
-    AbsoluteBackground::AbsoluteBackground(std::vector<sf::Texture>* backgroundFrames_, sf::Window* window_, unsigned int frameDelay_) {
-        backgroundFrames = backgroundFrames_;
+    AbsoluteBackground::AbsoluteBackground(const AssetRegistry* registry_, unsigned int backgroundSet_, sf::Window* window_, unsigned int frameDelay_) {
+        registry = registry_;
+        backgroundSet = backgroundSet_;
+        sequence = registry->getSequence(backgroundSet, 0);
         currentFrame = 0;
         window = window_;
         frameDelay = frameDelay_;
@@ -340,8 +607,13 @@ namespace Rendering {
         frameAscending = true;
     }
 
-    void AbsoluteBackground::setTextureSet(std::vector<sf::Texture>* backgroundFrames_) {
-        backgroundFrames = backgroundFrames_;
+    void AbsoluteBackground::setTextureSet(unsigned int backgroundSet_) {
+        backgroundSet = backgroundSet_;
+        sequence = registry ? registry->getSequence(backgroundSet, 0) : static_cast<unsigned int>(AssetRegistry::NONE);
+    }
+
+    unsigned int AbsoluteBackground::getTextureSet() const {
+        return backgroundSet;
     }
 
     void AbsoluteBackground::setWindow(sf::Window* window_) {
@@ -370,7 +642,7 @@ namespace Rendering {
     }
 
     void AbsoluteBackground::nextFrame() {
-        if (currentFrame < backgroundFrames->size() - 1) {
+        if (currentFrame + 1 < registry->getFrameCount(sequence)) {
             currentFrame++;
         }
         else {
@@ -380,7 +652,7 @@ namespace Rendering {
 
     void AbsoluteBackground::nextFrameLooping() {
         if (frameAscending) {
-            if (currentFrame < backgroundFrames->size() - 1) {
+            if (currentFrame + 1 < registry->getFrameCount(sequence)) {
                 currentFrame++;
             }
             else {
@@ -406,8 +678,11 @@ namespace Rendering {
             ticksSinceFrameChange = 0;
         }
 
-        if (!backgroundFrames->empty()) {
-            sprite.setTexture((*backgroundFrames)[currentFrame]);
+        if (currentFrame >= registry->getFrameCount(sequence)) {
+            currentFrame = 0;
+        }
+        if (registry->getFrameCount(sequence) > 0) {
+            applyFrame(sprite, registry->getFrame(sequence, currentFrame));
             scaleSprite();
         }
     }
@@ -0,0 +1,220 @@
+#include "replay.hpp"
+#include "mapSnapshot.hpp"
+#include <chrono>
+
+namespace Game {
+
+    namespace {
+
+        const uint32_t REPLAY_MAGIC = 0x4c505247;
+        const uint16_t REPLAY_VERSION = 3;
+
+    }
+
+    Intent::Intent() {
+        type = TYPE::MOVE;
+        entityID = 0;
+        vector = Vector(0, 0);
+    }
+
+    Intent::Intent(TYPE type_, unsigned int entityID_, const Vector& vector_) {
+        type = type_;
+        entityID = entityID_;
+        vector = vector_;
+    }
+
+    bool Intent::operator==(const Intent& other) const {
+        return type == other.type && entityID == other.entityID && vector.x == other.vector.x && vector.y == other.vector.y;
+    }
+
+    bool Intent::operator!=(const Intent& other) const {
+        return !(*this == other);
+    }
+
+    void Intent::apply(Map& map) const {
+        Entity* entity = map.getEntityWithID(entityID);
+        if (!entity) {
+            return;
+        }
+        switch (type) {
+            case TYPE::MOVE:
+                entity->move(vector);
+                break;
+            case TYPE::ATTACK: {
+                int entityRange = entity->getFinalStats().stats[EntityStats::STAT::RNG];
+                int entityDamage = entity->getFinalStats().stats[EntityStats::STAT::DMG];
+                Vector apex = entity->getHitbox().getCenter();
+                Shape cone = Shape::cone(apex, Vector(vector.x - apex.x, vector.y - apex.y), entityRange * 2, ATTACK_HALF_ANGLE);
+                std::unique_ptr<Targeting> targeting(new ShapeTargeting(cone));
+                map.addActionToQueue(std::unique_ptr<Action>(new HitAction(static_cast<unsigned int>(entityDamage), &map, std::move(targeting), &PlayerTeam::PLAYER_TEAM)));
+                break;
+            }
+        }
+    }
+
+    ReplayRecorder::ReplayRecorder() {
+        tickCount = 0;
+        runLength = 0;
+        lastVector = Vector(0, 0);
+        recording = false;
+    }
+
+    void ReplayRecorder::begin(Map& map) {
+        MapSnapshot::save(map, initialSnapshot);
+        intentStream = BinaryWriter();
+        hashes.clear();
+        tickCount = 0;
+        runIntents.clear();
+        runLength = 0;
+        lastVector = Vector(0, 0);
+        recording = true;
+    }
+
+    void ReplayRecorder::flushRun() {
+        if (runLength == 0) {
+            return;
+        }
+        intentStream.writeVarint(runLength);
+        intentStream.writeVarint(runIntents.size());
+        for (const Intent& intent : runIntents) {
+            intentStream.write<uint8_t>(static_cast<uint8_t>(intent.type));
+            intentStream.writeVarint(intent.entityID);
+            intentStream.writeSignedVarint(intent.vector.x - lastVector.x);
+            intentStream.writeSignedVarint(intent.vector.y - lastVector.y);
+            lastVector = intent.vector;
+        }
+        runLength = 0;
+    }
+
+    void ReplayRecorder::recordTick(const std::vector<Intent>& intents, const Map& map) {
+        if (!recording) {
+            return;
+        }
+        if (runLength > 0 && intents != runIntents) {
+            flushRun();
+        }
+        if (runLength == 0) {
+            runIntents = intents;
+        }
+        runLength++;
+        tickCount++;
+        hashes.push_back(map.getStateHash());
+    }
+
+    bool ReplayRecorder::save(const std::string& path) {
+        flushRun();
+        BinaryWriter writer;
+        writer.write<uint32_t>(REPLAY_MAGIC);
+        writer.write<uint16_t>(REPLAY_VERSION);
+        writer.write<uint32_t>(tickCount);
+        writer.write<uint32_t>(initialSnapshot.size());
+        writer.writeBytes(initialSnapshot.data(), initialSnapshot.size());
+        writer.write<uint32_t>(intentStream.getSize());
+        writer.writeBytes(intentStream.getBuffer().data(), intentStream.getSize());
+        writer.writeBytes(hashes.data(), hashes.size() * sizeof(uint64_t));
+        writer.write<uint32_t>(crc32(writer.getBuffer().data(), writer.getSize()));
+        return writeFile(path, writer.getBuffer());
+    }
+
+    bool ReplayRecorder::isRecording() const {
+        return recording;
+    }
+
+    unsigned int ReplayRecorder::getTickCount() const {
+        return tickCount;
+    }
+
+    ReplayPlayer::ReplayPlayer() {
+        snapshot = NULL;
+        snapshotSize = 0;
+        intentStream = NULL;
+        intentStreamSize = 0;
+        hashes = NULL;
+        tickCount = 0;
+    }
+
+    bool ReplayPlayer::open(const std::string& path) {
+        if (!readFile(path, contents) || contents.size() < sizeof(uint32_t)) {
+            return false;
+        }
+        size_t bodySize = contents.size() - sizeof(uint32_t);
+        uint32_t checksum;
+        std::memcpy(&checksum, contents.data() + bodySize, sizeof(uint32_t));
+        if (crc32(contents.data(), bodySize) != checksum) {
+            return false;
+        }
+        BinaryReader reader(contents.data(), bodySize);
+        uint32_t magic;
+        uint16_t version;
+        if (!reader.read(magic) || !reader.read(version) || magic != REPLAY_MAGIC || version != REPLAY_VERSION) {
+            return false;
+        }
+        if (!reader.read(tickCount) || !reader.read(snapshotSize)) {
+            return false;
+        }
+        snapshot = reader.skip(snapshotSize);
+        if (!snapshot || !reader.read(intentStreamSize)) {
+            return false;
+        }
+        intentStream = reader.skip(intentStreamSize);
+        hashes = reader.skip(static_cast<size_t>(tickCount) * sizeof(uint64_t));
+        return intentStream && hashes && reader.getRemaining() == 0;
+    }
+
+    ReplayResult ReplayPlayer::play(Map& map) {
+        ReplayResult result;
+        result.loaded = false;
+        result.ticksPlayed = 0;
+        result.ticksRecorded = tickCount;
+        result.firstDivergentTick = -1;
+        result.milliseconds = 0;
+        if (!snapshot || !MapSnapshot::load(map, snapshot, snapshotSize)) {
+            return result;
+        }
+        result.loaded = true;
+
+        BinaryReader reader(intentStream, intentStreamSize);
+        std::vector<Intent> intents;
+        Vector lastVector(0, 0);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (result.ticksPlayed < tickCount && result.firstDivergentTick < 0) {
+            uint32_t runLength, intentCount;
+            if (!reader.readVarint(runLength) || !reader.readVarint(intentCount)) {
+                result.firstDivergentTick = result.ticksPlayed;
+                break;
+            }
+            intents.clear();
+            for (uint32_t i = 0; i < intentCount; i++) {
+                uint8_t type;
+                uint32_t entityID;
+                int32_t deltaX, deltaY;
+                if (!reader.read(type) || !reader.readVarint(entityID) || !reader.readSignedVarint(deltaX) || !reader.readSignedVarint(deltaY) || type > static_cast<uint8_t>(Intent::TYPE::ATTACK)) {
+                    result.firstDivergentTick = result.ticksPlayed;
+                    break;
+                }
+                lastVector = Vector(lastVector.x + deltaX, lastVector.y + deltaY);
+                intents.push_back(Intent(static_cast<Intent::TYPE>(type), entityID, lastVector));
+            }
+            for (uint32_t tick = 0; tick < runLength && result.ticksPlayed < tickCount && result.firstDivergentTick < 0; tick++) {
+                for (const Intent& intent : intents) {
+                    intent.apply(map);
+                }
+                map.tickAndApplyActions();
+                uint64_t expected;
+                std::memcpy(&expected, hashes + result.ticksPlayed * sizeof(uint64_t), sizeof(uint64_t));
+                if (map.getStateHash() != expected) {
+                    result.firstDivergentTick = result.ticksPlayed;
+                }
+                result.ticksPlayed++;
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        result.milliseconds = elapsed.count();
+        return result;
+    }
+
+    unsigned int ReplayPlayer::getTickCount() const {
+        return tickCount;
+    }
+
+}
@@ -0,0 +1,141 @@
+#include "residencyManager.hpp"
+
+namespace Rendering {
+
+    ResidencyManager::ResidencyManager() {
+        loader = NULL;
+        budget = 256 * 1024 * 1024;
+        prefetchMargin = 0.5f;
+        frame = 1;
+        residentBytes = 0;
+        evictions = 0;
+        missStalls = 0;
+    }
+
+    void ResidencyManager::setLoader(AssetLoader* loader_) {
+        loader = loader_;
+    }
+
+    void ResidencyManager::setBudget(size_t budget_) {
+        budget = budget_;
+    }
+
+    void ResidencyManager::setPrefetchMargin(float prefetchMargin_) {
+        prefetchMargin = prefetchMargin_;
+    }
+
+    void ResidencyManager::trackSet(unsigned int set, unsigned int handle) {
+        if (set >= setEntries.size()) {
+            setEntries.resize(set + 1, static_cast<unsigned int>(AssetRegistry::NONE));
+        }
+        Entry entry;
+        entry.handle = handle;
+        entry.references = 0;
+        entry.lastUsed = 0;
+        entry.lastMissed = 0;
+        entry.resident = false;
+        entry.evicted = false;
+        setEntries[set] = entries.size();
+        entries.push_back(entry);
+    }
+
+    void ResidencyManager::beginFrame(const sf::FloatRect& view_) {
+        view = view_;
+        prefetchArea = sf::FloatRect(view.left - view.width * prefetchMargin, view.top - view.height * prefetchMargin, view.width * (1 + 2 * prefetchMargin), view.height * (1 + 2 * prefetchMargin));
+        for (Entry& entry : entries) {
+            entry.references = 0;
+        }
+    }
+
+    void ResidencyManager::use(Entry& entry, const sf::FloatRect& bounds) {
+        entry.references++;
+        if (!bounds.intersects(prefetchArea)) {
+            return;
+        }
+        entry.lastUsed = frame;
+        if (!entry.evicted) {
+            return;
+        }
+        AssetLoader::STATE state = loader->getState(entry.handle);
+        if (state == AssetLoader::STATE::EVICTED) {
+            loader->reload(entry.handle);
+        }
+        if (state != AssetLoader::STATE::READY && entry.lastMissed != frame && bounds.intersects(view)) {
+            entry.lastMissed = frame;
+            missStalls++;
+        }
+    }
+
+    void ResidencyManager::useSet(unsigned int set, const sf::FloatRect& bounds) {
+        if (set < setEntries.size() && setEntries[set] != AssetRegistry::NONE) {
+            use(entries[setEntries[set]], bounds);
+        }
+    }
+
+    bool ResidencyManager::isColder(const Entry& first, const Entry& second) {
+        return first.lastUsed < second.lastUsed;
+    }
+
+    void ResidencyManager::evictColdEntries() {
+        while (residentBytes > budget) {
+            Entry* coldest = NULL;
+            for (Entry& entry : entries) {
+                if (!entry.resident || entry.references > 0 || entry.lastUsed == frame) {
+                    continue;
+                }
+                if (!coldest || isColder(entry, *coldest)) {
+                    coldest = &entry;
+                }
+            }
+            if (!coldest) {
+                return;
+            }
+            size_t bytes = loader->getBytes(coldest->handle);
+            if (!loader->evict(coldest->handle)) {
+                coldest->resident = false;
+                continue;
+            }
+            coldest->resident = false;
+            coldest->evicted = true;
+            residentBytes -= bytes;
+            evictions++;
+        }
+    }
+
+    void ResidencyManager::endFrame() {
+        if (!loader) {
+            return;
+        }
+        residentBytes = 0;
+        for (Entry& entry : entries) {
+            entry.resident = loader->getState(entry.handle) == AssetLoader::STATE::READY;
+            if (entry.resident) {
+                entry.evicted = false;
+                residentBytes += loader->getBytes(entry.handle);
+            }
+        }
+        evictColdEntries();
+        frame++;
+    }
+
+    size_t ResidencyManager::getBudget() const {
+        return budget;
+    }
+
+    size_t ResidencyManager::getResidentBytes() const {
+        return residentBytes;
+    }
+
+    unsigned int ResidencyManager::getTrackedCount() const {
+        return entries.size();
+    }
+
+    unsigned int ResidencyManager::getEvictionCount() const {
+        return evictions;
+    }
+
+    unsigned int ResidencyManager::getMissStallCount() const {
+        return missStalls;
+    }
+
+}
@@ -0,0 +1,266 @@
+#include "rollback.hpp"
+#include "serialization.hpp"
+#include <algorithm>
+
+namespace Game {
+
+    RollbackRing::RollbackRing() {
+        frames.resize(CAPACITY);
+        newest = 0;
+        frameCount = 0;
+        copiedPages = 0;
+        restoredPages = 0;
+    }
+
+    std::shared_ptr<const RollbackRing::Page> RollbackRing::copyPage(Map& map, unsigned int pageIndex) {
+        std::shared_ptr<Page> page = std::make_shared<Page>();
+        unsigned int begin = pageIndex * Map::ENTITY_PAGE_SIZE;
+        unsigned int end = std::min<unsigned int>(begin + Map::ENTITY_PAGE_SIZE, map.entities.size());
+        page->entities.assign(map.entities.begin() + begin, map.entities.begin() + end);
+        page->motions.reserve(end - begin);
+        for (unsigned int i = begin; i < end; i++) {
+            page->motions.push_back(map.kinematics.getMotion(map.entities[i].id));
+        }
+        BinaryWriter behaviours;
+        page->behaviourCount = 0;
+        for (unsigned int i = begin; i < end; i++) {
+            std::unordered_map<unsigned int, std::unique_ptr<BehaviourProfile>>::const_iterator profile = map.behaviourProfiles.find(map.entities[i].id);
+            if (profile != map.behaviourProfiles.end()) {
+                behaviours.write<uint32_t>(profile->first);
+                behaviours.write<uint8_t>(static_cast<uint8_t>(profile->second->getProfileType()));
+                profile->second->save(behaviours);
+                page->behaviourCount++;
+            }
+        }
+        page->behaviours.swap(behaviours.getBuffer());
+        return page;
+    }
+
+    bool RollbackRing::restoreBehaviours(Map& map, const Page& page) {
+        BinaryReader behaviours(page.behaviours.data(), page.behaviours.size());
+        unsigned int remaining = page.behaviourCount;
+        uint32_t nextID = 0;
+        if (remaining > 0 && !behaviours.read(nextID)) {
+            return false;
+        }
+        for (const Entity& entity : page.entities) {
+            if (remaining == 0 || nextID != entity.id) {
+                map.behaviourProfiles.erase(entity.id);
+                continue;
+            }
+            uint8_t profileType;
+            if (!behaviours.read(profileType) || profileType > static_cast<uint8_t>(BehaviourProfile::PROFILE::GRUNT)) {
+                return false;
+            }
+            std::unique_ptr<BehaviourProfile>& profile = map.behaviourProfiles[entity.id];
+            if (!profile || profile->getProfileType() != static_cast<BehaviourProfile::PROFILE>(profileType)) {
+                profile.reset(BehaviourProfile::create(static_cast<BehaviourProfile::PROFILE>(profileType), entity.id, &map));
+            }
+            if (!profile || !profile->load(behaviours)) {
+                return false;
+            }
+            remaining--;
+            if (remaining > 0 && !behaviours.read(nextID)) {
+                return false;
+            }
+        }
+        return remaining == 0;
+    }
+
+    bool RollbackRing::pageDirty(const Map& map, unsigned int pageIndex) {
+        return map.allEntitiesDirty || (pageIndex < map.dirtyPages.size() && map.dirtyPages[pageIndex]);
+    }
+
+    int RollbackRing::findFrame(unsigned int tick) const {
+        for (unsigned int i = 0; i < frameCount; i++) {
+            unsigned int index = (newest + CAPACITY - i) % CAPACITY;
+            if (frames[index].tick == tick) {
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    void RollbackRing::capture(Map& map, unsigned int tick) {
+        map.drainPendingActions();
+        const Frame* base = frameCount > 0 ? &frames[newest] : NULL;
+        unsigned int slot = frameCount > 0 ? (newest + 1) % CAPACITY : 0;
+        Frame& frame = frames[slot];
+        unsigned int pageCount = (map.entities.size() + Map::ENTITY_PAGE_SIZE - 1) / Map::ENTITY_PAGE_SIZE;
+        std::vector<std::shared_ptr<const Page>> pages(pageCount);
+        copiedPages = 0;
+        for (unsigned int i = 0; i < pageCount; i++) {
+            if (base && i < base->pages.size() && !pageDirty(map, i)) {
+                pages[i] = base->pages[i];
+            }
+            else {
+                pages[i] = copyPage(map, i);
+                copiedPages++;
+            }
+        }
+        frame.pages.swap(pages);
+        frame.tick = tick;
+        frame.entityCount = map.entities.size();
+        frame.currentMaxID = map.currentMaxID;
+        frame.awakeEntities = map.awakeEntities;
+        frame.entityShapes = map.entityShapes;
+
+        BinaryWriter actions;
+        for (const std::unique_ptr<Action>& action : map.actions) {
+            action->save(actions);
+        }
+        frame.actions.swap(actions.getBuffer());
+        frame.actionCount = map.actions.size();
+
+        frame.reorderPhase = static_cast<uint8_t>(map.reorderPhase);
+        frame.ticksSinceReorder = map.ticksSinceReorder;
+        frame.reorderWriteIndex = map.reorderWriteIndex;
+        frame.reorderReadIndex = map.reorderReadIndex;
+        if (map.reorderPhase != Map::REORDER_PHASE::IDLE) {
+            frame.mortonSorter = map.mortonSorter;
+        }
+
+        std::fill(map.dirtyPages.begin(), map.dirtyPages.end(), 0);
+        map.allEntitiesDirty = false;
+        newest = slot;
+        if (frameCount < CAPACITY) {
+            frameCount++;
+        }
+    }
+
+    bool RollbackRing::restorePages(Map& map, const Frame& target) {
+        const Frame& head = frames[newest];
+        unsigned int livePages = (map.entities.size() + Map::ENTITY_PAGE_SIZE - 1) / Map::ENTITY_PAGE_SIZE;
+        unsigned int targetPages = target.pages.size();
+        std::vector<unsigned int> changed;
+        for (unsigned int i = 0; i < std::max(livePages, targetPages); i++) {
+            bool unchanged = i < livePages && i < targetPages && i < head.pages.size() && !pageDirty(map, i) && head.pages[i] == target.pages[i];
+            if (!unchanged) {
+                changed.push_back(i);
+            }
+        }
+
+        std::vector<unsigned int> outgoing;
+        for (unsigned int page : changed) {
+            unsigned int begin = page * Map::ENTITY_PAGE_SIZE;
+            unsigned int end = std::min<unsigned int>(begin + Map::ENTITY_PAGE_SIZE, map.entities.size());
+            for (unsigned int i = begin; i < end; i++) {
+                outgoing.push_back(map.entities[i].id);
+            }
+        }
+        if (map.entities.size() > target.entityCount) {
+            map.entities.erase(map.entities.begin() + target.entityCount, map.entities.end());
+        }
+
+        restoredPages = 0;
+        bool behavioursRestored = true;
+        for (unsigned int page : changed) {
+            if (page >= targetPages) {
+                continue;
+            }
+            const Page& source = *target.pages[page];
+            for (unsigned int i = 0; i < source.entities.size(); i++) {
+                unsigned int index = page * Map::ENTITY_PAGE_SIZE + i;
+                const Entity& entity = source.entities[i];
+                if (index < map.entities.size()) {
+                    map.entities[index] = entity;
+                }
+                else {
+                    map.entities.push_back(entity);
+                }
+                map.entityIndices[entity.id] = index;
+                map.grid.insert(entity.id, entity.hitbox);
+                map.kinematics.add(entity.id);
+                map.kinematics.setMotion(entity.id, source.motions[i]);
+                map.overlaps.markMoved(entity.id);
+            }
+            if (!restoreBehaviours(map, source)) {
+                behavioursRestored = false;
+            }
+            restoredPages++;
+        }
+
+        for (unsigned int entityID : outgoing) {
+            std::unordered_map<unsigned int, unsigned int>::iterator found = map.entityIndices.find(entityID);
+            if (found != map.entityIndices.end() && found->second < map.entities.size() && map.entities[found->second].id == entityID) {
+                continue;
+            }
+            if (found != map.entityIndices.end()) {
+                map.entityIndices.erase(found);
+            }
+            map.grid.remove(entityID);
+            map.kinematics.remove(entityID);
+            map.overlaps.remove(entityID);
+            map.behaviourProfiles.erase(entityID);
+        }
+        return behavioursRestored;
+    }
+
+    bool RollbackRing::restoreQueues(Map& map, const Frame& target) {
+        map.actions.clear();
+        BinaryReader actions(target.actions.data(), target.actions.size());
+        for (unsigned int i = 0; i < target.actionCount; i++) {
+            std::unique_ptr<Action> action = Action::load(actions, &map);
+            if (!action) {
+                return false;
+            }
+            map.actions.push_back(std::move(action));
+        }
+        return true;
+    }
+
+    bool RollbackRing::restore(Map& map, unsigned int tick) {
+        int index = findFrame(tick);
+        if (index < 0) {
+            return false;
+        }
+        const Frame& target = frames[index];
+        map.stateGeneration++;
+        map.drainPendingActions();
+        bool pagesRestored = restorePages(map, target);
+        map.currentMaxID = target.currentMaxID;
+        map.awakeEntities = target.awakeEntities;
+        map.entityShapes = target.entityShapes;
+        map.movedEntities.clear();
+        map.reorderPhase = static_cast<Map::REORDER_PHASE>(target.reorderPhase);
+        map.ticksSinceReorder = target.ticksSinceReorder;
+        map.reorderWriteIndex = target.reorderWriteIndex;
+        map.reorderReadIndex = target.reorderReadIndex;
+        if (map.reorderPhase != Map::REORDER_PHASE::IDLE) {
+            map.mortonSorter = target.mortonSorter;
+        }
+        bool queuesRestored = restoreQueues(map, target);
+        map.updateOverlaps();
+
+        std::fill(map.dirtyPages.begin(), map.dirtyPages.end(), 0);
+        map.allEntitiesDirty = false;
+        frameCount -= (newest + CAPACITY - index) % CAPACITY;
+        newest = index;
+        return pagesRestored && queuesRestored;
+    }
+
+    bool RollbackRing::hasTick(unsigned int tick) const {
+        return findFrame(tick) >= 0;
+    }
+
+    void RollbackRing::clear() {
+        for (Frame& frame : frames) {
+            frame.pages.clear();
+        }
+        newest = 0;
+        frameCount = 0;
+    }
+
+    unsigned int RollbackRing::getFrameCount() const {
+        return frameCount;
+    }
+
+    unsigned int RollbackRing::getLastCopiedPages() const {
+        return copiedPages;
+    }
+
+    unsigned int RollbackRing::getLastRestoredPages() const {
+        return restoredPages;
+    }
+
+}
@@ -0,0 +1,310 @@
+#include "roomHost.hpp"
+#include <algorithm>
+
+namespace Game {
+
+    namespace {
+
+        const double COST_SMOOTHING = 0.1;
+        const double MIGRATION_LOAD = 0.75;
+
+        double getElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    }
+
+    Room::Room(unsigned int id_) {
+        id = id_;
+        worker = 0;
+        ticks = 0;
+        skippedTicks = 0;
+        overruns = 0;
+        consecutiveOverruns = 0;
+        averageMilliseconds = 0;
+        maxMilliseconds = 0;
+        throttled = false;
+    }
+
+    unsigned int Room::getID() const {
+        return id;
+    }
+
+    Map& Room::getMap() {
+        return map;
+    }
+
+    void Room::queueIntent(const Intent& intent) {
+        intents.push(intent);
+    }
+
+    void Room::step(double budgetMilliseconds) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        intents.drain([this](Intent intent) {
+            intent.apply(map);
+        });
+        map.tickAndApplyActions();
+        double elapsed = getElapsedMilliseconds(start);
+
+        averageMilliseconds = ticks == 0 ? elapsed : averageMilliseconds + (elapsed - averageMilliseconds) * COST_SMOOTHING;
+        maxMilliseconds = std::max(maxMilliseconds, elapsed);
+        ticks++;
+        if (elapsed > budgetMilliseconds) {
+            overruns++;
+            consecutiveOverruns++;
+        }
+        else {
+            consecutiveOverruns = 0;
+        }
+    }
+
+    RoomStats Room::getStats() const {
+        RoomStats stats;
+        stats.roomID = id;
+        stats.worker = worker;
+        stats.ticks = ticks;
+        stats.skippedTicks = skippedTicks;
+        stats.overruns = overruns;
+        stats.averageMilliseconds = averageMilliseconds;
+        stats.maxMilliseconds = maxMilliseconds;
+        stats.throttled = throttled;
+        return stats;
+    }
+
+    RoomHost::RoomHost(unsigned int workerCount, unsigned int tickRate_) {
+        frame = 0;
+        busyWorkers = 0;
+        stopping = false;
+        tickRate = tickRate_;
+        nextRoomID = 0;
+        migrations = 0;
+        roomBudgetMilliseconds = 1000.0 / tickRate / 4;
+        workerCount = std::max(workerCount, 1u);
+        for (unsigned int i = 0; i < workerCount; i++) {
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+            workers.back()->frameMilliseconds = 0;
+            workers.back()->overruns = 0;
+        }
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->thread = std::thread(&RoomHost::runWorker, this, worker.get());
+        }
+    }
+
+    RoomHost::~RoomHost() {
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            stopping = true;
+        }
+        frameStarted.notify_all();
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    void RoomHost::tickWorker(Worker* worker, unsigned int currentFrame) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (Room* room : worker->rooms) {
+            if (room->throttled && (currentFrame + room->id) % THROTTLE_DIVISOR != 0) {
+                room->skippedTicks++;
+                continue;
+            }
+            room->step(roomBudgetMilliseconds);
+        }
+        worker->frameMilliseconds = getElapsedMilliseconds(start);
+        if (worker->frameMilliseconds > 1000.0 / tickRate) {
+            worker->overruns++;
+        }
+    }
+
+    void RoomHost::runWorker(Worker* worker) {
+        unsigned int lastFrame = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(frameMutex);
+                frameStarted.wait(lock, [this, lastFrame]() {
+                    return stopping || frame != lastFrame;
+                });
+                if (stopping) {
+                    return;
+                }
+                lastFrame = frame;
+            }
+            tickWorker(worker, lastFrame);
+            {
+                std::lock_guard<std::mutex> lock(frameMutex);
+                busyWorkers--;
+            }
+            frameFinished.notify_one();
+        }
+    }
+
+    double RoomHost::getWorkerLoad(const Worker* worker) const {
+        double load = 0;
+        for (const Room* room : worker->rooms) {
+            load += room->throttled ? room->averageMilliseconds / THROTTLE_DIVISOR : room->averageMilliseconds;
+        }
+        return load;
+    }
+
+    void RoomHost::rebalance() {
+        if (workers.size() < 2) {
+            return;
+        }
+        unsigned int busiest = 0;
+        unsigned int idlest = 0;
+        std::vector<double> loads;
+        for (unsigned int i = 0; i < workers.size(); i++) {
+            loads.push_back(getWorkerLoad(workers[i].get()));
+            if (loads[i] > loads[busiest]) {
+                busiest = i;
+            }
+            if (loads[i] < loads[idlest]) {
+                idlest = i;
+            }
+        }
+        std::vector<Room*>& busiestRooms = workers[busiest]->rooms;
+        if (loads[busiest] < 1000.0 / tickRate * MIGRATION_LOAD || busiestRooms.size() < 2) {
+            return;
+        }
+        double gap = loads[busiest] - loads[idlest];
+        std::vector<Room*>::iterator moving = busiestRooms.end();
+        for (std::vector<Room*>::iterator it = busiestRooms.begin(); it != busiestRooms.end(); it++) {
+            double cost = (*it)->averageMilliseconds;
+            if (cost < gap && (moving == busiestRooms.end() || cost > (*moving)->averageMilliseconds)) {
+                moving = it;
+            }
+        }
+        if (moving == busiestRooms.end()) {
+            return;
+        }
+        Room* room = *moving;
+        busiestRooms.erase(moving);
+        workers[idlest]->rooms.push_back(room);
+        room->worker = idlest;
+        migrations++;
+    }
+
+    void RoomHost::updateThrottling() {
+        for (std::unique_ptr<Room>& room : rooms) {
+            if (!room->throttled && room->consecutiveOverruns >= OVERRUNS_TO_THROTTLE) {
+                room->throttled = true;
+            }
+            else if (room->throttled && room->averageMilliseconds < roomBudgetMilliseconds / 2) {
+                room->throttled = false;
+                room->consecutiveOverruns = 0;
+            }
+        }
+    }
+
+    Room& RoomHost::createRoom() {
+        rooms.push_back(std::unique_ptr<Room>(new Room(nextRoomID++)));
+        Room* room = rooms.back().get();
+        unsigned int target = 0;
+        for (unsigned int i = 1; i < workers.size(); i++) {
+            if (workers[i]->rooms.size() < workers[target]->rooms.size()) {
+                target = i;
+            }
+        }
+        room->worker = target;
+        workers[target]->rooms.push_back(room);
+        return *room;
+    }
+
+    bool RoomHost::removeRoom(unsigned int roomID) {
+        for (std::vector<std::unique_ptr<Room>>::iterator it = rooms.begin(); it != rooms.end(); it++) {
+            if ((*it)->id == roomID) {
+                std::vector<Room*>& workerRooms = workers[(*it)->worker]->rooms;
+                workerRooms.erase(std::find(workerRooms.begin(), workerRooms.end(), it->get()));
+                rooms.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Room* RoomHost::getRoom(unsigned int roomID) {
+        for (std::unique_ptr<Room>& room : rooms) {
+            if (room->id == roomID) {
+                return room.get();
+            }
+        }
+        return NULL;
+    }
+
+    void RoomHost::setRoomBudget(double milliseconds) {
+        roomBudgetMilliseconds = milliseconds;
+    }
+
+    double RoomHost::runFrame() {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+            frame++;
+            busyWorkers = workers.size();
+        }
+        frameStarted.notify_all();
+        {
+            std::unique_lock<std::mutex> lock(frameMutex);
+            frameFinished.wait(lock, [this]() {
+                return busyWorkers == 0;
+            });
+        }
+        updateThrottling();
+        rebalance();
+        return getElapsedMilliseconds(start);
+    }
+
+    void RoomHost::run(double seconds) {
+        std::chrono::steady_clock::duration tickTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point nextFrame = start;
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+            runFrame();
+            nextFrame += tickTime;
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (nextFrame > now) {
+                std::this_thread::sleep_until(nextFrame);
+            }
+            else {
+                nextFrame = now;
+            }
+        }
+    }
+
+    std::vector<RoomStats> RoomHost::getRoomStats() const {
+        std::vector<RoomStats> stats;
+        for (const std::unique_ptr<Room>& room : rooms) {
+            stats.push_back(room->getStats());
+        }
+        return stats;
+    }
+
+    unsigned int RoomHost::getRoomCount() const {
+        return rooms.size();
+    }
+
+    unsigned int RoomHost::getWorkerCount() const {
+        return workers.size();
+    }
+
+    unsigned int RoomHost::getMigrationCount() const {
+        return migrations;
+    }
+
+    unsigned int RoomHost::getWorkerOverrunCount() const {
+        unsigned int overruns = 0;
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            overruns += worker->overruns;
+        }
+        return overruns;
+    }
+
+    double RoomHost::getFrameMilliseconds() const {
+        double slowest = 0;
+        for (const std::unique_ptr<Worker>& worker : workers) {
+            slowest = std::max(slowest, worker->frameMilliseconds);
+        }
+        return slowest;
+    }
+
+}
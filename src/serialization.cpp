@@ -0,0 +1,347 @@
+#include "serialization.hpp"
+#include <fstream>
+
+namespace Game {
+
+    namespace {
+
+        const uint32_t CRC_POLYNOMIAL = 0xedb88320;
+        const unsigned int CRC_SLICES = 8;
+
+        struct CrcTables {
+            uint32_t values[CRC_SLICES][256];
+            CrcTables() {
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t crc = i;
+                    for (int bit = 0; bit < 8; bit++) {
+                        crc = (crc >> 1) ^ (CRC_POLYNOMIAL & (0 - (crc & 1)));
+                    }
+                    values[0][i] = crc;
+                }
+                for (uint32_t i = 0; i < 256; i++) {
+                    for (unsigned int slice = 1; slice < CRC_SLICES; slice++) {
+                        values[slice][i] = (values[slice - 1][i] >> 8) ^ values[0][values[slice - 1][i] & 0xff];
+                    }
+                }
+            }
+        };
+
+        const CrcTables& getCrcTables() {
+            static const CrcTables tables;
+            return tables;
+        }
+
+    }
+
+    void BinaryWriter::writeBytes(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    void BinaryWriter::writeVarint(uint32_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    void BinaryWriter::writeSignedVarint(int32_t value) {
+        writeVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    void BinaryWriter::writeRect(const Rect& rect) {
+        write<int32_t>(rect.topLeft.x);
+        write<int32_t>(rect.topLeft.y);
+        write<int32_t>(rect.width);
+        write<int32_t>(rect.height);
+    }
+
+    void BinaryWriter::writeStats(const EntityStats& stats) {
+        write<uint8_t>(stats.stats.size());
+        for (std::pair<EntityStats::STAT, int> stat : stats.stats) {
+            write<uint8_t>(static_cast<uint8_t>(stat.first));
+            write<int32_t>(stat.second);
+        }
+        write<uint8_t>(stats.statModifiers.size());
+        for (std::pair<EntityStats::STAT_MOD, Fixed> modifier : stats.statModifiers) {
+            write<uint8_t>(static_cast<uint8_t>(modifier.first));
+            write<int32_t>(modifier.second.getRaw());
+        }
+    }
+
+    void BinaryWriter::writeShape(const Shape& shape) {
+        write<uint8_t>(static_cast<uint8_t>(shape.getType()));
+        write<int32_t>(shape.getRadius());
+        write<uint8_t>(shape.getVertexCount());
+        for (unsigned int i = 0; i < shape.getVertexCount(); i++) {
+            write<int32_t>(shape.getVertex(i).x);
+            write<int32_t>(shape.getVertex(i).y);
+        }
+    }
+
+    std::vector<char>& BinaryWriter::getBuffer() {
+        return buffer;
+    }
+
+    size_t BinaryWriter::getSize() const {
+        return buffer.size();
+    }
+
+    BinaryReader::BinaryReader(const char* data_, size_t size_) {
+        data = data_;
+        size = size_;
+        position = 0;
+        failed = false;
+    }
+
+    bool BinaryReader::readBytes(void* out, size_t count) {
+        const char* source = skip(count);
+        if (!source) {
+            return false;
+        }
+        std::memcpy(out, source, count);
+        return true;
+    }
+
+    bool BinaryReader::readVarint(uint32_t& value) {
+        value = 0;
+        for (unsigned int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte;
+            if (!read(byte)) {
+                return false;
+            }
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        failed = true;
+        return false;
+    }
+
+    bool BinaryReader::readSignedVarint(int32_t& value) {
+        uint32_t encoded;
+        if (!readVarint(encoded)) {
+            return false;
+        }
+        value = static_cast<int32_t>((encoded >> 1) ^ (0 - (encoded & 1)));
+        return true;
+    }
+
+    bool BinaryReader::readRect(Rect& rect) {
+        int32_t x, y, width, height;
+        if (!read(x) || !read(y) || !read(width) || !read(height)) {
+            return false;
+        }
+        rect = Rect(Vector(x, y), width, height);
+        return true;
+    }
+
+    bool BinaryReader::readStats(EntityStats& stats) {
+        uint8_t statCount;
+        if (!read(statCount)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < statCount; i++) {
+            uint8_t key;
+            int32_t value;
+            if (!read(key) || !read(value) || key >= EntityStats::STAT_COUNT) {
+                return false;
+            }
+            stats.stats[static_cast<EntityStats::STAT>(key)] = value;
+        }
+        uint8_t modifierCount;
+        if (!read(modifierCount)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < modifierCount; i++) {
+            uint8_t key;
+            int32_t raw;
+            if (!read(key) || !read(raw) || key >= EntityStats::STAT_MOD_COUNT) {
+                return false;
+            }
+            stats.statModifiers[static_cast<EntityStats::STAT_MOD>(key)] = Fixed::fromRaw(raw);
+        }
+        return true;
+    }
+
+    bool BinaryReader::readShape(Shape& shape) {
+        uint8_t type, vertexCount;
+        int32_t radius;
+        if (!read(type) || !read(radius) || !read(vertexCount) || vertexCount > Shape::MAX_VERTICES) {
+            return false;
+        }
+        std::vector<Vector> vertices;
+        for (uint8_t i = 0; i < vertexCount; i++) {
+            int32_t x, y;
+            if (!read(x) || !read(y)) {
+                return false;
+            }
+            vertices.push_back(Vector(x, y));
+        }
+        switch (static_cast<Shape::TYPE>(type)) {
+            case Shape::TYPE::AABB:
+                if (vertexCount != 4) {
+                    return false;
+                }
+                shape = Shape::aabb(Rect(vertices[0], vertices[2].x - vertices[0].x, vertices[2].y - vertices[0].y));
+                return true;
+            case Shape::TYPE::CIRCLE:
+                if (vertexCount != 1) {
+                    return false;
+                }
+                shape = Shape::circle(Circle(vertices[0], radius));
+                return true;
+            case Shape::TYPE::CAPSULE:
+                if (vertexCount != 2) {
+                    return false;
+                }
+                shape = Shape::capsule(vertices[0], vertices[1], radius);
+                return true;
+            case Shape::TYPE::POLYGON:
+                shape = Shape::polygon(vertices);
+                return true;
+        }
+        return false;
+    }
+
+    const char* BinaryReader::skip(size_t count) {
+        if (failed || count > size - position) {
+            failed = true;
+            return NULL;
+        }
+        const char* start = data + position;
+        position += count;
+        return start;
+    }
+
+    bool BinaryReader::hasFailed() const {
+        return failed;
+    }
+
+    size_t BinaryReader::getPosition() const {
+        return position;
+    }
+
+    size_t BinaryReader::getRemaining() const {
+        return size - position;
+    }
+
+    void writeEntityRecord(BinaryWriter& writer, const Map& map, const Entity& entity) {
+        writer.write<uint32_t>(entity.getID());
+        writer.writeRect(entity.getHitbox());
+        writer.write<uint8_t>(static_cast<uint8_t>(entity.getTeam()));
+        writer.write<uint8_t>(entity.getPrefab());
+        writer.writeStats(entity.getBaseStats());
+        writer.write<uint16_t>(entity.getBuffs().size());
+        for (const Buff& buff : entity.getBuffs()) {
+            writer.writeStats(buff.getChanges());
+            writer.write<uint32_t>(buff.getFramesLeft());
+            writer.write<uint32_t>(buff.getMaxFrames());
+            writer.write<uint32_t>(buff.getFrameInterval());
+        }
+        Shape shape;
+        bool hasShape = map.getLocalShape(entity.getID(), shape);
+        writer.write<uint8_t>(hasShape ? 1 : 0);
+        if (hasShape) {
+            writer.writeShape(shape);
+        }
+        const BehaviourProfile* profile = entity.getBehaviourProfile();
+        writer.write<uint8_t>(profile ? 1 : 0);
+        if (profile) {
+            BinaryWriter state;
+            profile->save(state);
+            writer.write<uint8_t>(static_cast<uint8_t>(profile->getProfileType()));
+            writer.write<uint32_t>(state.getSize());
+            writer.writeBytes(state.getBuffer().data(), state.getSize());
+        }
+    }
+
+    bool readEntityRecord(BinaryReader& reader, EntityRecord& record) {
+        uint8_t team, prefab;
+        uint16_t buffCount;
+        if (!reader.read(record.entityID) || !reader.readRect(record.entityTemplate.hitbox) || !reader.read(team) || !reader.read(prefab) || !reader.readStats(record.entityTemplate.stats) || !reader.read(buffCount)) {
+            return false;
+        }
+        if (team > static_cast<uint8_t>(Team::TEAM::TERRAIN)) {
+            return false;
+        }
+        record.entityTemplate.team = static_cast<Team::TEAM>(team);
+        record.entityTemplate.prefab = prefab;
+        record.entityTemplate.behaviourProfile = NULL;
+        record.buffs.clear();
+        for (uint16_t i = 0; i < buffCount; i++) {
+            EntityStats changes;
+            uint32_t framesLeft, framesMax, frameInterval;
+            if (!reader.readStats(changes) || !reader.read(framesLeft) || !reader.read(framesMax) || !reader.read(frameInterval)) {
+                return false;
+            }
+            Buff buff(changes, framesMax, frameInterval);
+            buff.setFramesLeft(framesLeft);
+            record.buffs.push_back(buff);
+        }
+        uint8_t hasShape, hasBehaviour;
+        if (!reader.read(hasShape) || (hasShape && !reader.readShape(record.shape)) || !reader.read(hasBehaviour)) {
+            return false;
+        }
+        record.hasShape = hasShape != 0;
+        record.hasBehaviour = hasBehaviour != 0;
+        record.behaviourState.clear();
+        if (record.hasBehaviour) {
+            uint8_t profile;
+            uint32_t stateSize;
+            if (!reader.read(profile) || profile > static_cast<uint8_t>(BehaviourProfile::PROFILE::GRUNT) || !reader.read(stateSize)) {
+                return false;
+            }
+            const char* state = reader.skip(stateSize);
+            if (!state) {
+                return false;
+            }
+            record.behaviour = static_cast<BehaviourProfile::PROFILE>(profile);
+            record.behaviourState.assign(state, state + stateSize);
+        }
+        return true;
+    }
+
+    uint32_t crc32(const char* data, size_t size, uint32_t crc) {
+        const CrcTables& tables = getCrcTables();
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        crc = ~crc;
+        while (size >= CRC_SLICES) {
+            uint32_t low = (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24)) ^ crc;
+            uint32_t high = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | (static_cast<uint32_t>(bytes[7]) << 24);
+            crc = tables.values[7][low & 0xff] ^ tables.values[6][(low >> 8) & 0xff] ^ tables.values[5][(low >> 16) & 0xff] ^ tables.values[4][low >> 24] ^
+                tables.values[3][high & 0xff] ^ tables.values[2][(high >> 8) & 0xff] ^ tables.values[1][(high >> 16) & 0xff] ^ tables.values[0][high >> 24];
+            bytes += CRC_SLICES;
+            size -= CRC_SLICES;
+        }
+        while (size > 0) {
+            crc = (crc >> 8) ^ tables.values[0][(crc ^ *bytes) & 0xff];
+            bytes++;
+            size--;
+        }
+        return ~crc;
+    }
+
+    bool readFile(const std::string& path, std::vector<char>& contents) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        std::streamsize fileSize = file.tellg();
+        file.seekg(0, std::ios::beg);
+        contents.resize(static_cast<size_t>(fileSize));
+        return fileSize == 0 || static_cast<bool>(file.read(contents.data(), fileSize));
+    }
+
+    bool writeFile(const std::string& path, const std::vector<char>& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(contents.data(), contents.size());
+        return static_cast<bool>(file);
+    }
+
+}
@@ -0,0 +1,397 @@
+#include "shapes.hpp"
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Game {
+
+    namespace {
+
+        int64_t cross(const Vector& origin, const Vector& first, const Vector& second) {
+            return static_cast<int64_t>(first.x - origin.x) * (second.y - origin.y) - static_cast<int64_t>(first.y - origin.y) * (second.x - origin.x);
+        }
+
+        std::vector<Vector> convexHull(std::vector<Vector> points) {
+            std::sort(points.begin(), points.end(), [](const Vector& first, const Vector& second) {
+                return first.x < second.x || (first.x == second.x && first.y < second.y);
+            });
+            points.erase(std::unique(points.begin(), points.end(), [](const Vector& first, const Vector& second) {
+                return first.x == second.x && first.y == second.y;
+            }), points.end());
+            if (points.size() < 3) {
+                return points;
+            }
+            std::vector<Vector> hull(points.size() * 2);
+            unsigned int size = 0;
+            for (unsigned int i = 0; i < points.size(); i++) {
+                while (size >= 2 && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+                    size--;
+                }
+                hull[size++] = points[i];
+            }
+            unsigned int lowerSize = size + 1;
+            for (int i = static_cast<int>(points.size()) - 2; i >= 0; i--) {
+                while (size >= lowerSize && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+                    size--;
+                }
+                hull[size++] = points[i];
+            }
+            hull.resize(size - 1);
+            return hull;
+        }
+
+    }
+
+    Shape::Shape() {
+        type = TYPE::POLYGON;
+        radius = 0;
+        setVertices(std::vector<Vector>());
+    }
+
+    Shape Shape::aabb(const Rect& rect) {
+        Shape shape;
+        shape.type = TYPE::AABB;
+        shape.setVertices({rect.topLeft, Vector(rect.topLeft.x + rect.width, rect.topLeft.y), Vector(rect.topLeft.x + rect.width, rect.topLeft.y + rect.height), Vector(rect.topLeft.x, rect.topLeft.y + rect.height)});
+        return shape;
+    }
+
+    Shape Shape::circle(const Circle& circle) {
+        Shape shape;
+        shape.type = TYPE::CIRCLE;
+        shape.radius = circle.radius;
+        shape.setVertices({circle.center});
+        return shape;
+    }
+
+    Shape Shape::capsule(const Vector& start, const Vector& end, int radius) {
+        Shape shape;
+        shape.type = TYPE::CAPSULE;
+        shape.radius = radius;
+        shape.setVertices({start, end});
+        return shape;
+    }
+
+    Shape Shape::polygon(const std::vector<Vector>& vertices) {
+        Shape shape;
+        shape.type = TYPE::POLYGON;
+        std::vector<Vector> hull = convexHull(vertices);
+        if (hull.size() > MAX_VERTICES) {
+            std::vector<Vector> reduced;
+            for (unsigned int i = 0; i < MAX_VERTICES; i++) {
+                reduced.push_back(hull[i * hull.size() / MAX_VERTICES]);
+            }
+            hull.swap(reduced);
+        }
+        shape.setVertices(hull);
+        return shape;
+    }
+
+    Shape Shape::cone(const Vector& apex, const Vector& direction, int range, int halfAngleDegrees) {
+        Fixed length = fixedSqrt(static_cast<int64_t>(direction.x) * direction.x + static_cast<int64_t>(direction.y) * direction.y);
+        Fixed unitX = Fixed(0);
+        Fixed unitY = Fixed(-1);
+        if (length > Fixed()) {
+            unitX = Fixed(direction.x) / length;
+            unitY = Fixed(direction.y) / length;
+        }
+        int halfAngle = degreesToAngle(halfAngleDegrees);
+        unsigned int arcPoints = MAX_VERTICES - 1;
+        std::vector<Vector> vertices;
+        vertices.push_back(apex);
+        for (unsigned int i = 0; i < arcPoints; i++) {
+            int angle = -halfAngle + static_cast<int>(2 * halfAngle * static_cast<int>(i) / static_cast<int>(arcPoints - 1));
+            Fixed cosine = fixedCos(angle);
+            Fixed sine = fixedSin(angle);
+            Fixed rotatedX = unitX * cosine - unitY * sine;
+            Fixed rotatedY = unitX * sine + unitY * cosine;
+            vertices.push_back(Vector(apex.x + (rotatedX * Fixed(range)).toInt(), apex.y + (rotatedY * Fixed(range)).toInt()));
+        }
+        return polygon(vertices);
+    }
+
+    Shape Shape::sweep(const Rect& rect, const Vector& displacement) {
+        std::vector<Vector> corners;
+        for (int step = 0; step < 2; step++) {
+            int x = rect.topLeft.x + displacement.x * step;
+            int y = rect.topLeft.y + displacement.y * step;
+            corners.push_back(Vector(x, y));
+            corners.push_back(Vector(x + rect.width, y));
+            corners.push_back(Vector(x + rect.width, y + rect.height));
+            corners.push_back(Vector(x, y + rect.height));
+        }
+        return polygon(corners);
+    }
+
+    bool Shape::normalizeAxis(int64_t x, int64_t y, int32_t& unitX, int32_t& unitY) {
+        if (x == 0 && y == 0) {
+            return false;
+        }
+        while (x > AXIS_LIMIT || x < -AXIS_LIMIT || y > AXIS_LIMIT || y < -AXIS_LIMIT) {
+            x /= 2;
+            y /= 2;
+        }
+        while (x <= AXIS_LIMIT / 2 && x >= -AXIS_LIMIT / 2 && y <= AXIS_LIMIT / 2 && y >= -AXIS_LIMIT / 2) {
+            x *= 2;
+            y *= 2;
+        }
+        int64_t length = integerSqrt(x * x + y * y);
+        unitX = static_cast<int32_t>(x * Fixed::ONE / length);
+        unitY = static_cast<int32_t>(y * Fixed::ONE / length);
+        return true;
+    }
+
+    void Shape::projectRect(const Rect& rect, int32_t axisX, int32_t axisY, int64_t& minimum, int64_t& maximum) {
+        int64_t left = rect.topLeft.x;
+        int64_t right = left + rect.width;
+        int64_t top = rect.topLeft.y;
+        int64_t bottom = top + rect.height;
+        minimum = (axisX >= 0 ? left : right) * axisX + (axisY >= 0 ? top : bottom) * axisY;
+        maximum = (axisX >= 0 ? right : left) * axisX + (axisY >= 0 ? bottom : top) * axisY;
+    }
+
+    void Shape::setVertices(const std::vector<Vector>& vertices) {
+        vertexCount = vertices.size() < MAX_VERTICES ? vertices.size() : MAX_VERTICES;
+        for (unsigned int i = 0; i < MAX_VERTICES; i++) {
+            const Vector& vertex = vertexCount == 0 ? Vector(0, 0) : vertices[i < vertexCount ? i : 0];
+            xs[i] = vertex.x;
+            ys[i] = vertex.y;
+        }
+        int minX = *std::min_element(xs, xs + MAX_VERTICES) - radius;
+        int minY = *std::min_element(ys, ys + MAX_VERTICES) - radius;
+        int maxX = *std::max_element(xs, xs + MAX_VERTICES) + radius;
+        int maxY = *std::max_element(ys, ys + MAX_VERTICES) + radius;
+        bounds = Rect(Vector(minX, minY), maxX - minX, maxY - minY);
+    }
+
+    Shape Shape::translated(const Vector& offset) const {
+        Shape shape(*this);
+        for (unsigned int i = 0; i < MAX_VERTICES; i++) {
+            shape.xs[i] += offset.x;
+            shape.ys[i] += offset.y;
+        }
+        shape.bounds.topLeft = Vector(bounds.topLeft.x + offset.x, bounds.topLeft.y + offset.y);
+        return shape;
+    }
+
+    void Shape::project(int32_t axisX, int32_t axisY, int64_t& minimum, int64_t& maximum) const {
+        int64_t low = static_cast<int64_t>(xs[0]) * axisX + static_cast<int64_t>(ys[0]) * axisY;
+        int64_t high = low;
+        for (unsigned int i = 1; i < MAX_VERTICES; i++) {
+            int64_t projected = static_cast<int64_t>(xs[i]) * axisX + static_cast<int64_t>(ys[i]) * axisY;
+            low = std::min(low, projected);
+            high = std::max(high, projected);
+        }
+        int64_t padding = static_cast<int64_t>(radius) * Fixed::ONE;
+        minimum = low - padding;
+        maximum = high + padding;
+    }
+
+    unsigned int Shape::addEdgeNormals(int32_t* axesX, int32_t* axesY, unsigned int axisCount) const {
+        if (vertexCount < 2) {
+            return axisCount;
+        }
+        unsigned int edges = vertexCount == 2 ? 1 : vertexCount;
+        for (unsigned int i = 0; i < edges; i++) {
+            unsigned int next = (i + 1) % vertexCount;
+            if (normalizeAxis(static_cast<int64_t>(ys[i]) - ys[next], static_cast<int64_t>(xs[next]) - xs[i], axesX[axisCount], axesY[axisCount])) {
+                axisCount++;
+            }
+        }
+        return axisCount;
+    }
+
+    bool Shape::overlaps(const Shape& other) const {
+        if (!bounds.intersects(other.bounds)) {
+            return false;
+        }
+        int32_t axesX[MAX_AXES];
+        int32_t axesY[MAX_AXES];
+        unsigned int axisCount = addEdgeNormals(axesX, axesY, 0);
+        axisCount = other.addEdgeNormals(axesX, axesY, axisCount);
+        if (radius + other.radius > 0) {
+            for (unsigned int i = 0; i < vertexCount; i++) {
+                for (unsigned int j = 0; j < other.vertexCount; j++) {
+                    if (normalizeAxis(static_cast<int64_t>(other.xs[j]) - xs[i], static_cast<int64_t>(other.ys[j]) - ys[i], axesX[axisCount], axesY[axisCount])) {
+                        axisCount++;
+                    }
+                }
+            }
+        }
+        for (unsigned int i = 0; i < axisCount; i++) {
+            int64_t minimum, maximum, otherMinimum, otherMaximum;
+            project(axesX[i], axesY[i], minimum, maximum);
+            other.project(axesX[i], axesY[i], otherMinimum, otherMaximum);
+            if (maximum < otherMinimum || otherMaximum < minimum) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Shape::overlaps(const Rect& rect) const {
+        return overlaps(aabb(rect));
+    }
+
+    void Shape::getEdgeAxes(EdgeAxes& edgeAxes) const {
+        edgeAxes.count = 0;
+        if (type == TYPE::AABB || vertexCount < 2) {
+            return;
+        }
+        edgeAxes.count = addEdgeNormals(edgeAxes.xs, edgeAxes.ys, 0);
+        for (unsigned int i = 0; i < edgeAxes.count; i++) {
+            project(edgeAxes.xs[i], edgeAxes.ys[i], edgeAxes.minimums[i], edgeAxes.maximums[i]);
+        }
+    }
+
+    bool Shape::cornersSeparate(const Rect& rect) const {
+        int right = rect.topLeft.x + rect.width;
+        int bottom = rect.topLeft.y + rect.height;
+        for (unsigned int vertex = 0; vertex < vertexCount && radius > 0; vertex++) {
+            int64_t cornerX = static_cast<int64_t>(xs[vertex]) * 2 < static_cast<int64_t>(rect.topLeft.x) + right ? rect.topLeft.x : right;
+            int64_t cornerY = static_cast<int64_t>(ys[vertex]) * 2 < static_cast<int64_t>(rect.topLeft.y) + bottom ? rect.topLeft.y : bottom;
+            int32_t axisX, axisY;
+            if (!normalizeAxis(cornerX - xs[vertex], cornerY - ys[vertex], axisX, axisY)) {
+                continue;
+            }
+            int64_t minimum, maximum, rectMinimum, rectMaximum;
+            project(axisX, axisY, minimum, maximum);
+            projectRect(rect, axisX, axisY, rectMinimum, rectMaximum);
+            if (rectMaximum < minimum || rectMinimum > maximum) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Shape::overlapsRect(const Rect& rect, const EdgeAxes& edgeAxes) const {
+        int right = rect.topLeft.x + rect.width;
+        int bottom = rect.topLeft.y + rect.height;
+        if (right < bounds.topLeft.x || rect.topLeft.x > bounds.topLeft.x + bounds.width || bottom < bounds.topLeft.y || rect.topLeft.y > bounds.topLeft.y + bounds.height) {
+            return false;
+        }
+        for (unsigned int axis = 0; axis < edgeAxes.count; axis++) {
+            int64_t minimum, maximum;
+            projectRect(rect, edgeAxes.xs[axis], edgeAxes.ys[axis], minimum, maximum);
+            if (maximum < edgeAxes.minimums[axis] || minimum > edgeAxes.maximums[axis]) {
+                return false;
+            }
+        }
+        return !cornersSeparate(rect);
+    }
+
+    void Shape::overlapsRectsScalar(const std::vector<Rect>& rects, unsigned int start, const EdgeAxes& edgeAxes, std::vector<char>& results) const {
+        for (unsigned int i = start; i < rects.size(); i++) {
+            results[i] = overlapsRect(rects[i], edgeAxes);
+        }
+    }
+
+#if defined(__SSE2__)
+    static_assert(sizeof(Rect) == 4 * sizeof(int32_t), "overlapsRectsSIMD loads each Rect as one 128-bit lane group");
+
+    void Shape::overlapsRectsSIMD(const std::vector<Rect>& rects, const EdgeAxes& edgeAxes, std::vector<char>& results) const {
+        int32_t originX = bounds.topLeft.x;
+        int32_t originY = bounds.topLeft.y;
+        __m128i axisHighs[MAX_VERTICES];
+        __m128i axisLows[MAX_VERTICES];
+        __m128i minimumLimits[MAX_VERTICES];
+        __m128i maximumLimits[MAX_VERTICES];
+        for (unsigned int axis = 0; axis < edgeAxes.count; axis++) {
+            int32_t lowX = edgeAxes.xs[axis] & 0xff;
+            int32_t lowY = edgeAxes.ys[axis] & 0xff;
+            int32_t highX = (edgeAxes.xs[axis] - lowX) / 256;
+            int32_t highY = (edgeAxes.ys[axis] - lowY) / 256;
+            axisHighs[axis] = _mm_set1_epi32(static_cast<int32_t>((static_cast<uint32_t>(highX) & 0xffff) | (static_cast<uint32_t>(highY) << 16)));
+            axisLows[axis] = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(lowX) | (static_cast<uint32_t>(lowY) << 16)));
+            int64_t origin = static_cast<int64_t>(originX) * edgeAxes.xs[axis] + static_cast<int64_t>(originY) * edgeAxes.ys[axis];
+            int64_t minimumLimit = std::min<int64_t>(std::max<int64_t>(edgeAxes.minimums[axis] - origin, INT32_MIN), INT32_MAX);
+            int64_t maximumLimit = std::min<int64_t>(std::max<int64_t>(edgeAxes.maximums[axis] - origin, INT32_MIN), INT32_MAX);
+            minimumLimits[axis] = _mm_set1_epi32(static_cast<int32_t>(minimumLimit));
+            maximumLimits[axis] = _mm_set1_epi32(static_cast<int32_t>(maximumLimit));
+        }
+        const __m128i boundsRight = _mm_set1_epi32(bounds.width);
+        const __m128i boundsBottom = _mm_set1_epi32(bounds.height);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rangeHigh = _mm_set1_epi32(SIMD_RANGE);
+        const __m128i rangeLow = _mm_set1_epi32(-SIMD_RANGE);
+        unsigned int batchEnd = rects.size() - rects.size() % SIMD_WIDTH;
+        const __m128i origin = _mm_setr_epi32(originX, originY, 0, 0);
+        for (unsigned int i = 0; i < batchEnd; i += SIMD_WIDTH) {
+            const Rect* batch = &rects[i];
+            __m128i first = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch[0])), origin);
+            __m128i second = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch[1])), origin);
+            __m128i third = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch[2])), origin);
+            __m128i fourth = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch[3])), origin);
+            __m128i lowPairs = _mm_unpacklo_epi32(first, second);
+            __m128i lowPairsNext = _mm_unpacklo_epi32(third, fourth);
+            __m128i highPairs = _mm_unpackhi_epi32(first, second);
+            __m128i highPairsNext = _mm_unpackhi_epi32(third, fourth);
+            __m128i left = _mm_unpacklo_epi64(lowPairs, lowPairsNext);
+            __m128i top = _mm_unpackhi_epi64(lowPairs, lowPairsNext);
+            __m128i right = _mm_add_epi32(left, _mm_unpacklo_epi64(highPairs, highPairsNext));
+            __m128i bottom = _mm_add_epi32(top, _mm_unpackhi_epi64(highPairs, highPairsNext));
+            __m128i outOfRange = _mm_or_si128(_mm_cmplt_epi32(left, rangeLow), _mm_cmpgt_epi32(right, rangeHigh));
+            outOfRange = _mm_or_si128(outOfRange, _mm_or_si128(_mm_cmplt_epi32(top, rangeLow), _mm_cmpgt_epi32(bottom, rangeHigh)));
+            outOfRange = _mm_or_si128(outOfRange, _mm_or_si128(_mm_cmplt_epi32(right, left), _mm_cmplt_epi32(bottom, top)));
+            if (_mm_movemask_epi8(outOfRange) != 0) {
+                for (unsigned int lane = 0; lane < SIMD_WIDTH; lane++) {
+                    results[i + lane] = overlapsRect(batch[lane], edgeAxes);
+                }
+                continue;
+            }
+            __m128i separated = _mm_or_si128(_mm_cmplt_epi32(right, zero), _mm_cmpgt_epi32(left, boundsRight));
+            separated = _mm_or_si128(separated, _mm_or_si128(_mm_cmplt_epi32(bottom, zero), _mm_cmpgt_epi32(top, boundsBottom)));
+            __m128i lefts = _mm_packs_epi32(left, left);
+            __m128i rights = _mm_packs_epi32(right, right);
+            __m128i tops = _mm_packs_epi32(top, top);
+            __m128i bottoms = _mm_packs_epi32(bottom, bottom);
+            __m128i corners[4] = { _mm_unpacklo_epi16(lefts, tops), _mm_unpacklo_epi16(rights, tops), _mm_unpacklo_epi16(lefts, bottoms), _mm_unpacklo_epi16(rights, bottoms) };
+            for (unsigned int axis = 0; axis < edgeAxes.count && _mm_movemask_epi8(separated) != 0xffff; axis++) {
+                unsigned int minimumCorner = (edgeAxes.xs[axis] >= 0 ? 0 : 1) | (edgeAxes.ys[axis] >= 0 ? 0 : 2);
+                unsigned int maximumCorner = minimumCorner ^ 3;
+                __m128i minimum = _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(corners[minimumCorner], axisHighs[axis]), 8), _mm_madd_epi16(corners[minimumCorner], axisLows[axis]));
+                __m128i maximum = _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(corners[maximumCorner], axisHighs[axis]), 8), _mm_madd_epi16(corners[maximumCorner], axisLows[axis]));
+                separated = _mm_or_si128(separated, _mm_or_si128(_mm_cmplt_epi32(maximum, minimumLimits[axis]), _mm_cmpgt_epi32(minimum, maximumLimits[axis])));
+            }
+            int separatedLanes = _mm_movemask_epi8(separated);
+            for (unsigned int lane = 0; lane < SIMD_WIDTH; lane++) {
+                bool laneSeparated = (separatedLanes >> (lane * 4)) & 1;
+                results[i + lane] = !laneSeparated && (radius == 0 || !cornersSeparate(batch[lane]));
+            }
+        }
+        overlapsRectsScalar(rects, batchEnd, edgeAxes, results);
+    }
+#endif
+
+    void Shape::overlapsRects(const std::vector<Rect>& rects, std::vector<char>& results) const {
+        results.assign(rects.size(), 0);
+        EdgeAxes edgeAxes;
+        getEdgeAxes(edgeAxes);
+#if defined(__SSE2__)
+        overlapsRectsSIMD(rects, edgeAxes, results);
+#else
+        overlapsRectsScalar(rects, 0, edgeAxes, results);
+#endif
+    }
+
+    Shape::TYPE Shape::getType() const {
+        return type;
+    }
+
+    unsigned int Shape::getVertexCount() const {
+        return vertexCount;
+    }
+
+    Vector Shape::getVertex(unsigned int index) const {
+        return Vector(xs[index], ys[index]);
+    }
+
+    int Shape::getRadius() const {
+        return radius;
+    }
+
+    const Rect& Shape::getBounds() const {
+        return bounds;
+    }
+
+}
@@ -0,0 +1,158 @@
+#include "sharedMemory.hpp"
+#include <cstdint>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Game {
+
+    SharedMemory::SharedMemory() {
+        data = NULL;
+        size = 0;
+        owner = false;
+#ifdef _WIN32
+        mappingHandle = NULL;
+#else
+        descriptor = -1;
+#endif
+    }
+
+    SharedMemory::~SharedMemory() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool SharedMemory::create(const std::string& name_, size_t size_) {
+        close();
+        uint64_t mappingSize = size_;
+        mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), name_.c_str());
+        if (!mappingHandle) {
+            return false;
+        }
+        data = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size_));
+        if (!data) {
+            close();
+            return false;
+        }
+        size = size_;
+        owner = true;
+        name = name_;
+        return true;
+    }
+
+    bool SharedMemory::open(const std::string& name_) {
+        close();
+        mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+        if (!mappingHandle) {
+            return false;
+        }
+        data = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+        MEMORY_BASIC_INFORMATION information;
+        if (!data || VirtualQuery(data, &information, sizeof(information)) == 0) {
+            close();
+            return false;
+        }
+        size = information.RegionSize;
+        name = name_;
+        return true;
+    }
+
+    void SharedMemory::close() {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        data = NULL;
+        size = 0;
+        owner = false;
+        mappingHandle = NULL;
+    }
+#else
+    bool SharedMemory::create(const std::string& name_, size_t size_) {
+        close();
+        std::string path = "/" + name_;
+        shm_unlink(path.c_str());
+        descriptor = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (descriptor < 0) {
+            return false;
+        }
+        owner = true;
+        name = name_;
+        if (ftruncate(descriptor, size_) != 0) {
+            close();
+            return false;
+        }
+        void* mapped = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        data = static_cast<char*>(mapped);
+        size = size_;
+        return true;
+    }
+
+    bool SharedMemory::open(const std::string& name_) {
+        close();
+        std::string path = "/" + name_;
+        descriptor = shm_open(path.c_str(), O_RDWR, 0600);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+            close();
+            return false;
+        }
+        void* mapped = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        data = static_cast<char*>(mapped);
+        size = status.st_size;
+        name = name_;
+        return true;
+    }
+
+    void SharedMemory::close() {
+        if (data) {
+            munmap(data, size);
+        }
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+        if (owner) {
+            shm_unlink(("/" + name).c_str());
+        }
+        data = NULL;
+        size = 0;
+        owner = false;
+        descriptor = -1;
+    }
+#endif
+
+    bool SharedMemory::isOpen() const {
+        return data != NULL;
+    }
+
+    bool SharedMemory::isOwner() const {
+        return owner;
+    }
+
+    char* SharedMemory::getData() const {
+        return data;
+    }
+
+    size_t SharedMemory::getSize() const {
+        return size;
+    }
+
+}
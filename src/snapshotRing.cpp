@@ -0,0 +1,214 @@
+#include "snapshotRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <algorithm>
+
+namespace Rendering {
+
+    namespace {
+
+        const uint32_t RING_MAGIC = 0x474e5253;
+        const uint32_t RING_VERSION = 2;
+        const size_t SLOT_ALIGNMENT = 64;
+        const uint32_t NO_SLOT = SnapshotRing::SLOT_COUNT;
+
+        size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+    }
+
+    struct SnapshotRing::RingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entityCapacity;
+        uint32_t eventCapacity;
+        uint64_t slotStride;
+        std::atomic<uint32_t> latest;
+        std::atomic<uint32_t> pinned;
+        std::atomic<uint32_t> intentHead;
+        std::atomic<uint32_t> intentTail;
+        Game::Intent intents[SnapshotRing::INTENT_CAPACITY];
+    };
+
+    SnapshotRing::SnapshotRing() {
+        header = NULL;
+        nextSequence = 1;
+        lastSlot = 0;
+    }
+
+    SnapshotRing::~SnapshotRing() {
+        close();
+    }
+
+    size_t SnapshotRing::getSlotStride(unsigned int entityCapacity, unsigned int eventCapacity) {
+        size_t entityOffset = alignUp(sizeof(SnapshotSlot), alignof(EntitySnapshot));
+        size_t eventOffset = alignUp(entityOffset + sizeof(EntitySnapshot) * entityCapacity, alignof(Game::MapEvent));
+        return alignUp(eventOffset + sizeof(Game::MapEvent) * eventCapacity, SLOT_ALIGNMENT);
+    }
+
+    char* SnapshotRing::getSlotData(unsigned int slot) const {
+        return reinterpret_cast<char*>(header) + alignUp(sizeof(RingHeader), SLOT_ALIGNMENT) + header->slotStride * slot;
+    }
+
+    bool SnapshotRing::create(const std::string& name, unsigned int entityCapacity, unsigned int eventCapacity) {
+        close();
+        size_t slotStride = getSlotStride(entityCapacity, eventCapacity);
+        if (!memory.create(name, alignUp(sizeof(RingHeader), SLOT_ALIGNMENT) + slotStride * SLOT_COUNT)) {
+            return false;
+        }
+        header = new (memory.getData()) RingHeader();
+        header->magic = RING_MAGIC;
+        header->version = RING_VERSION;
+        header->entityCapacity = entityCapacity;
+        header->eventCapacity = eventCapacity;
+        header->slotStride = slotStride;
+        header->latest.store(0);
+        header->pinned.store(NO_SLOT);
+        header->intentHead.store(0);
+        header->intentTail.store(0);
+        nextSequence = 1;
+        lastSlot = 0;
+        return true;
+    }
+
+    bool SnapshotRing::open(const std::string& name) {
+        close();
+        if (!memory.open(name) || memory.getSize() < sizeof(RingHeader)) {
+            memory.close();
+            return false;
+        }
+        RingHeader* mapped = reinterpret_cast<RingHeader*>(memory.getData());
+        if (mapped->magic != RING_MAGIC || mapped->version != RING_VERSION || mapped->slotStride != getSlotStride(mapped->entityCapacity, mapped->eventCapacity) || memory.getSize() < alignUp(sizeof(RingHeader), SLOT_ALIGNMENT) + mapped->slotStride * SLOT_COUNT) {
+            memory.close();
+            return false;
+        }
+        header = mapped;
+        return true;
+    }
+
+    void SnapshotRing::close() {
+        if (header && !memory.isOwner()) {
+            release();
+        }
+        header = NULL;
+        memory.close();
+    }
+
+    bool SnapshotRing::isOpen() const {
+        return header != NULL;
+    }
+
+    void SnapshotRing::publish(Game::Map& map, unsigned int tick, uint64_t& eventCursor) {
+        uint32_t latestSlot = header->latest.load() % SLOT_COUNT;
+        uint32_t pinnedSlot = header->pinned.load();
+        unsigned int slotIndex = lastSlot;
+        for (unsigned int i = 1; i <= SLOT_COUNT; i++) {
+            slotIndex = (lastSlot + i) % SLOT_COUNT;
+            if (slotIndex != latestSlot && slotIndex != pinnedSlot) {
+                break;
+            }
+        }
+        lastSlot = slotIndex;
+
+        char* data = getSlotData(slotIndex);
+        SnapshotSlot* slot = reinterpret_cast<SnapshotSlot*>(data);
+        EntitySnapshot* entities = const_cast<EntitySnapshot*>(getEntities(slot));
+        Game::MapEvent* events = const_cast<Game::MapEvent*>(getEvents(slot));
+
+        uint32_t entityCount = 0;
+        slot->truncated = 0;
+        for (const Game::Entity& entity : map.getEntities()) {
+            if (entityCount == header->entityCapacity) {
+                slot->truncated = 1;
+                break;
+            }
+            EntitySnapshot& entitySnapshot = entities[entityCount++];
+            entitySnapshot.id = entity.getID();
+            entitySnapshot.hitbox = entity.getHitbox();
+            entitySnapshot.hp = entity.getBaseStats().stats[Game::EntityStats::STAT::HP];
+            entitySnapshot.awake = map.isAwake(entitySnapshot.id);
+            entitySnapshot.prefab = entity.getPrefab();
+        }
+        std::sort(entities, entities + entityCount, [](const EntitySnapshot& first, const EntitySnapshot& second) {
+            return first.id < second.id;
+        });
+
+        uint32_t eventCount = 0;
+        uint32_t eventCapacity = header->eventCapacity;
+        bool eventsComplete = map.getEvents().read(eventCursor, [events, &eventCount, eventCapacity](const Game::MapEvent& event) {
+            if (eventCount < eventCapacity) {
+                events[eventCount] = event;
+            }
+            eventCount++;
+        });
+
+        Game::MapStats mapStats = map.getStats();
+        slot->sequence = nextSequence++;
+        slot->tick = tick;
+        slot->playerID = map.getPlayerID();
+        slot->entityCount = entityCount;
+        slot->eventCount = std::min(eventCount, eventCapacity);
+        slot->eventsComplete = eventsComplete && eventCount <= eventCapacity ? 1 : 0;
+        slot->awakeEntities = mapStats.awakeEntities;
+        slot->sleepingEntities = mapStats.sleepingEntities;
+        slot->publishedNanoseconds = getTimestamp();
+        header->latest.store(slot->sequence * SLOT_COUNT + slotIndex);
+    }
+
+    bool SnapshotRing::popIntent(Game::Intent& intent) {
+        uint32_t tail = header->intentTail.load(std::memory_order_relaxed);
+        if (tail == header->intentHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+        intent = header->intents[tail % INTENT_CAPACITY];
+        header->intentTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    const SnapshotSlot* SnapshotRing::acquireLatest() {
+        uint32_t latest = header->latest.load();
+        if (latest == 0) {
+            return NULL;
+        }
+        while (true) {
+            header->pinned.store(latest % SLOT_COUNT);
+            uint32_t confirmed = header->latest.load();
+            if (confirmed == latest) {
+                break;
+            }
+            latest = confirmed;
+        }
+        return reinterpret_cast<const SnapshotSlot*>(getSlotData(latest % SLOT_COUNT));
+    }
+
+    void SnapshotRing::release() {
+        header->pinned.store(NO_SLOT);
+    }
+
+    const EntitySnapshot* SnapshotRing::getEntities(const SnapshotSlot* slot) const {
+        return reinterpret_cast<const EntitySnapshot*>(reinterpret_cast<const char*>(slot) + alignUp(sizeof(SnapshotSlot), alignof(EntitySnapshot)));
+    }
+
+    const Game::MapEvent* SnapshotRing::getEvents(const SnapshotSlot* slot) const {
+        size_t entityOffset = alignUp(sizeof(SnapshotSlot), alignof(EntitySnapshot));
+        size_t eventOffset = alignUp(entityOffset + sizeof(EntitySnapshot) * header->entityCapacity, alignof(Game::MapEvent));
+        return reinterpret_cast<const Game::MapEvent*>(reinterpret_cast<const char*>(slot) + eventOffset);
+    }
+
+    bool SnapshotRing::pushIntent(const Game::Intent& intent) {
+        uint32_t head = header->intentHead.load(std::memory_order_relaxed);
+        if (head - header->intentTail.load(std::memory_order_acquire) >= INTENT_CAPACITY) {
+            return false;
+        }
+        header->intents[head % INTENT_CAPACITY] = intent;
+        header->intentHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t SnapshotRing::getTimestamp() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+}
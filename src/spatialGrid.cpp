@@ -0,0 +1,184 @@
+#include "spatialGrid.hpp"
+
+namespace Game {
+
+    bool SpatialGrid::CellRange::operator==(const CellRange& range) const {
+        return minX == range.minX && minY == range.minY && maxX == range.maxX && maxY == range.maxY;
+    }
+
+    SpatialGrid::SpatialGrid() {
+        cellSize = 128;
+        queryStamp = 0;
+    }
+
+    SpatialGrid::SpatialGrid(int cellSize_) {
+        cellSize = cellSize_;
+        queryStamp = 0;
+    }
+
+    int SpatialGrid::toCell(int coordinate) const {
+        if (coordinate >= 0) {
+            return coordinate / cellSize;
+        }
+        return -((-coordinate + cellSize - 1) / cellSize);
+    }
+
+    SpatialGrid::CellRange SpatialGrid::getCellRange(const Rect& rect) const {
+        CellRange range;
+        range.minX = toCell(rect.topLeft.x);
+        range.minY = toCell(rect.topLeft.y);
+        range.maxX = toCell(rect.topLeft.x + rect.width);
+        range.maxY = toCell(rect.topLeft.y + rect.height);
+        return range;
+    }
+
+    int64_t SpatialGrid::getCellKey(int cellX, int cellY) {
+        return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY));
+    }
+
+    void SpatialGrid::addToCells(unsigned int entityID, const CellRange& range) {
+        for (int cellY = range.minY; cellY <= range.maxY; cellY++) {
+            for (int cellX = range.minX; cellX <= range.maxX; cellX++) {
+                cells[getCellKey(cellX, cellY)].push_back(entityID);
+            }
+        }
+    }
+
+    void SpatialGrid::removeFromCells(unsigned int entityID, const CellRange& range) {
+        for (int cellY = range.minY; cellY <= range.maxY; cellY++) {
+            for (int cellX = range.minX; cellX <= range.maxX; cellX++) {
+                std::unordered_map<int64_t, std::vector<unsigned int>>::iterator cell = cells.find(getCellKey(cellX, cellY));
+                if (cell == cells.end()) {
+                    continue;
+                }
+                std::vector<unsigned int>& cellEntities = cell->second;
+                for (unsigned int i = 0; i < cellEntities.size(); i++) {
+                    if (cellEntities[i] == entityID) {
+                        cellEntities[i] = cellEntities.back();
+                        cellEntities.pop_back();
+                        break;
+                    }
+                }
+                if (cellEntities.empty()) {
+                    cells.erase(cell);
+                }
+            }
+        }
+    }
+
+    bool SpatialGrid::markVisited(unsigned int entityID) {
+        if (entityID >= queryMarks.size()) {
+            queryMarks.resize(entityID + 1, 0);
+        }
+        if (queryMarks[entityID] == queryStamp) {
+            return false;
+        }
+        queryMarks[entityID] = queryStamp;
+        return true;
+    }
+
+    void SpatialGrid::insert(unsigned int entityID, const Rect& bounds) {
+        if (contains(entityID)) {
+            update(entityID, bounds);
+            return;
+        }
+        CellRange range = getCellRange(bounds);
+        entityRanges[entityID] = range;
+        addToCells(entityID, range);
+    }
+
+    void SpatialGrid::update(unsigned int entityID, const Rect& bounds) {
+        std::unordered_map<unsigned int, CellRange>::iterator current = entityRanges.find(entityID);
+        if (current == entityRanges.end()) {
+            insert(entityID, bounds);
+            return;
+        }
+        CellRange range = getCellRange(bounds);
+        if (current->second == range) {
+            return;
+        }
+        removeFromCells(entityID, current->second);
+        addToCells(entityID, range);
+        current->second = range;
+    }
+
+    void SpatialGrid::remove(unsigned int entityID) {
+        std::unordered_map<unsigned int, CellRange>::iterator current = entityRanges.find(entityID);
+        if (current != entityRanges.end()) {
+            removeFromCells(entityID, current->second);
+            entityRanges.erase(current);
+        }
+    }
+
+    bool SpatialGrid::contains(unsigned int entityID) const {
+        return entityRanges.find(entityID) != entityRanges.end();
+    }
+
+    void SpatialGrid::query(const Rect& area, std::vector<unsigned int>& found) {
+        queryStamp++;
+        if (queryStamp == 0) {
+            std::fill(queryMarks.begin(), queryMarks.end(), 0);
+            queryStamp = 1;
+        }
+        CellRange range = getCellRange(area);
+        for (int cellY = range.minY; cellY <= range.maxY; cellY++) {
+            for (int cellX = range.minX; cellX <= range.maxX; cellX++) {
+                std::unordered_map<int64_t, std::vector<unsigned int>>::const_iterator cell = cells.find(getCellKey(cellX, cellY));
+                if (cell == cells.end()) {
+                    continue;
+                }
+                for (unsigned int entityID : cell->second) {
+                    if (markVisited(entityID)) {
+                        found.push_back(entityID);
+                    }
+                }
+            }
+        }
+    }
+
+    void SpatialGrid::clear() {
+        cells.clear();
+        entityRanges.clear();
+    }
+
+    void SpatialGrid::reserve(unsigned int entityCount) {
+        entityRanges.reserve(entityCount);
+        cells.reserve(entityCount);
+    }
+
+    void SpatialGrid::build(const std::vector<unsigned int>& entityIDs, const std::vector<Rect>& bounds) {
+        clear();
+        std::vector<std::pair<int64_t, unsigned int>> cellEntries;
+        cellEntries.reserve(entityIDs.size());
+        entityRanges.reserve(entityIDs.size());
+        for (size_t i = 0; i < entityIDs.size(); i++) {
+            CellRange range = getCellRange(bounds[i]);
+            entityRanges[entityIDs[i]] = range;
+            for (int cellY = range.minY; cellY <= range.maxY; cellY++) {
+                for (int cellX = range.minX; cellX <= range.maxX; cellX++) {
+                    cellEntries.push_back(std::make_pair(getCellKey(cellX, cellY), entityIDs[i]));
+                }
+            }
+        }
+        std::sort(cellEntries.begin(), cellEntries.end());
+        cells.reserve(cellEntries.size());
+        size_t start = 0;
+        while (start < cellEntries.size()) {
+            size_t end = start + 1;
+            while (end < cellEntries.size() && cellEntries[end].first == cellEntries[start].first) {
+                end++;
+            }
+            std::vector<unsigned int>& cellEntities = cells[cellEntries[start].first];
+            cellEntities.reserve(end - start);
+            for (size_t i = start; i < end; i++) {
+                cellEntities.push_back(cellEntries[i].second);
+            }
+            start = end;
+        }
+    }
+
+    int SpatialGrid::getCellSize() const {
+        return cellSize;
+    }
+
+}
@@ -0,0 +1,89 @@
+#include "spriteBatch.hpp"
+
+namespace Rendering {
+
+    SpriteBatch::SpriteBatch() {
+        visibleArea = sf::FloatRect();
+        quadCount = 0;
+        culledCount = 0;
+        drawCalls = 0;
+    }
+
+    SpriteBatch::Run& SpriteBatch::getRun(const sf::Texture* texture) {
+        if (runs.empty() || runs.back().texture != texture) {
+            Run run;
+            run.texture = texture;
+            run.firstVertex = vertices.size();
+            run.vertexCount = 0;
+            runs.push_back(run);
+        }
+        return runs.back();
+    }
+
+    void SpriteBatch::begin(const sf::FloatRect& visibleArea_) {
+        visibleArea = visibleArea_;
+        quadCount = 0;
+        culledCount = 0;
+        drawCalls = 0;
+        vertices.clear();
+        runs.clear();
+    }
+
+    bool SpriteBatch::add(const sf::Sprite& sprite) {
+        const sf::Texture* texture = sprite.getTexture();
+        if (!texture) {
+            return false;
+        }
+        if (!visibleArea.intersects(sprite.getGlobalBounds())) {
+            culledCount++;
+            return false;
+        }
+        const sf::Transform& transform = sprite.getTransform();
+        sf::FloatRect local = sprite.getLocalBounds();
+        sf::IntRect textureRect = sprite.getTextureRect();
+        float left = static_cast<float>(textureRect.left);
+        float top = static_cast<float>(textureRect.top);
+        float right = left + textureRect.width;
+        float bottom = top + textureRect.height;
+        sf::Color color = sprite.getColor();
+
+        sf::Vertex topLeft(transform.transformPoint(0, 0), color, sf::Vector2<float>(left, top));
+        sf::Vertex topRight(transform.transformPoint(local.width, 0), color, sf::Vector2<float>(right, top));
+        sf::Vertex bottomRight(transform.transformPoint(local.width, local.height), color, sf::Vector2<float>(right, bottom));
+        sf::Vertex bottomLeft(transform.transformPoint(0, local.height), color, sf::Vector2<float>(left, bottom));
+
+        getRun(texture).vertexCount += 6;
+        vertices.push_back(topLeft);
+        vertices.push_back(topRight);
+        vertices.push_back(bottomRight);
+        vertices.push_back(topLeft);
+        vertices.push_back(bottomRight);
+        vertices.push_back(bottomLeft);
+        quadCount++;
+        return true;
+    }
+
+    void SpriteBatch::flush(sf::RenderTarget& target) {
+        for (const Run& run : runs) {
+            sf::RenderStates states;
+            states.texture = run.texture;
+            target.draw(&vertices[run.firstVertex], run.vertexCount, sf::Triangles, states);
+            drawCalls++;
+        }
+        vertices.clear();
+        runs.clear();
+    }
+
+    unsigned int SpriteBatch::getQuadCount() const {
+        return quadCount;
+    }
+
+    unsigned int SpriteBatch::getCulledCount() const {
+        return culledCount;
+    }
+
+    unsigned int SpriteBatch::getDrawCalls() const {
+        return drawCalls;
+    }
+
+}
@@ -0,0 +1,86 @@
+#include "textureAtlas.hpp"
+#include <iostream>
+
+namespace Rendering {
+
+    void TextureAtlas::extrudeEdges(sf::Image& page, const AtlasPlacement& placement, unsigned int padding) {
+        int right = placement.x + placement.width - 1;
+        int bottom = placement.y + placement.height - 1;
+        for (unsigned int offset = 1; offset <= padding; offset++) {
+            for (int y = placement.y; y <= bottom; y++) {
+                page.setPixel(placement.x - offset, y, page.getPixel(placement.x, y));
+                page.setPixel(right + offset, y, page.getPixel(right, y));
+            }
+        }
+        for (unsigned int offset = 1; offset <= padding; offset++) {
+            for (int x = placement.x - padding; x <= right + static_cast<int>(padding); x++) {
+                page.setPixel(x, placement.y - offset, page.getPixel(x, placement.y));
+                page.setPixel(x, bottom + offset, page.getPixel(x, bottom));
+            }
+        }
+    }
+
+    void TextureAtlas::composePages(const std::vector<sf::Image>& images, AtlasPacker& packer, std::vector<sf::Image>& pageImages) {
+        for (const sf::Image& image : images) {
+            packer.add(image.getSize().x, image.getSize().y);
+        }
+        packer.pack();
+        pageImages.resize(packer.getPageCount());
+        for (unsigned int page = 0; page < packer.getPageCount(); page++) {
+            pageImages[page].create(packer.getPageWidth(page), packer.getPageHeight(page), sf::Color::Transparent);
+        }
+        for (unsigned int i = 0; i < images.size(); i++) {
+            const AtlasPlacement& placement = packer.getPlacement(i);
+            pageImages[placement.page].copy(images[i], placement.x, placement.y);
+            if (placement.width > 0 && placement.height > 0) {
+                extrudeEdges(pageImages[placement.page], placement, packer.getPadding());
+            }
+        }
+    }
+
+    bool TextureAtlas::addPage(unsigned int width, unsigned int height, const sf::Uint8* pixels, unsigned int& page) {
+        if (!freePages.empty()) {
+            page = freePages.back();
+            freePages.pop_back();
+        }
+        else {
+            page = pages.size();
+            pages.push_back(sf::Texture());
+        }
+        if (!pages[page].create(width, height)) {
+            std::cout << "Could not create atlas page of " << width << "x" << height << "\n";
+            return false;
+        }
+        pages[page].update(pixels);
+        return true;
+    }
+
+    void TextureAtlas::releasePage(unsigned int page) {
+        pages[page] = sf::Texture();
+        freePages.push_back(page);
+    }
+
+    unsigned int TextureAtlas::getPageCount() const {
+        return pages.size();
+    }
+
+    unsigned int TextureAtlas::getResidentPageCount() const {
+        return pages.size() - freePages.size();
+    }
+
+    const sf::Texture& TextureAtlas::getPage(unsigned int page) const {
+        return pages[page];
+    }
+
+    void applyFrame(sf::Sprite& sprite, const AtlasFrame& frame) {
+        if (!frame.texture) {
+            sprite.setTextureRect(sf::IntRect(0, 0, 0, 0));
+            return;
+        }
+        if (sprite.getTexture() != frame.texture) {
+            sprite.setTexture(*frame.texture);
+        }
+        sprite.setTextureRect(frame.rect);
+    }
+
+}
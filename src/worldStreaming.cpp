@@ -0,0 +1,344 @@
+#include "worldStreaming.hpp"
+#include <iostream>
+#include <algorithm>
+
+namespace Game {
+
+    WorldStreamer::WorldStreamer() {
+        map = NULL;
+        jobsPending = false;
+        stopping.store(false);
+        evictions = 0;
+    }
+
+    WorldStreamer::~WorldStreamer() {
+        stop();
+    }
+
+    int WorldStreamer::toChunk(int coordinate) {
+        if (coordinate >= 0) {
+            return coordinate / CHUNK_SIZE;
+        }
+        return -((-coordinate - 1) / CHUNK_SIZE) - 1;
+    }
+
+    int64_t WorldStreamer::getChunkKey(int chunkX, int chunkY) {
+        return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY));
+    }
+
+    Rect WorldStreamer::getChunkRect(int chunkX, int chunkY) {
+        return Rect(Vector(chunkX * CHUNK_SIZE, chunkY * CHUNK_SIZE), CHUNK_SIZE, CHUNK_SIZE);
+    }
+
+    WorldStreamer::ChunkRange WorldStreamer::getChunkRange(const Rect& area, int margin) {
+        ChunkRange range;
+        range.minX = toChunk(area.topLeft.x) - margin;
+        range.minY = toChunk(area.topLeft.y) - margin;
+        range.maxX = toChunk(area.topLeft.x + area.width) + margin;
+        range.maxY = toChunk(area.topLeft.y + area.height) + margin;
+        return range;
+    }
+
+    std::string WorldStreamer::getChunkPath(int chunkX, int chunkY) const {
+        return directory + "chunk_" + std::to_string(chunkX) + "_" + std::to_string(chunkY) + ".bin";
+    }
+
+    void WorldStreamer::start(Map* map_, const std::string& directory_) {
+        stop();
+        map = map_;
+        directory = directory_;
+        jobsPending = false;
+        stopping.store(false);
+        worker = std::thread(&WorldStreamer::runWorker, this);
+    }
+
+    void WorldStreamer::stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+        writeEvictedEntities(UINT32_MAX);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping.store(true, std::memory_order_release);
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    void WorldStreamer::runWorker() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait(lock, [this]() {
+                    return jobsPending || stopping.load(std::memory_order_acquire);
+                });
+                jobsPending = false;
+            }
+            bool stopRequested = stopping.load(std::memory_order_acquire);
+            unsigned int handled = jobs.drain([this](std::unique_ptr<ChunkJob> job) {
+                if (job->saving) {
+                    saveChunk(*job);
+                }
+                else {
+                    loadChunk(*job);
+                }
+            });
+            if (stopRequested && handled == 0) {
+                return;
+            }
+        }
+    }
+
+    void WorldStreamer::queueJob(std::unique_ptr<ChunkJob> job) {
+        jobs.push(std::move(job));
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            jobsPending = true;
+        }
+        wake.notify_one();
+    }
+
+    void WorldStreamer::saveChunk(const ChunkJob& job) {
+        if (!writeFile(getChunkPath(job.chunkX, job.chunkY), job.data)) {
+            std::cout << "Failed to save chunk " << job.chunkX << ", " << job.chunkY << std::endl;
+        }
+    }
+
+    void WorldStreamer::loadChunk(const ChunkJob& job) {
+        std::unique_ptr<LoadedChunk> chunk(new LoadedChunk());
+        chunk->chunkX = job.chunkX;
+        chunk->chunkY = job.chunkY;
+        chunk->integrated = 0;
+        std::vector<char> contents;
+        if (readFile(getChunkPath(job.chunkX, job.chunkY), contents)) {
+            BinaryReader reader(contents.data(), contents.size());
+            uint32_t magic = 0;
+            uint16_t version = 0;
+            uint32_t entityCount = 0;
+            bool valid = reader.read(magic) && reader.read(version) && magic == CHUNK_MAGIC && version == CHUNK_VERSION && reader.read(entityCount);
+            for (uint32_t i = 0; valid && i < entityCount; i++) {
+                EntityRecord record;
+                valid = readEntityRecord(reader, record);
+                if (valid) {
+                    chunk->entities.push_back(record);
+                }
+            }
+            uint32_t rectCount = 0;
+            valid = valid && reader.read(rectCount);
+            for (uint32_t i = 0; valid && i < rectCount; i++) {
+                Rect rect;
+                valid = reader.readRect(rect);
+                if (valid) {
+                    chunk->staticGeometry.push_back(rect);
+                }
+            }
+            if (!valid) {
+                std::cout << "Chunk " << job.chunkX << ", " << job.chunkY << " is corrupt, loading it empty" << std::endl;
+                chunk->entities.clear();
+                chunk->staticGeometry.clear();
+            }
+        }
+        loadedChunks.push(std::move(chunk));
+    }
+
+    void WorldStreamer::markResident(const Rect& area) {
+        ChunkRange range = getChunkRange(area, 0);
+        for (int chunkX = range.minX; chunkX <= range.maxX; chunkX++) {
+            for (int chunkY = range.minY; chunkY <= range.maxY; chunkY++) {
+                chunks[getChunkKey(chunkX, chunkY)] = CHUNK_STATE::RESIDENT;
+            }
+        }
+    }
+
+    void WorldStreamer::requestChunks(const ChunkRange& range) {
+        for (int chunkX = range.minX; chunkX <= range.maxX; chunkX++) {
+            for (int chunkY = range.minY; chunkY <= range.maxY; chunkY++) {
+                int64_t key = getChunkKey(chunkX, chunkY);
+                if (chunks.find(key) != chunks.end()) {
+                    continue;
+                }
+                chunks[key] = CHUNK_STATE::LOADING;
+                std::unique_ptr<ChunkJob> job(new ChunkJob());
+                job->saving = false;
+                job->chunkX = chunkX;
+                job->chunkY = chunkY;
+                queueJob(std::move(job));
+            }
+        }
+    }
+
+    void WorldStreamer::integrateLoadedChunks() {
+        loadedChunks.drain([this](std::unique_ptr<LoadedChunk> chunk) {
+            integrating.push_back(std::move(chunk));
+        });
+        unsigned int budget = INTEGRATE_BUDGET;
+        while (!integrating.empty() && budget > 0) {
+            LoadedChunk& chunk = *integrating.front();
+            if (chunk.integrated == 0) {
+                for (const Rect& rect : chunk.staticGeometry) {
+                    map->addStaticGeometry(rect);
+                }
+            }
+            while (chunk.integrated < chunk.entities.size() && budget > 0) {
+                integrateEntity(chunk.entities[chunk.integrated]);
+                chunk.integrated++;
+                budget--;
+            }
+            if (chunk.integrated < chunk.entities.size()) {
+                break;
+            }
+            chunks[getChunkKey(chunk.chunkX, chunk.chunkY)] = CHUNK_STATE::RESIDENT;
+            integrating.pop_front();
+        }
+    }
+
+    void WorldStreamer::integrateEntity(const EntityRecord& record) {
+        unsigned int entityID = map->restoreEntity(record.entityID, record.entityTemplate);
+        Entity* entity = map->getEntityWithID(entityID);
+        if (!entity) {
+            return;
+        }
+        for (const Buff& buff : record.buffs) {
+            entity->addBuff(buff);
+        }
+        if (record.hasShape) {
+            map->setEntityShape(entityID, record.shape);
+        }
+        if (record.hasBehaviour) {
+            std::unique_ptr<BehaviourProfile> profile(BehaviourProfile::create(record.behaviour, entityID, map));
+            BinaryReader reader(record.behaviourState.data(), record.behaviourState.size());
+            if (profile && profile->load(reader)) {
+                map->setBehaviourProfile(entityID, std::move(profile));
+            }
+            else {
+                std::cout << "Could not restore the behaviour of entity " << entityID << std::endl;
+            }
+        }
+    }
+
+    std::vector<unsigned int> WorldStreamer::getEntitiesInChunk(int chunkX, int chunkY) {
+        std::vector<unsigned int> inChunk;
+        for (unsigned int entityID : map->getEntitiesInArea(getChunkRect(chunkX, chunkY))) {
+            if (entityID == map->getPlayerID()) {
+                continue;
+            }
+            Vector center = map->getEntityWithID(entityID)->getHitbox().getCenter();
+            if (toChunk(center.x) == chunkX && toChunk(center.y) == chunkY) {
+                inChunk.push_back(entityID);
+            }
+        }
+        return inChunk;
+    }
+
+    void WorldStreamer::evictChunk(int chunkX, int chunkY) {
+        std::unique_ptr<EvictingChunk> chunk(new EvictingChunk());
+        chunk->chunkX = chunkX;
+        chunk->chunkY = chunkY;
+        chunk->entityIDs = getEntitiesInChunk(chunkX, chunkY);
+        chunk->written = 0;
+        chunk->recordCount = 0;
+        chunks[getChunkKey(chunkX, chunkY)] = CHUNK_STATE::EVICTING;
+        evicting.push_back(std::move(chunk));
+    }
+
+    void WorldStreamer::writeEvictedEntities(unsigned int budget) {
+        while (!evicting.empty() && budget > 0) {
+            EvictingChunk& chunk = *evicting.front();
+            while (chunk.written < chunk.entityIDs.size() && budget > 0) {
+                unsigned int entityID = chunk.entityIDs[chunk.written];
+                Entity* entity = map->getEntityWithID(entityID);
+                if (entity) {
+                    writeEntityRecord(chunk.records, *map, *entity);
+                    map->removeEntity(entityID);
+                    chunk.recordCount++;
+                }
+                chunk.written++;
+                budget--;
+            }
+            if (chunk.written < chunk.entityIDs.size()) {
+                break;
+            }
+            finishEviction(chunk);
+            evicting.pop_front();
+        }
+    }
+
+    void WorldStreamer::finishEviction(EvictingChunk& chunk) {
+        for (unsigned int entityID : getEntitiesInChunk(chunk.chunkX, chunk.chunkY)) {
+            writeEntityRecord(chunk.records, *map, *map->getEntityWithID(entityID));
+            map->removeEntity(entityID);
+            chunk.recordCount++;
+        }
+        BinaryWriter writer;
+        writer.write(static_cast<uint32_t>(CHUNK_MAGIC));
+        writer.write(static_cast<uint16_t>(CHUNK_VERSION));
+        writer.write<uint32_t>(chunk.recordCount);
+        writer.writeBytes(chunk.records.getBuffer().data(), chunk.records.getSize());
+        std::vector<Rect> staticGeometry = map->removeStaticGeometryIn(getChunkRect(chunk.chunkX, chunk.chunkY));
+        writer.write<uint32_t>(staticGeometry.size());
+        for (const Rect& rect : staticGeometry) {
+            writer.writeRect(rect);
+        }
+        std::unique_ptr<ChunkJob> job(new ChunkJob());
+        job->saving = true;
+        job->chunkX = chunk.chunkX;
+        job->chunkY = chunk.chunkY;
+        job->data.swap(writer.getBuffer());
+        queueJob(std::move(job));
+        chunks.erase(getChunkKey(chunk.chunkX, chunk.chunkY));
+        evictions++;
+    }
+
+    void WorldStreamer::evictDistantChunks(const ChunkRange& range) {
+        std::vector<std::pair<int, int64_t>> resident;
+        for (const std::pair<const int64_t, CHUNK_STATE>& chunk : chunks) {
+            if (chunk.second != CHUNK_STATE::RESIDENT) {
+                continue;
+            }
+            int chunkX = static_cast<int>(chunk.first >> 32);
+            int chunkY = static_cast<int32_t>(chunk.first & 0xffffffff);
+            int distanceX = std::max(std::max(range.minX - chunkX, chunkX - range.maxX), 0);
+            int distanceY = std::max(std::max(range.minY - chunkY, chunkY - range.maxY), 0);
+            resident.push_back(std::make_pair(std::max(distanceX, distanceY), chunk.first));
+        }
+        std::sort(resident.begin(), resident.end(), [](const std::pair<int, int64_t>& first, const std::pair<int, int64_t>& second) {
+            return first.first > second.first;
+        });
+        unsigned int residentCount = resident.size();
+        for (const std::pair<int, int64_t>& chunk : resident) {
+            bool outsideMargin = chunk.first > EVICT_MARGIN - LOAD_MARGIN;
+            bool overBudget = residentCount > MAX_RESIDENT_CHUNKS && chunk.first > 0;
+            if (!outsideMargin && !overBudget) {
+                break;
+            }
+            evictChunk(static_cast<int>(chunk.second >> 32), static_cast<int32_t>(chunk.second & 0xffffffff));
+            residentCount--;
+        }
+    }
+
+    void WorldStreamer::update(const Rect& viewBox) {
+        if (!map) {
+            return;
+        }
+        integrateLoadedChunks();
+        writeEvictedEntities(EVICT_BUDGET);
+        ChunkRange loadRange = getChunkRange(viewBox, LOAD_MARGIN);
+        requestChunks(loadRange);
+        evictDistantChunks(loadRange);
+    }
+
+    unsigned int WorldStreamer::getResidentChunkCount() const {
+        unsigned int resident = 0;
+        for (const std::pair<const int64_t, CHUNK_STATE>& chunk : chunks) {
+            if (chunk.second == CHUNK_STATE::RESIDENT) {
+                resident++;
+            }
+        }
+        return resident;
+    }
+
+    unsigned int WorldStreamer::getEvictionCount() const {
+        return evictions;
+    }
+
+}
@@ -0,0 +1,131 @@
+#include "assetPack.hpp"
+#include "textureAtlas.hpp"
+#include "rendering.hpp"
+#include "serialization.hpp"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+
+namespace {
+
+    struct PendingSet {
+        Rendering::AssetEntry::KIND kind;
+        std::string name;
+        std::string state;
+        std::vector<unsigned int> images;
+    };
+
+    bool loadSequence(const std::string& path, std::vector<sf::Image>& images, std::vector<unsigned int>& indices) {
+        for (unsigned int i = 0;; i++) {
+            std::string filePath = path + "/" + std::to_string(i) + ".png";
+            std::ifstream file(filePath);
+            if (!file) {
+                return true;
+            }
+            images.push_back(sf::Image());
+            if (!images.back().loadFromFile(filePath)) {
+                std::cout << "Could not decode " << filePath << "\n";
+                return false;
+            }
+            indices.push_back(images.size() - 1);
+        }
+    }
+
+    unsigned int packEntry(Rendering::AssetPack::Builder& builder, const std::vector<sf::Image>& images, const std::vector<PendingSet>& sets) {
+        Rendering::AtlasPacker packer(Rendering::TextureAtlas::PAGE_SIZE, Rendering::TextureAtlas::PADDING);
+        std::vector<sf::Image> pageImages;
+        Rendering::TextureAtlas::composePages(images, packer, pageImages);
+        std::vector<unsigned int> pageIndices;
+        for (const sf::Image& pageImage : pageImages) {
+            pageIndices.push_back(builder.addPage(pageImage.getSize().x, pageImage.getSize().y, pageImage.getPixelsPtr(), 0));
+        }
+        for (const PendingSet& set : sets) {
+            unsigned int firstFrame = 0;
+            for (unsigned int i = 0; i < set.images.size(); i++) {
+                const Rendering::AtlasPlacement& placement = packer.getPlacement(set.images[i]);
+                unsigned int frame = builder.addFrame(pageIndices[placement.page], placement.x, placement.y, placement.width, placement.height);
+                if (i == 0) {
+                    firstFrame = frame;
+                }
+            }
+            builder.addSet(set.kind, set.name, set.state, firstFrame, set.images.size());
+        }
+        return pageImages.size();
+    }
+
+}
+
+int main(int argc, char * argv[]) {
+    std::string root = argc > 1 ? argv[1] : "resources";
+    std::string output = argc > 2 ? argv[2] : root + "/assets.pack";
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    Rendering::AssetManifest manifest;
+    if (!manifest.loadFromFile(root + "/assets.txt")) {
+        std::cout << "Could not load asset manifest: " << manifest.getLastError() << "\n";
+        return 1;
+    }
+
+    Rendering::AssetPack::Builder builder;
+    unsigned int frameCount = 0;
+    unsigned int pageCount = 0;
+    for (const Rendering::AssetEntry& entry : manifest.getEntries()) {
+        std::string path = root + "/" + entry.path;
+        std::vector<sf::Image> images;
+        std::vector<PendingSet> sets;
+        PendingSet set;
+        set.kind = entry.kind;
+        set.name = entry.name;
+        switch (entry.kind) {
+            case Rendering::AssetEntry::KIND::TEXTURE_SET:
+                for (const std::string& state : Rendering::EntityRenderer::stateTextureNames) {
+                    set.state = state;
+                    set.images.clear();
+                    if (!loadSequence(path + "/" + state, images, set.images)) {
+                        return 1;
+                    }
+                    sets.push_back(set);
+                }
+                break;
+            case Rendering::AssetEntry::KIND::ANIMATION:
+            case Rendering::AssetEntry::KIND::ABSOLUTE_BACKGROUND:
+                if (!loadSequence(path, images, set.images)) {
+                    return 1;
+                }
+                sets.push_back(set);
+                break;
+            case Rendering::AssetEntry::KIND::BACKGROUND: {
+                sf::Image image;
+                if (!image.loadFromFile(path)) {
+                    std::cout << "Could not decode " << path << "\n";
+                    return 1;
+                }
+                unsigned int page = builder.addPage(image.getSize().x, image.getSize().y, image.getPixelsPtr(), Rendering::AssetPack::PAGE_REPEATED);
+                unsigned int frame = builder.addFrame(page, 0, 0, image.getSize().x, image.getSize().y);
+                builder.addSet(entry.kind, entry.name, "", frame, 1);
+                break;
+            }
+            case Rendering::AssetEntry::KIND::FONT: {
+                std::vector<char> data;
+                if (!Game::readFile(path, data)) {
+                    std::cout << "Could not read " << path << "\n";
+                    return 1;
+                }
+                builder.addFont(entry.name, data);
+                break;
+            }
+        }
+        if (!sets.empty()) {
+            pageCount += packEntry(builder, images, sets);
+            frameCount += images.size();
+        }
+    }
+
+    if (!builder.saveToFile(output)) {
+        std::cout << "Could not write " << output << "\n";
+        return 1;
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Packed " << frameCount << " frames onto " << pageCount << " pages into " << output << " in " << elapsed.count() << " ms\n";
+    return 0;
+}